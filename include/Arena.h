@@ -0,0 +1,130 @@
+/**
+ *       @file  Arena.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The per-run arena of the engine objects. All the objects of a run (progress slots, chunk tasks with
+ *		their random substreams and accumulators, result logs) are created in a single cache-line aligned
+ *		block reserved at the setup, and they are destroyed together with the arena, so the cycles of the
+ *		run never allocate and no object has to be deleted by hand
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "ProgressSlot.h"
+
+class Arena {
+
+public:
+
+	Arena() : memory(NULL), size(0), offset(0) {}
+
+	~Arena() {
+		release();
+	}
+
+	/**
+	 * Method used to get the bytes used by n objects of type T in the arena, with the alignment
+	 * @param n	The number of objects
+	 */
+	template <typename T>
+	static size_t footprint(size_t n = 1) {
+		return (n * sizeof(T) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	}
+
+	/**
+	 * Method used to reserve the block of the arena, destroying the objects of the previous run
+	 * @param bytes		The size of the block (the sum of the footprints of the objects to create)
+	 * @param objects	The number of arrays that will be created
+	 */
+	void reserve(size_t bytes, size_t objects) {
+		release();
+		void* block;
+		if (posix_memalign(&block, CACHE_LINE_SIZE, bytes) != 0)
+			throw std::bad_alloc();
+		memory = static_cast<char*>(block);
+		size = bytes;
+		destructors.reserve(objects);
+	}
+
+	/**
+	 * Method used to create an array of objects in the arena, every array starts on a new cache line.
+	 * The arena is bounded: it throws std::bad_alloc if the reserved block is exhausted
+	 * @param n	The number of objects to create
+	 */
+	template <typename T>
+	T* create(size_t n = 1) {
+		if (offset + footprint<T>(n) > size || destructors.size() == destructors.capacity())
+			throw std::bad_alloc();
+
+		T* objects = reinterpret_cast<T*>(memory + offset);
+		for (size_t i = 0; i < n; i++)
+			new (objects + i) T();
+		offset += footprint<T>(n);
+
+		Destructor destructor = { &destroy<T>, objects, n };
+		destructors.push_back(destructor);
+		return objects;
+	}
+
+	/**
+	 * Method used to destroy all the objects, in the reverse order of creation, and to free the block
+	 */
+	void release() {
+		while (!destructors.empty()) {
+			Destructor const & last = destructors.back();
+			last.destroy(last.objects, last.n);
+			destructors.pop_back();
+		}
+		free(memory);
+		memory = NULL;
+		size = 0;
+		offset = 0;
+	}
+
+	/**
+	 * Method used to get the bytes used in the block
+	 */
+	size_t getUsed() const {
+		return offset;
+	}
+
+private:
+
+	char* memory;
+	size_t size;
+	size_t offset;
+
+	/**
+	 * The destructor of an array created in the arena
+	 */
+	struct Destructor {
+		void (*destroy)(void*, size_t);
+		void* objects;
+		size_t n;
+	};
+	std::vector<Destructor> destructors;
+
+	template <typename T>
+	static void destroy(void* objects, size_t n) {
+		for (size_t i = 0; i < n; i++)
+			static_cast<T*>(objects)[i].~T();
+	}
+
+	Arena(Arena const &);
+	Arena& operator=(Arena const &);
+};
+
+#endif // ARENA_H_
@@ -0,0 +1,188 @@
+/**
+ *       @file  BasketEngine.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The multi-asset Heston engine. Every asset has its own spot and variance, and all the 2N drivers are
+ *		correlated by a full correlation matrix. The correlated draws of a block of paths are obtained with a
+ *		single multiplication of the Cholesky factor by the block of independent normals, and the basket,
+ *		best-of and worst-of payoffs are priced on the same paths
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef BASKETENGINE_H_
+#define BASKETENGINE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ChunkTask.h"
+
+/**
+ * An asset of the basket and its Heston model
+ */
+struct BasketAsset {
+	std::string name;
+	double S0;		/**< The spot price */
+	double V0;		/**< The initial volatility */
+	double rho;		/**< The correlation between the spot and the variance of the asset */
+	double kappa;		/**< The mean reversion rate */
+	double theta;		/**< The long-term volatility */
+	double xi;		/**< The volatility of volatility */
+	double dividend;	/**< The dividend yield */
+	double weight;		/**< The weight of the asset in the basket */
+};
+
+/**
+ * The underlying of a basket payoff
+ */
+enum BasketUnderlying {
+	BASKET_SUM,		/**< The weighted sum of the spots */
+	BASKET_BEST,		/**< The best performance (spot over initial spot) of the assets */
+	BASKET_WORST		/**< The worst performance (spot over initial spot) of the assets */
+};
+
+/**
+ * A payoff priced on the paths of the basket, and its price
+ */
+struct BasketPayoff {
+	std::string name;
+	BasketUnderlying underlying;
+	bool call;		/**< True for a call, false for a put */
+	double K;		/**< The strike, a performance for the best-of and the worst-of payoffs */
+	double price;
+	double standardError;
+};
+
+class BasketEngine {
+
+public:
+	/**
+	 * The constructor of the BasketEngine class
+	 *
+	 * @param defaults	The default parameters of the assets, used for the fields missing in the basket file
+	 * @param r		The risk-free rate
+	 * @param T		The maturity time (in years)
+	 * @param todo_simulations	The number of the simulations (antithetic couples)
+	 * @param discretization	The value of discretization of the simulation
+	 */
+	BasketEngine(BasketAsset const & defaults, double r, double T, int todo_simulations, int discretization);
+
+	/**
+	 * Method used to set the seed of the simulation (0 for a random seed)
+	 * @param seed		The seed of the simulation
+	 */
+	void setSeed(uint64_t seed);
+
+	/**
+	 * Method used to set the number of simulations of every chunk
+	 * @param chunkSimulations	The simulations (antithetic couples) of every chunk
+	 */
+	void setChunkSize(int chunkSimulations);
+
+	/**
+	 * Method used to read the basket file. Every line is an asset, a correlation or a payoff:
+	 *	asset NAME S0=100 V0=0.04 rho=-0.7 kappa=2 theta=0.04 xi=0.5 q=0 weight=1
+	 *	corr A B 0.6		(the driver of a spot is the asset name, the one of a variance is NAME.v)
+	 *	payoff NAME TYPE K	(TYPE is basket-call, basket-put, best-of-call, best-of-put, worst-of-call
+	 *				or worst-of-put)
+	 * The missing correlations are zero, the empty lines and the ones starting with '#' are ignored
+	 * @param path		The basket file
+	 */
+	bool load(std::string const & path);
+
+	/**
+	 * Method used to compute the Cholesky factor of the correlation matrix. It fails if the matrix is not
+	 * positive definite
+	 */
+	bool factorize();
+
+	/**
+	 * Method used to price all the payoffs. The chunks are simulated by a pool of threads pinned on the
+	 * assigned CPUs, and their sums are reduced in the chunk order
+	 */
+	void run();
+
+	/**
+	 * Method used to write the prices of the payoffs in CSV
+	 * @param output	The file where the results are written
+	 */
+	void write(FILE* output);
+
+	/**
+	 * The number of paths simulated together by the blocked multiplication
+	 */
+	static const int BLOCK_PATHS = 8;
+
+private:
+
+	double r;
+	double T;
+	int todo_simulations;
+	int discretization;
+	int chunkSimulations;
+	uint64_t seed;
+
+	BasketAsset defaults;
+	std::vector<BasketAsset> assets;
+	std::vector<BasketPayoff> payoffs;
+
+	/**
+	 * The correlation of the 2N drivers (the spot of the asset a is the driver 2a, its variance is 2a+1) and
+	 * its lower triangular Cholesky factor, packed by rows
+	 */
+	std::vector<double> correlation;
+	std::vector<double> cholesky;
+
+	/**
+	 * The results of the chunks: the sum of every payoff, the sum of its squares and the simulations done
+	 */
+	std::vector<std::vector<double> > chunkSums;
+	std::vector<std::vector<double> > chunkSquares;
+	std::vector<int> chunkDone;
+
+	/**
+	 * Method used to get the index of a driver from its name
+	 * @param name		The asset name, or NAME.v for its variance
+	 */
+	int driver(std::string const & name);
+
+	/**
+	 * The thread function of the pool: it simulates the next chunk until all the chunks are taken
+	 * @param cpu		The CPU where the thread is pinned
+	 * @param next		The index of the next chunk to simulate
+	 */
+	void runWorker(int cpu, std::atomic<int>* next);
+
+	/**
+	 * Method used to simulate a chunk of paths, BLOCK_PATHS paths (and their antithetic ones) at a time
+	 * @param task		The chunk to simulate
+	 */
+	void simulateChunk(ChunkTask & task);
+
+	/**
+	 * Method used to compute the correlated draws of a block of paths: correlated = L * independent, where the
+	 * rows of the blocks are the drivers and the columns are the paths
+	 * @param independent	The independent normals, BLOCK_PATHS for every driver
+	 * @param correlated	The correlated normals, BLOCK_PATHS for every driver
+	 */
+	void correlate(const double* independent, double* correlated);
+
+	/**
+	 * Method used to compute the payoff of a terminal state
+	 * @param payoff	The payoff to compute
+	 * @param spots		The terminal spots, with a stride of BLOCK_PATHS between the assets
+	 */
+	double payoffValue(BasketPayoff const & payoff, const double* spots);
+};
+
+#endif // BASKETENGINE_H_
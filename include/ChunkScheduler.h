@@ -0,0 +1,145 @@
+/**
+ *       @file  ChunkScheduler.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The scheduling of the chunks of a run on the persistent workers. The tasks of the chunks are created
+ *		in the arena of the run and reused from a free list, a stopped chunk is queued and resumed by the next
+ *		idle worker, and a run cycle waits at most a slice of time for a completed chunk
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef CHUNKSCHEDULER_H_
+#define CHUNKSCHEDULER_H_
+
+#include <bbque/utils/logging/logger.h>
+
+#include "HestonWorker.h"
+#include "CompletionSignal.h"
+#include "Arena.h"
+
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+class ChunkScheduler {
+
+public:
+
+	/**
+	 * The constructor of the ChunkScheduler class
+	 * @param workers	The workers of the run, created by the owner of the scheduler
+	 */
+	ChunkScheduler(std::vector<std::unique_ptr<HestonWorker> > & workers);
+
+	/**
+	 * Method used to set the logger of the scheduling events (none by default)
+	 * @param logger	The logger
+	 */
+	void setLogger(bbque::utils::Logger* logger);
+
+	/**
+	 * Method used to lay out the chunks of a run and to create their tasks in the arena of the run. The arena
+	 * must have room for Arena::footprint<ChunkTask>(tasksNumber)
+	 * @param arena			The arena of the run
+	 * @param tasksNumber		The number of tasks, at least one for every worker and one for every stopped chunk
+	 * @param simulations		The simulations of the run
+	 * @param chunkSimulations	The simulations of every chunk
+	 * @param seed			The seed of the substreams of the chunks
+	 * @param discretization	The number of time steps of every path
+	 */
+	void setup(Arena & arena, int tasksNumber, int simulations, int chunkSimulations, uint64_t seed,
+		int discretization);
+
+	/**
+	 * Method used to get the signal the workers use to wake up the run cycles when they complete a chunk
+	 */
+	CompletionSignal* getCompletionSignal();
+
+	/**
+	 * Method used to do a run cycle on the first active workers: the completed chunks are collected, the idle
+	 * workers start a chunk and the cycle waits at most sliceMs for a completed chunk. It returns false,
+	 * without starting any chunk, when all the chunks are completed
+	 * @param active	The number of workers of the assignment
+	 * @param sliceMs	The maximum time of the cycle (in milliseconds)
+	 */
+	bool cycle(int active, int sliceMs);
+
+	/**
+	 * Method used to start a chunk on every idle worker of the assignment: the stopped chunks are resumed
+	 * first, then the new ones are started
+	 * @param active	The number of workers of the assignment
+	 */
+	void startChunks(int active);
+
+	/**
+	 * Method used to join a worker and to collect its chunk. It returns true if the chunk is completed
+	 * @param i		The index of the worker
+	 */
+	bool collectWorker(int i);
+
+	/**
+	 * Method used to collect all the workers that have completed their chunk
+	 */
+	void collectCompletedWorkers();
+
+	/**
+	 * Method used to read, without waiting, the progress of the chunks not completed yet (the ones of the
+	 * running workers and the stopped ones)
+	 * @param done		The simulations done in the chunks not completed
+	 * @param sum		The sum of the payoffs of those simulations
+	 */
+	void collectProgress(int & done, double & sum);
+
+	/**
+	 * Method used to get the number of the chunks of the run
+	 */
+	int getChunksNumber();
+
+	/**
+	 * Method used to get the number of the chunks started at least once
+	 */
+	int getStartedChunks();
+
+	/**
+	 * Method used to get the number of the completed chunks
+	 */
+	int getCompletedChunks();
+
+private:
+
+	std::vector<std::unique_ptr<HestonWorker> > & workers;
+	bbque::utils::Logger* logger;
+
+	/**
+	 * The signal used by the workers to wake up the run cycle when they complete a chunk
+	 */
+	CompletionSignal completion;
+
+	/**
+	 * The chunks of the run: every chunk has its own substream (from the seed and its index)
+	 */
+	uint64_t seed;
+	int simulations;
+	int chunkSimulations;
+	int discretization;
+	int chunksNumber;
+	int nextChunk;
+	int completedChunks;
+
+	/**
+	 * The tasks used by the workers (in the arena), and the stopped tasks waiting to be resumed in their order.
+	 * Both the lists are reserved for all the tasks, so they never grow
+	 */
+	ChunkTask* taskPool;
+	std::vector<ChunkTask*> freeTasks;
+	std::vector<ChunkTask*> resumeQueue;
+};
+
+#endif // CHUNKSCHEDULER_H_
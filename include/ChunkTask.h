@@ -0,0 +1,132 @@
+/**
+ *       @file  ChunkTask.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: A chunk of simulations assigned to a worker. Every chunk has its own random substream, seeded from the
+ *		seed of the run and the index of the chunk, and its own pairwise accumulator. The result of a chunk
+ *		does not depend on the worker that computes it, and a stopped chunk keeps its generator and its
+ *		accumulator, so it can be resumed later exactly where it stopped
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef CHUNKTASK_H_
+#define CHUNKTASK_H_
+
+#include <stdint.h>
+#include <random>
+#include <vector>
+
+#include "Reduction.h"
+
+/**
+ * The seed sequence of a chunk: the same words of std::seed_seq (the standard algorithm) for the seed of the
+ * run and the index of the chunk, generated without the heap allocations of std::seed_seq, so a chunk can be
+ * reset in the steady state of the run
+ */
+struct ChunkSeedSequence {
+
+	typedef uint32_t result_type;
+
+	uint32_t values[3];	/**< The low and the high word of the seed, and the index of the chunk */
+
+	/**
+	 * Method used to fill a range with the seed words (std::seed_seq::generate)
+	 * @param begin		The begin of the range
+	 * @param end		The end of the range
+	 */
+	template <typename Iterator>
+	void generate(Iterator begin, Iterator end) {
+		const size_t n = end - begin;
+		const size_t s = 3;
+		if (n == 0)
+			return;
+		for (Iterator i = begin; i != end; ++i)
+			*i = 0x8b8b8b8bu;
+
+		const size_t t = (n >= 623) ? 11 : (n >= 68) ? 7 : (n >= 39) ? 5 : (n >= 7) ? 3 : (n - 1) / 2;
+		const size_t p = (n - t) / 2;
+		const size_t q = p + t;
+		const size_t m = (s + 1 > n) ? s + 1 : n;
+
+		for (size_t k = 0; k < m; k++) {
+			uint32_t r1 = mix(begin[k % n] ^ begin[(k + p) % n] ^ begin[(k + n - 1) % n]) * 1664525u;
+			uint32_t r2 = r1 + (uint32_t) (k % n) + ((k == 0) ? (uint32_t) s : (k <= s) ? values[k - 1] : 0u);
+			begin[(k + p) % n] += r1;
+			begin[(k + q) % n] += r2;
+			begin[k % n] = r2;
+		}
+		for (size_t k = m; k < m + n; k++) {
+			uint32_t r3 = mix(begin[k % n] + begin[(k + p) % n] + begin[(k + n - 1) % n]) * 1566083941u;
+			uint32_t r4 = r3 - (uint32_t) (k % n);
+			begin[(k + p) % n] ^= r3;
+			begin[(k + q) % n] ^= r4;
+			begin[k % n] = r4;
+		}
+	}
+
+private:
+
+	static uint32_t mix(uint32_t x) {
+		return x ^ (x >> 27);
+	}
+};
+
+struct ChunkTask {
+
+	int index;			/**< The index of the chunk, it selects the random substream */
+	int first;			/**< The index of the first simulation of the chunk in the run */
+	int todo;			/**< The simulations of the chunk */
+	int done;			/**< The simulations done so far */
+	std::mt19937 generator;		/**< The random substream of the chunk */
+	PairwiseSum sum;		/**< The sum of the payoffs of the done simulations */
+	PairwiseSum squares;		/**< The sum of the squares of the payoffs, for their variance */
+	std::vector<PairwiseSum> payoffSums;	/**< The sums of the additional payoffs priced on the same paths */
+	std::vector<PairwiseSum> payoffSquares;	/**< The sums of the squares of the additional payoffs */
+
+	/**
+	 * Method used to set the number of the additional payoffs priced on the same paths
+	 * @param payoffs	The number of the additional payoffs
+	 */
+	void setPayoffs(size_t payoffs) {
+		payoffSums.resize(payoffs);
+		payoffSquares.resize(payoffs);
+	}
+
+	/**
+	 * Method used to prepare the task for a new chunk
+	 * @param index		The index of the chunk
+	 * @param first		The index of the first simulation of the chunk in the run
+	 * @param todo		The simulations of the chunk
+	 * @param seed		The seed of the run
+	 */
+	void reset(int index, int first, int todo, uint64_t seed) {
+		this->index = index;
+		this->first = first;
+		this->todo = todo;
+		this->done = 0;
+		ChunkSeedSequence sequence = { { (uint32_t) seed, (uint32_t) (seed >> 32), (uint32_t) index } };
+		generator.seed(sequence);
+		sum.reset();
+		squares.reset();
+		for (size_t i = 0; i < payoffSums.size(); i++) {
+			payoffSums[i].reset();
+			payoffSquares[i].reset();
+		}
+	}
+
+	/**
+	 * Method used to know if all the simulations of the chunk are done
+	 */
+	bool completed() const {
+		return done >= todo;
+	}
+};
+
+#endif // CHUNKTASK_H_
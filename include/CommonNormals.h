@@ -0,0 +1,56 @@
+/**
+ *       @file  CommonNormals.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: A block of normal draws generated once and shared, read-only, by many workers (common random numbers).
+ *		Every path has its own row of normals, in the same order used by the simulation kernels, so all the
+ *		workers reading the block simulate exactly the same random paths under different parameters
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef COMMONNORMALS_H_
+#define COMMONNORMALS_H_
+
+#include <cstddef>
+#include <vector>
+
+struct CommonNormals {
+
+	int paths;				/**< The number of paths (antithetic couples) of the block */
+	int stride;				/**< The normals of every path */
+	std::vector<double> normals;		/**< The block in double precision */
+	std::vector<float> singleNormals;	/**< The block in single precision */
+
+	/**
+	 * Method used to get the normals of a path in the requested precision
+	 * @param i	The index of the path
+	 */
+	template <typename Real>
+	const Real* path(int i) const;
+
+	/**
+	 * Method used to get the size of the block in bytes
+	 */
+	size_t bytes() const {
+		return normals.size() * sizeof(double) + singleNormals.size() * sizeof(float);
+	}
+};
+
+template <>
+inline const double* CommonNormals::path<double>(int i) const {
+	return &normals[(size_t) i * stride];
+}
+
+template <>
+inline const float* CommonNormals::path<float>(int i) const {
+	return &singleNormals[(size_t) i * stride];
+}
+
+#endif // COMMONNORMALS_H_
@@ -0,0 +1,60 @@
+/**
+ *       @file  CompletionSignal.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: A simple signal used by the workers to wake up the EXC control thread when they complete a chunk
+ *		of simulations. In this way onRun() can wait for the first completed worker, with a timeout, instead of
+ *		joining all the workers
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef COMPLETIONSIGNAL_H_
+#define COMPLETIONSIGNAL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+class CompletionSignal {
+
+public:
+
+	CompletionSignal() : pending(0) {}
+
+	/**
+	 * Method used by a worker to signal the completion of its chunk
+	 */
+	void notify() {
+		std::lock_guard<std::mutex> lock(mutex);
+		pending++;
+		condition.notify_one();
+	}
+
+	/**
+	 * Method used to wait for at least one completion. It returns false if the timeout expired without any
+	 * completion
+	 * @param milliseconds	The maximum time to wait
+	 */
+	bool waitFor(int milliseconds) {
+		std::unique_lock<std::mutex> lock(mutex);
+		bool completed = condition.wait_for(lock, std::chrono::milliseconds(milliseconds),
+			[this] { return pending > 0; });
+		pending = 0;
+		return completed;
+	}
+
+private:
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	int pending;
+};
+
+#endif // COMPLETIONSIGNAL_H_
@@ -0,0 +1,155 @@
+/**
+ *       @file  CosPricer.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The Fourier-cosine (COS) pricer of Fang and Oosterlee for the European options of the models of the
+ *		Heston family with constant parameters. The density of the log return at a maturity is expanded in
+ *		a cosine series from the characteristic function of the model, whose coefficients are computed once
+ *		for every maturity and parameter set and kept in a cache. A strike is then priced in O(N) by a
+ *		closed form integral of its payoff against the series, so a whole strike grid costs O(N K)
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef COSPRICER_H_
+#define COSPRICER_H_
+
+#include <vector>
+
+#include "HestonModel.h"
+
+class CosPricer {
+
+public:
+	/**
+	 * The constructor of the CosPricer class
+	 *
+	 * @param V0		The initial volatility of the model
+	 * @param rho		The Correlation Coefficient parameter of Heston model
+	 * @param kappa		The mean reversion rate of the Heston Model
+	 * @param theta		The long-term volatility value
+	 * @param xi		The volatility of volatility (V0)
+	 */
+	CosPricer(double V0, double rho, double kappa, double theta, double xi);
+
+	/**
+	 * Method used to change the Heston parameters of the model, the coefficients already computed for the
+	 * other parameters stay in the cache
+	 * @param V0		The initial volatility of the model
+	 * @param rho		The Correlation Coefficient parameter of Heston model
+	 * @param kappa		The mean reversion rate of the Heston Model
+	 * @param theta		The long-term volatility value
+	 * @param xi		The volatility of volatility (V0)
+	 */
+	void setParameters(double V0, double rho, double kappa, double theta, double xi);
+
+	/**
+	 * Method used to select the model (Heston by default)
+	 * @param model		The model and its parameters
+	 */
+	void setModel(ModelParameters const & model);
+
+	/**
+	 * Method used to set the dividend yield (zero by default)
+	 * @param dividend	The dividend yield
+	 */
+	void setDividendYield(double dividend);
+
+	/**
+	 * Method used to set the minimum number of terms of the cosine series (DEFAULT_TERMS by default). It
+	 * empties the cache
+	 * @param terms		The number of terms, rounded up to a multiple of LANES (at most MAX_TERMS)
+	 */
+	void setTerms(int terms);
+
+	/**
+	 * Method used to compute the price of a European option
+	 * @param S0		The spot price of the option
+	 * @param K		The strike price of the option
+	 * @param r		The risk-free rate of the option
+	 * @param T		The maturity time (in years) of the option
+	 * @param call		True for a call, false for a put
+	 */
+	double price(double S0, double K, double r, double T, bool call);
+
+	/**
+	 * Method used to compute the prices of a grid of strikes of the same maturity
+	 * @param S0		The spot price of the options
+	 * @param r		The risk-free rate of the options
+	 * @param T		The maturity time (in years) of the options
+	 * @param strikes	The strike prices of the options
+	 * @param call		True for calls, false for puts
+	 * @param prices	The prices, resized to the number of strikes
+	 */
+	void price(double S0, double r, double T, std::vector<double> const & strikes, bool call,
+		std::vector<double> & prices);
+
+	/**
+	 * Method used to get the number of maturities and parameter sets in the cache
+	 */
+	int getCacheSize() const;
+
+	/**
+	 * The default and the largest number of terms of the series, the lanes of the series loop, the half
+	 * width of the range of the log return, in units of sqrt(c2 + sqrt(c4)) of its cumulants, and the
+	 * modulus of the characteristic function where the series is truncated
+	 */
+	static const int DEFAULT_TERMS = 256;
+	static const int MAX_TERMS = 8192;
+	static const int LANES = 8;
+	static const double RANGE;
+	static const double TOLERANCE;
+
+private:
+
+	/**
+	 * The coefficients of the series of a maturity and a parameter set, in arrays of the same field
+	 */
+	struct Coefficients {
+		std::vector<double> key;	/**< The rate, the dividend yield, the maturity and the parameters */
+		double a;			/**< The range [a, b] of the log return */
+		double b;
+		std::vector<double> density;	/**< The density coefficients 2/(b-a) Re[phi(u_k) exp(-i u_k a)] */
+		std::vector<double> frequency;	/**< u_k = k pi / (b - a) */
+		std::vector<double> inverseFrequency;	/**< 1 / u_k (0 for k = 0) */
+		std::vector<double> damping;	/**< 1 / (1 + u_k^2) */
+	};
+
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	double dividend;
+	ModelParameters model;
+	int terms;
+
+	/**
+	 * The cache of the coefficients, the oldest entry is replaced when it is full
+	 */
+	std::vector<Coefficients> cache;
+	static const int CACHE_SIZE = 64;
+
+	/**
+	 * Method used to get the coefficients of a maturity for the current parameters, from the cache or
+	 * computed and added to the cache
+	 * @param r		The risk-free rate
+	 * @param T		The maturity time (in years)
+	 */
+	Coefficients const & coefficients(double r, double T);
+
+	/**
+	 * Method used to compute the undiscounted price of a put of unit strike with log-moneyness x = ln(S0/K)
+	 * @param c		The coefficients of the maturity
+	 * @param x		The log-moneyness of the put
+	 */
+	double unitPut(Coefficients const & c, double x) const;
+};
+
+#endif // COSPRICER_H_
@@ -0,0 +1,92 @@
+/**
+ *       @file  CpuTopology.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: This class describes the processors that the BarbequeRTRM assigned to our application. The set of
+ *		CPUs is read from the affinity mask of the process (the RTRM writes it through the cpuset cgroup),
+ *		while the NUMA node and the core of each CPU are read from sysfs. It is used to pin every worker on
+ *		its own CPU and to keep the memory of the worker on the same NUMA node
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef CPUTOPOLOGY_H_
+#define CPUTOPOLOGY_H_
+
+#include <vector>
+
+class CpuTopology {
+
+public:
+	/**
+	 * The constructor of the CpuTopology class, it reads immediately the assigned CPUs
+	 */
+	CpuTopology();
+
+	/**
+	 * Method used to read again the CPUs assigned to the application. It must be called every time the
+	 * BarbequeRTRM reconfigures the application, since the cpuset can be changed.
+	 * The CPUs are sorted by NUMA node and then by core, so that the first CPUs of the list are on the same
+	 * node and on different physical cores
+	 */
+	void update();
+
+	/**
+	 * Method used to get the number of the CPUs assigned to the application
+	 */
+	int getCpusNumber();
+
+	/**
+	 * Method used to get the i-th CPU to use
+	 * @param i	The index of the CPU (it wraps around if it is greater than the number of CPUs)
+	 */
+	int getCpu(int i);
+
+	/**
+	 * Method used to get the NUMA node of a CPU
+	 * @param cpu	The CPU identifier
+	 */
+	int getNode(int cpu);
+
+	/**
+	 * Method used to get the number of NUMA nodes used by the assigned CPUs
+	 */
+	int getNodesNumber();
+
+	/**
+	 * Method used to pin the calling thread on a CPU
+	 * @param cpu	The CPU identifier, a negative value does nothing
+	 */
+	static bool pinCurrentThread(int cpu);
+
+private:
+
+	/**
+	 * The assigned CPUs, sorted by node and core
+	 */
+	std::vector<int> cpus;
+
+	/**
+	 * The NUMA node of every CPU of the system (indexed by the CPU identifier)
+	 */
+	std::vector<int> nodes;
+
+	/**
+	 * The number of NUMA nodes used by the assigned CPUs
+	 */
+	int nodesNumber;
+
+	/**
+	 * Method used to read a sysfs list of CPUs (e.g. "0-3,8,10-11")
+	 * @param path	The path of the file to read
+	 */
+	static std::vector<int> readCpuList(const char* path);
+};
+
+#endif // CPUTOPOLOGY_H_
@@ -35,6 +35,29 @@ public:
      * @param	The current spot price to calculate
      */
     double optionCalculator(double S);
+
+    /**
+     * The European payoff has the Black-Scholes closed form, so the conditional calculator is available
+     */
+    bool hasConditionalCalculator();
+
+    /**
+     * Method used to compute the undiscounted Black-Scholes price given the forward and the total variance
+     * @param forward		The forward price of the terminal spot
+     * @param totalVariance	The total variance of the log of the terminal spot
+     */
+    double conditionalCalculator(double forward, double totalVariance);
+
+    /**
+     * The European payoff is priced by the COS method
+     */
+    bool hasFourierCalculator();
+
+    /**
+     * Method used to compute the price of the option with the COS method
+     * @param pricer		The COS pricer of the model
+     */
+    double fourierCalculator(CosPricer & pricer);
 };
 
 #endif // EUROPEANCALL_H
@@ -0,0 +1,123 @@
+/**
+ *       @file  HestonAnalytic.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The semi-analytic prices of the models of the Heston family with constant parameters. The
+ *		characteristic function of the log spot is in closed form (the formulation of Albrecher et al., which
+ *		is continuous in the complex plane), and the price of a vanilla option is the Gil-Pelaez inversion
+ *		of it, integrated by Gauss-Legendre panels until the integrand vanishes. It is the reference of the
+ *		Monte Carlo engine
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef HESTONANALYTIC_H_
+#define HESTONANALYTIC_H_
+
+#include <complex>
+
+#include "HestonModel.h"
+
+class HestonAnalytic {
+
+public:
+	/**
+	 * The constructor of the HestonAnalytic class
+	 *
+	 * @param S0		The spot price of the option
+	 * @param r		The risk-free rate of the option
+	 * @param T		The maturity time of the option (in years)
+	 * @param V0		The initial volatility of the option
+	 * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+	 * @param kappa		The mean reversion rate of the Heston Model for the considered option
+	 * @param theta		The long-term volatility value
+	 * @param xi		The volatility of volatility (V0)
+	 */
+	HestonAnalytic(double S0, double r, double T, double V0, double rho, double kappa, double theta, double xi);
+
+	/**
+	 * Method used to set the dividend yield (zero by default)
+	 * @param dividend	The dividend yield
+	 */
+	void setDividendYield(double dividend);
+
+	/**
+	 * Method used to select the model (Heston by default)
+	 * @param model		The model and its parameters
+	 */
+	void setModel(ModelParameters const & model);
+
+	/**
+	 * Method used to compute the characteristic function E[exp(i u ln(S_T))] of the log spot at the maturity,
+	 * for a complex argument
+	 * @param u		The argument
+	 */
+	std::complex<double> characteristicFunction(std::complex<double> u) const;
+
+	/**
+	 * Method used to compute the price of a vanilla option
+	 * @param K		The strike price of the option
+	 * @param call		True for a call, false for a put
+	 */
+	double price(double K, bool call) const;
+
+	/**
+	 * Method used to get the maturity of the model
+	 */
+	double getMaturity() const;
+
+	/**
+	 * Method used to get the spot price of the model
+	 */
+	double getSpotPrice() const;
+
+	/**
+	 * Method used to get the forward of the spot at the maturity
+	 */
+	double getForward() const;
+
+	/**
+	 * Method used to get the discount factor at the maturity
+	 */
+	double getDiscount() const;
+
+private:
+
+	double S0;
+	double r;
+	double T;
+	double dividend;
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	ModelParameters model;
+
+	/**
+	 * Method used to compute the logarithm of the characteristic function of a variance factor, without the
+	 * drift of the spot
+	 * @param u		The argument
+	 * @param V0		The initial variance of the factor
+	 * @param rho		The correlation of the factor with its spot driver
+	 * @param kappa		The mean reversion rate of the factor
+	 * @param theta		The long-term variance of the factor
+	 * @param xi		The volatility of the variance of the factor
+	 */
+	std::complex<double> factorExponent(std::complex<double> u, double V0, double rho, double kappa, double theta,
+		double xi) const;
+
+	/**
+	 * The width of a panel of the integration and the largest argument integrated
+	 */
+	static const double PANEL;
+	static const double LIMIT;
+};
+
+#endif // HESTONANALYTIC_H_
@@ -22,11 +22,22 @@
 #include <bbque/bbque_exc.h>
 
 #include "HestonWorker.h"
+#include "CpuTopology.h"
+#include "ChunkScheduler.h"
+#include "Metrics.h"
+#include "ResultAggregator.h"
+#include "Arena.h"
+#include "RunJournal.h"
 
 #include <iostream>
 #include <random>
 #include <time.h>
 #include <math.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdint.h>
 
 using bbque::rtlib::BbqueEXC;
 
@@ -63,9 +74,109 @@ public:
 	 */
 	void setCorrectValue(double correctValue);
 
+	/**
+	 * Method used to enable the conditional Monte Carlo (mixing formula) mode, where the workers simulate
+	 * only the volatility path and price the option analytically conditional on it
+	 *
+	 * @param mixing	True to enable the mixing mode
+	 */
+	void setMixingMode(bool mixing);
+
+	/**
+	 * Method used to simulate the paths in single precision (the payoffs are still accumulated in double)
+	 *
+	 * @param singlePrecision	True to enable the single precision engine
+	 */
+	void setSinglePrecision(bool singlePrecision);
+
+	/**
+	 * Method used to set the seed of the run. Every chunk of simulations has its own substream derived from
+	 * this seed and from its index, so the same seed gives the same price whatever the number of workers.
+	 * A zero seed (the default) is replaced by a random one
+	 *
+	 * @param seed		The seed of the run
+	 */
+	void setSeed(uint64_t seed);
+
+	/**
+	 * Method used to set the number of simulations of a chunk. The chunks are reduced pairwise and they can
+	 * be stopped and resumed, so big chunks cost neither accuracy nor reactivity
+	 *
+	 * @param chunkSimulations	The simulations of every chunk
+	 */
+	void setChunkSize(int chunkSimulations);
+
+	/**
+	 * Method used to export the metrics of the workers (throughput and, if compiled in, the time of every
+	 * phase of the simulation) in a file, updated at every partial result
+	 *
+	 * @param metricsFile	The file to write: JSON if it ends with ".json", Prometheus text otherwise
+	 */
+	void setMetricsFile(std::string const & metricsFile);
+
+	/**
+	 * Method used to write all the simulated paths in a memory-mapped store, to price other payoffs on
+	 * them later. The store is available only with the Euler simulation (not with the mixing mode)
+	 *
+	 * @param pathStoreFile		The file of the store
+	 * @param singlePrecision	True to store the paths as float
+	 */
+	void setPathStore(std::string const & pathStoreFile, bool singlePrecision);
+
+	/**
+	 * Method used to set the time-dependent inputs of the model (yield curve, dividend yield and piecewise
+	 * constant Heston parameters). They replace the constant r, kappa, theta and xi
+	 *
+	 * @param terms		The curves of the model
+	 */
+	void setTerms(HestonTerms const & terms);
+
+	/**
+	 * Method used to select the model simulated by the workers (Heston by default): Bates adds log-normal
+	 * jumps to the spot, double Heston a second variance factor
+	 *
+	 * @param model		The model and its parameters
+	 */
+	void setModel(ModelParameters const & model);
+
+	/**
+	 * Method used to set the time grid of the discretization (uniform by default), for example with the steps
+	 * concentrated towards the expiry
+	 *
+	 * @param grid		The time grid
+	 */
+	void setTimeGrid(TimeGrid const & grid);
+
+	/**
+	 * Method used to extrapolate the price with Richardson: every path is simulated also on the refinement of
+	 * the grid with the same Brownian increments, and its payoff is twice the fine one minus the coarse one.
+	 * The first order bias of the Euler scheme cancels, so a coarse grid gives the accuracy of a much finer one
+	 *
+	 * @param richardson	True to extrapolate the price
+	 */
+	void setRichardson(bool richardson);
+
+	/**
+	 * Method used to record the run in an append-only journal: the inputs, the seed and the chunk layout, every
+	 * reconfiguration, the accumulator of every completed chunk and the final result. Every chunk of the
+	 * journal can be replayed on its own (see --replay)
+	 *
+	 * @param journalFile	The file of the journal
+	 */
+	void setJournal(std::string const & journalFile);
+
+	/**
+	 * Method used to start the first chunk at the setup, before the first configuration of the BarbequeRTRM.
+	 * The chunk runs on one worker while the resources are assigned, then it is pinned like any running chunk
+	 * (its price does not change, every chunk has its own substream)
+	 *
+	 * @param fastStart	True to start the first chunk at the setup
+	 */
+	void setFastStart(bool fastStart);
+
 private:
 
-	HestonWorker** workers;
+	std::vector<std::unique_ptr<HestonWorker> > workers;
 	int workersNumber;
 	int doneSimulations;
 	int todo_simulations;
@@ -73,15 +184,89 @@ private:
 	int cpuNumber;
 	const int WORKERS_SIM = 10000;
 
-	double finalPrice;
-	int pricesToCompute;
-	double* computedPrices;
-	int computedPricesIndex;
+	/**
+	 * The CPUs assigned by the BarbequeRTRM, used to pin the workers
+	 */
+	CpuTopology topology;
+
+	/**
+	 * The per-run arena of the engine objects: the progress slots and the chunk tasks are created in it at the
+	 * setup, so the run cycles never allocate
+	 */
+	Arena arena;
+
+	/**
+	 * The cache-line aligned slots where the workers publish their progress, one for each worker
+	 */
+	ProgressSlot* progressSlots;
+
+	/**
+	 * The maximum time (in milliseconds) of a run cycle: the workers keep running across the cycles, so the
+	 * reconfigurations of the BarbequeRTRM are applied at most after this time
+	 */
+	const int RUN_SLICE_MS = 10;
+
+	/**
+	 * The period (in milliseconds) of the partial result printed by onMonitor() when no chunk is completed
+	 */
+	const int MONITOR_PERIOD_MS = 1000;
+	std::chrono::steady_clock::time_point lastMonitor;
+	int monitoredChunks;
+
+	/**
+	 * The aggregator thread, which consumes the results pushed by the workers and exports the metrics
+	 */
+	std::unique_ptr<ResultAggregator> aggregator;
+	std::string metricsFile;
+
+	/**
+	 * The store of the simulated paths
+	 */
+	PathStore pathStore;
+	std::string pathStoreFile;
+	bool pathStoreSingle;
+	bool storePaths;
+
+	/**
+	 * The curves of the model and the discount factor at the maturity
+	 */
+	HestonTerms terms;
+	double discount;
+
+	/**
+	 * The model simulated by the workers
+	 */
+	ModelParameters modelParameters;
 
 	/**
-	 * Variable used to accumulate the results from each run
+	 * The journal of the run, if requested
+	 */
+	RunJournal journal;
+	std::string journalFile;
+
+	/**
+	 * The minimum size of a chunk
+	 */
+	const int PUBLISH_CHUNK_MIN = HestonWorker::PUBLISH_PERIOD;
+
+	/**
+	 * The chunks of the run: every chunk has its own substream (from the seed and its index) and its own sum.
+	 * The sums are stored by the aggregator, and they are copied here at the end of the run
+	 */
+	uint64_t seed;
+	int chunkSimulations;
+	int chunksNumber;
+	std::vector<double> chunkSums;
+	std::vector<int> chunkDone;
+
+	/**
+	 * The scheduler of the chunks on the workers, with the tasks of the run (in the arena)
+	 */
+	ChunkScheduler scheduler;
+
+	/**
+	 * The last price estimated
 	 */
-	double workersFinalSum;
 	double threadFinalPrice;
 	
 	/**
@@ -106,7 +291,31 @@ private:
 	 */
 	double correctValue;
 	bool correctValueIsKnown;
+
+	/**
+	 * Variable used to enable the conditional Monte Carlo simulation
+	 */
+	bool mixing;
+	bool richardson;
+	TimeGrid timeGrid;
+
+	/**
+	 * Variable used to enable the single precision simulation
+	 */
+	bool singlePrecision;
+
+	/**
+	 * Variable used to start the first chunk at the setup
+	 */
+	bool fastStart;
 	
+	/**
+	 * Method used to create the workers up to the given number. The workers are created when a configuration
+	 * needs them, so a short run on few CPUs does not create one worker for every processor of the machine
+	 * @param number	The number of workers needed
+	 */
+	void createWorkers(int number);
+
 	/**
  	 * Method used to do all the Setup operations
  	 */
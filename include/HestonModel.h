@@ -0,0 +1,113 @@
+/**
+ *       @file  HestonModel.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The models of the Heston family simulated by the workers. A model is described at run time by its
+ *		parameters, and at compile time by a policy (the number of variance factors and the jumps of the
+ *		spot): the path kernels are templates on the policy, so every model gets its own specialized loops
+ *		and the single factor Heston pays nothing for the others
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef HESTONMODEL_H_
+#define HESTONMODEL_H_
+
+#include <cmath>
+#include <string>
+
+/**
+ * The models of the Heston family
+ */
+enum ModelType {
+	MODEL_HESTON,		/**< The single factor Heston model */
+	MODEL_BATES,		/**< Heston with compound Poisson log-normal jumps of the spot (Bates) */
+	MODEL_DOUBLE_HESTON	/**< Two independent variance factors, each one correlated with its own spot driver */
+};
+
+/**
+ * The parameters added by the models to the Heston ones. The first variance factor is always the Heston one
+ * (V0, rho and the curves of kappa, theta and xi)
+ */
+struct ModelParameters {
+	ModelType type;
+	double jumpIntensity;		/**< The expected number of jumps per year (lambda) */
+	double jumpMean;		/**< The mean of the logarithm of a jump */
+	double jumpVolatility;		/**< The standard deviation of the logarithm of a jump */
+	double V0;			/**< The initial variance of the second factor */
+	double rho;			/**< The correlation of the second factor with its spot driver */
+	double kappa;			/**< The mean reversion rate of the second factor */
+	double theta;			/**< The long-term variance of the second factor */
+	double xi;			/**< The volatility of the second factor */
+
+	ModelParameters() : type(MODEL_HESTON), jumpIntensity(0.0), jumpMean(0.0), jumpVolatility(0.0),
+		V0(0.0), rho(0.0), kappa(0.0), theta(0.0), xi(0.0) {}
+
+	/**
+	 * Method used to get the drift correction of the jumps per year, lambda * (E[exp(J)] - 1), which keeps
+	 * the discounted spot a martingale
+	 */
+	double jumpCompensator() const {
+		return jumpIntensity * (exp(jumpMean + 0.5 * jumpVolatility * jumpVolatility) - 1.0);
+	}
+
+	/**
+	 * Method used to read the name of a model ("heston", "bates" or "double-heston"), it returns false if
+	 * the name is unknown
+	 * @param name		The name of the model
+	 * @param type		The model read
+	 */
+	static bool parse(std::string const & name, ModelType & type) {
+		if (name == "heston")
+			type = MODEL_HESTON;
+		else if (name == "bates")
+			type = MODEL_BATES;
+		else if (name == "double-heston")
+			type = MODEL_DOUBLE_HESTON;
+		else
+			return false;
+		return true;
+	}
+
+	/**
+	 * Method used to get the name of a model
+	 * @param type		The model
+	 */
+	static const char* name(ModelType type) {
+		switch (type) {
+		case MODEL_BATES:
+			return "bates";
+		case MODEL_DOUBLE_HESTON:
+			return "double-heston";
+		default:
+			return "heston";
+		}
+	}
+};
+
+/**
+ * The compile time description of a model, used to specialize the path kernels. Every variance factor has a
+ * spot normal and a variance normal per step, in this order, so the normals of a step are FACTORS pairs
+ */
+template <int N, bool J>
+struct ModelPolicy {
+	static const int FACTORS = N;		/**< The number of variance factors */
+	static const bool JUMPS = J;		/**< True if the spot jumps */
+};
+
+typedef ModelPolicy<1, false> HestonPolicy;
+typedef ModelPolicy<1, true> BatesPolicy;
+typedef ModelPolicy<2, false> DoubleHestonPolicy;
+
+/**
+ * The largest number of variance factors of a policy
+ */
+const int MAX_FACTORS = 2;
+
+#endif // HESTONMODEL_H_
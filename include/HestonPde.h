@@ -0,0 +1,252 @@
+/**
+ *       @file  HestonPde.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The finite difference solver of the Heston PDE in the spot and the variance, for the options whose
+ *		payoff depends on the terminal spot, European or American. The grids are non-uniform (dense near the
+ *		strike and near zero variance), the space derivatives are second order central differences, and
+ *		the time is stepped by an ADI scheme (modified Craig-Sneyd or Hundsdorfer-Verwer): the mixed
+ *		derivative is explicit and every direction is implicit, so a step is a set of independent
+ *		tridiagonal solves along the grid lines, shared by a pool of threads
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef HESTONPDE_H_
+#define HESTONPDE_H_
+
+#include <string>
+#include <vector>
+
+#include "Option.h"
+
+/**
+ * The ADI schemes of the solver
+ */
+enum PdeScheme {
+	PDE_CRAIG_SNEYD,		/**< The modified Craig-Sneyd scheme (theta = 1/3) */
+	PDE_HUNDSDORFER_VERWER		/**< The Hundsdorfer-Verwer scheme (theta = 1/2 + sqrt(3)/6) */
+};
+
+class HestonPde {
+
+public:
+	/**
+	 * The constructor of the HestonPde class
+	 *
+	 * @param V0		The initial volatility of the model
+	 * @param rho		The Correlation Coefficient parameter of Heston model
+	 * @param kappa		The mean reversion rate of the Heston Model
+	 * @param theta		The long-term volatility value
+	 * @param xi		The volatility of volatility (V0)
+	 */
+	HestonPde(double V0, double rho, double kappa, double theta, double xi);
+
+	/**
+	 * Method used to set the dividend yield (zero by default)
+	 * @param dividend	The dividend yield
+	 */
+	void setDividendYield(double dividend);
+
+	/**
+	 * Method used to set the size of the grid (DEFAULT_SPOTS, DEFAULT_VARIANCES and DEFAULT_STEPS by default)
+	 * @param spots		The intervals of the spot grid
+	 * @param variances	The intervals of the variance grid
+	 * @param steps		The time steps
+	 */
+	void setGrid(int spots, int variances, int steps);
+
+	/**
+	 * Method used to select the ADI scheme (modified Craig-Sneyd by default)
+	 * @param scheme	The scheme
+	 */
+	void setScheme(PdeScheme scheme);
+
+	/**
+	 * Method used to set the number of threads of the solver (0, the default, for the CPUs of the machine,
+	 * limited so every thread has at least MIN_LINES lines of the grid)
+	 * @param threads	The number of threads
+	 */
+	void setThreads(int threads);
+
+	/**
+	 * Method used to compute the price of an option with the payoff of its optionCalculator() at the maturity,
+	 * for its spot, strike, rate and maturity. An American option is projected on its payoff after every
+	 * time step, on the nodes where the early exercise can be optimal
+	 * @param option	The option to price
+	 * @param american	True for the early exercise
+	 */
+	double price(Option & option, bool american);
+
+	/**
+	 * Method used to read the name of a scheme ("craig-sneyd" or "hundsdorfer-verwer"), it returns false if
+	 * the name is unknown
+	 * @param name		The name of the scheme
+	 * @param scheme	The scheme read
+	 */
+	static bool parse(std::string const & name, PdeScheme & scheme);
+
+	/**
+	 * Method used to get the name of a scheme
+	 * @param scheme	The scheme
+	 */
+	static const char* name(PdeScheme scheme);
+
+	/**
+	 * The default size of the grid, the largest variance of the grid and the fewest lines of a thread
+	 */
+	static const int DEFAULT_SPOTS = 100;
+	static const int DEFAULT_VARIANCES = 50;
+	static const int DEFAULT_STEPS = 50;
+	static const double MAX_VARIANCE;
+	static const int MIN_LINES = 16;
+
+private:
+
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	double dividend;
+	int spots;
+	int variances;
+	int steps;
+	int threads;
+	PdeScheme scheme;
+
+	/**
+	 * The grid: the spots s_i and the variances v_j, the node (i, j) is at i + j * width
+	 */
+	std::vector<double> s;
+	std::vector<double> v;
+	int width;
+
+	/**
+	 * The three point weights of the first derivative of every spot and of every variance, used by the
+	 * mixed derivative
+	 */
+	std::vector<double> spotWeights;
+	std::vector<double> varianceWeights;
+
+	/**
+	 * The tridiagonal operators of the two directions (lower, diagonal and upper coefficient of every
+	 * node), the constant term of the spot direction at the maturity (the Neumann condition at the largest
+	 * spot, it decays with the dividend yield for a European option) and the coefficient rho xi s v of the
+	 * mixed derivative
+	 */
+	std::vector<double> spotOperator[3];
+	std::vector<double> varianceOperator[3];
+	std::vector<double> spotBoundary;
+	std::vector<double> mixed;
+
+	/**
+	 * The factors of the implicit systems I - theta dt A of the two directions: the multiplier of the
+	 * elimination, the inverse of the pivot and the upper coefficient of every node
+	 */
+	std::vector<double> spotFactor[3];
+	std::vector<double> varianceFactor[3];
+
+	/**
+	 * The state of the time stepping: the solution, the stages and the operators applied to them
+	 */
+	std::vector<double> solution;
+	std::vector<double> predictor;
+	std::vector<double> stage;
+	std::vector<double> spotApplied;
+	std::vector<double> varianceApplied;
+	std::vector<double> varianceCorrection;
+	std::vector<double> payoff;
+
+	/**
+	 * The nodes of the spot grid where the early exercise can be optimal after every time step (1 if the
+	 * payoff is above the lower bound of the holding value), only for an American option
+	 */
+	std::vector<unsigned char> exercisable;
+
+	/**
+	 * Method used to find the nodes of the spot grid where the early exercise can be optimal after every
+	 * time step
+	 * @param option	The option to price
+	 * @param r		The risk-free rate
+	 * @param dt		The time step
+	 */
+	void findExercise(Option & option, double r, double dt);
+
+	/**
+	 * Method used to build the non-uniform grids around the strike and the operators for a rate
+	 * @param S0		The spot price
+	 * @param K		The strike price
+	 * @param r		The risk-free rate
+	 * @param dt		The time step
+	 */
+	void build(double S0, double K, double r, double dt);
+
+	/**
+	 * Method used to factor the tridiagonal system I - weight * A along a direction
+	 * @param A		The operator
+	 * @param factor	The factors
+	 * @param stride	The distance of two consecutive nodes of a line
+	 * @param length	The number of nodes of a line
+	 * @param weight	The weight of the operator
+	 */
+	void factor(std::vector<double> const A[3], std::vector<double> factor[3], int stride, int length,
+		double weight);
+
+	/**
+	 * The thread function: it steps the rows and the columns of the grid of the thread, and it meets the
+	 * other threads at every stage
+	 * @param index		The index of the thread
+	 * @param count		The number of threads
+	 * @param cpu		The CPU where the thread is pinned
+	 * @param american	True for the early exercise
+	 * @param dt		The time step
+	 * @param barrier	The barrier of the stages
+	 */
+	void run(int index, int count, int cpu, bool american, double dt, void* barrier);
+
+	/**
+	 * Method used to apply the operators of the two directions and the mixed derivative on a row, to a grid
+	 * or to the difference of two grids
+	 * @param u		The grid
+	 * @param w		The grid subtracted from u (only if DIFFERENCE)
+	 * @param j		The row
+	 * @param spotOut	The spot operator applied to the row (without the constant term)
+	 * @param varianceOut	The variance operator applied to the row
+	 * @param mixedOut	The mixed derivative applied to the row
+	 */
+	template <bool DIFFERENCE>
+	void apply(const double* u, const double* w, int j, double* spotOut, double* varianceOut, double* mixedOut);
+
+	/**
+	 * Method used to solve the spot system of a row in place
+	 * @param x		The grid, the right hand side on input and the solution on output
+	 * @param j		The row
+	 */
+	void solveRow(double* x, int j);
+
+	/**
+	 * Method used to solve the variance systems of a block of columns in place, the columns are eliminated
+	 * together so every step of the elimination runs over contiguous nodes
+	 * @param x		The grid, the right hand side on input and the solution on output
+	 * @param first		The first column
+	 * @param last		The column after the last one
+	 */
+	void solveColumns(double* x, int first, int last);
+
+	/**
+	 * Method used to interpolate the grid in a point, with the quadratic through the three nearest nodes of
+	 * every direction
+	 * @param S		The spot price
+	 * @param V		The variance
+	 */
+	double interpolate(double S, double V) const;
+};
+
+#endif // HESTONPDE_H_
@@ -23,9 +23,25 @@
 #include <time.h>
 #include <math.h>
 #include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Option.h"
 #include "EuropeanCall.h"
+#include "ProgressSlot.h"
+#include "CompletionSignal.h"
+#include "Metrics.h"
+#include "Reduction.h"
+#include "ChunkTask.h"
+#include "CommonNormals.h"
+#include "PathStore.h"
+#include "TermStructure.h"
+#include "TimeGrid.h"
+#include "HestonModel.h"
+#include "ResultRing.h"
 
 using bbque::rtlib::BbqueEXC;
 
@@ -48,88 +64,503 @@ public:
 	HestonWorker(double S0, double K, double r, double T, double V0, double rho, double kappa, double theta, double xi);
 
 	/**
-	 * Distructor of the HestonWorker, used to delete the created option
+	 * Distructor of the HestonWorker, it ends the worker thread
  	 */
 	~HestonWorker();
 
 	/**
-	 * Method used to start a simulation
-	 * @param simulationToDo	The number of the simulations that a single worker has to do
+	 * Method used to start a simulation. The worker thread is created at the first start and then it waits for
+	 * the next chunk, so a started chunk does not allocate
+	 * @param task			The chunk to simulate (a new one, or a stopped one to resume)
 	 * @param discretization	The value of discretization of the simulation
 	 */
-	void start(int simulationToDo, int discretization);
+	void start(ChunkTask* task, int discretization);
 
 	/**
-	 * Method used to stop a worker
+	 * Method used to stop a worker. The worker checks the request before every simulation, then it stops and
+	 * keeps the result of the simulations already done in its chunk (see getTask() after join()).
+	 * It returns the simulations published so far
 	 */
 	int stop();
 
 	/**
-	 * Method used to wait a computation of a worker
+	 * Method used to wait for the end of the chunk of the worker
 	 */
 	void join();
 
+	/**
+	 * Method used to know if the worker thread is still computing its chunk
+	 */
+	bool isRunning();
+
+	/**
+	 * Method used to know if the worker has been started and not joined yet
+	 */
+	bool isStarted();
+
+	/**
+	 * Method used to set the signal notified by the worker when it completes (or stops) its chunk
+	 * @param completion	The signal shared by all the workers
+	 */
+	void setCompletionSignal(CompletionSignal* completion);
+
+	/**
+	 * Method used to select the precision of the simulation. In single precision the paths and the normal draws
+	 * are computed with float values (half the memory and twice the SIMD width), while the payoffs are still
+	 * accumulated in double precision
+	 * @param singlePrecision	True to simulate the paths in single precision
+	 */
+	void setSinglePrecision(bool singlePrecision);
+
+	/**
+	 * Method used to enable the conditional Monte Carlo (mixing formula) simulation. In this mode only the
+	 * volatility path is simulated and the option is priced with its closed form conditional on that path.
+	 * If the option has not a closed form, the full Heston simulation is used
+	 * @param mixing	True to simulate only the volatility path
+	 */
+	void setMixingMode(bool mixing);
+
+	/**
+	 * Method used to simulate the paths with a shared block of normals instead of drawing them (common random
+	 * numbers). The simulation i of a chunk uses the path i of the block, so the chunk must not be longer
+	 * than the block
+	 * @param common	The block of normals, or NULL to draw the normals from the chunk substream
+	 */
+	void setCommonNormals(const CommonNormals* common);
+
+	/**
+	 * Method used to change the option and the constant model of the worker, so a persistent worker can
+	 * simulate the chunks of other contracts. The curves, the dividend yield included, are the constant
+	 * values of the contract (see setTerms()). It must be called only when the worker is not running
+	 * @param S0		The spot price of the option
+	 * @param K		The strike price of the option
+	 * @param r		The risk-free rate of the option
+	 * @param T		The maturity time of the option (in years)
+	 * @param V0		The initial volatility of the option
+	 * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+	 * @param kappa		The mean reversion rate of the Heston Model for the considered option
+	 * @param theta		The long-term volatility value
+	 * @param xi		The volatility of volatility (V0)
+	 */
+	void setContract(double S0, double K, double r, double T, double V0, double rho, double kappa, double theta, double xi);
+
+	/**
+	 * Method used to set the time-dependent inputs of the model: the risk-free rate, the dividend yield and
+	 * the Heston parameters. They replace the constant values of the constructor, and they are integrated
+	 * over the steps of the grid before the first simulation. It must be called only when the worker is not
+	 * running
+	 * @param terms		The curves of the model
+	 */
+	void setTerms(HestonTerms const & terms);
+
+	/**
+	 * Method used to select the model of the simulation (Heston by default). The jumps of a Bates path are
+	 * always drawn from the chunk substream, also with a shared block of normals. It must be called only when
+	 * the worker is not running
+	 * @param model		The model and its parameters
+	 */
+	void setModel(ModelParameters const & model);
+
+	/**
+	 * Method used to set the time grid of the discretization (uniform by default). The grid of a chunk has the
+	 * number of steps given at its start. It must be called only when the worker is not running
+	 * @param grid		The time grid
+	 */
+	void setTimeGrid(TimeGrid const & grid);
+
+	/**
+	 * Method used to simulate every path also on the refinement of its grid, where every step is split in
+	 * two, with the same Brownian increments: the normals are drawn on the fine grid and the normal of a
+	 * coarse step is the normalized sum of the ones of its halves. The payoffs of a path on the two grids are
+	 * accumulated with the given weights: (-1, 2) is the Richardson extrapolation, which cancels the first
+	 * order bias of the Euler scheme, and (-1, 1) is the difference of the grids, an estimate of that bias.
+	 * A zero fine weight simulates only the grid. It must be called only when the worker is not running
+	 * @param coarseWeight	The weight of the payoffs on the grid
+	 * @param fineWeight	The weight of the payoffs on the refined grid
+	 */
+	void setRefinement(double coarseWeight, double fineWeight);
+
+	/**
+	 * Method used to price other options on the same paths of the option of the worker. The payoffs of the
+	 * option k are accumulated in the sum k of the payoffSums (and their squares in the payoffSquares) of the
+	 * chunk, which must have one sum for every option (see ChunkTask::setPayoffs)
+	 * @param payoffs	The additional options, or NULL to price only the option of the worker
+	 */
+	void setPayoffs(std::vector<Option*> const* payoffs);
+
+	/**
+	 * Method used to write the simulated paths in a store. The simulation i of a chunk writes the paths
+	 * 2 * (first + i) and 2 * (first + i) + 1 (the antithetic one), where first is the first simulation of
+	 * the chunk in the run. Only the Euler simulation writes the paths, since the conditional one does not
+	 * simulate the spot price
+	 * @param store		The store, or NULL to not write the paths
+	 */
+	void setPathStore(PathStore* store);
+
+	/**
+	 * Method used to push the result of every completed chunk in a ring, consumed by the aggregator thread.
+	 * A stopped chunk is not pushed: it is pushed by the worker that completes it
+	 * @param results	The ring of this worker, or NULL to not push the results
+	 * @param signal	The signal notified after every push
+	 */
+	void setResultRing(ResultRing* results, CompletionSignal* signal);
+
+	/**
+	 * Method used to draw the block of normals of the paths of a chunk, in the precision and in the order
+	 * used by the simulation of this worker. It must be called only when the worker is not running
+	 * @param task			The chunk that gives the number of paths and the random substream
+	 * @param discretization	The value of discretization of the simulation
+	 * @param block			The block to fill
+	 */
+	void drawCommonNormals(ChunkTask* task, int discretization, CommonNormals& block);
+
+	/**
+	 * Method used to set the CPU where the worker has to run. The worker thread pins itself on the CPU when it
+	 * starts, and it moves its state on the NUMA node of the CPU if the node is changed. A running worker
+	 * pins itself on the new CPU at its next publication of the progress
+	 * @param cpu	The CPU identifier (a negative value means no pinning)
+	 * @param node	The NUMA node of the CPU
+	 */
+	void setCpu(int cpu, int node);
+
+	/**
+	 * Method used to set the slot where the worker publishes its progress while it is running
+	 * @param progress	The cache-line aligned slot of this worker
+	 */
+	void setProgressSlot(ProgressSlot* progress);
+
+	/**
+	 * Method used to read, without waiting, the last progress published by the worker
+	 */
+	WorkerProgress getProgress();
+
+	/**
+	 * Method used to clear the published progress once the result of the worker has been collected.
+	 * It must be called only when the worker is not running
+	 */
+	void clearProgress();
+
 	/**
 	 * Method used to do an Heston Simulation. It is used for the thread function
 	 */
 	void hestonSimulation();
 
 	/**
-	 * Method used to get the calculated value stored in the worker
+	 * Method used to get the chunk of the last simulation: after join() it contains the done simulations and
+	 * their sum
 	 */
-	double getCalculus();
+	ChunkTask* getTask();
 
 	/**
-	 * Method used to get the number of the simulations done by a worker
+	 * Method used to get the number of the simulations done by a worker in its last run
 	 */
 	int getSimulationsDone();
 
+	/**
+	 * Method used to get the metrics of the worker, accumulated over all its chunks.
+	 * It must be called only when the worker is not running
+	 */
+	WorkerMetrics getMetrics();
+
+	/**
+	 * Method used to draw normals in the requested precision, with the same transformation of the
+	 * simulation (the inverse normal tier of the run). It is also used by the engines that draw their own normals
+	 * @param generator	The random generator to use
+	 * @param normals	The buffer to fill
+	 * @param n		The number of normals to draw
+	 */
+	template <typename Real>
+	static void drawNormals(std::mt19937& generator, Real* normals, size_t n);
+
+	/**
+	 * The number of simulations between two publications of the progress
+	 */
+	static const int PUBLISH_PERIOD = 256;
+
+	/**
+	 * The maximum number of grids simulated for every path (the grid and its refinement)
+	 */
+	static const int MAX_LEVELS = 2;
+
+	/**
+	 * The number of paths simulated together by the single precision Euler kernel of the Heston model
+	 */
+	static const int LANES = 8;
+
 private:
 	
-	int todo_simulations;
+	ChunkTask* task;
 	int done_simulations;
 	int discretization;
-	bool hasToWork;
+	std::atomic<bool> hasToWork;
+	std::atomic<bool> running;
+	bool mixing;
+	bool singlePrecision;
 
 	double finalPrice;
+
+	/**
+	 * The CPU and the NUMA node assigned to the worker
+	 */
+	std::atomic<int> cpu;
+	std::atomic<int> node;
+	std::atomic<bool> rebind;
+
+	/**
+	 * The state used by the simulation. It is allocated by the worker thread itself, in this way the
+	 * memory is placed on the NUMA node where the worker runs (first-touch policy). It is cache-line aligned,
+	 * so the state written by a worker never shares a line with the state of another worker
+	 */
+	struct alignas(CACHE_LINE_SIZE) LocalState {
+		/**
+		 * Random Generator
+		 */
+		std::mt19937 generator;
+		/**
+		 * The normal draws of the path being simulated
+		 */
+		std::vector<double> normals;
+		std::vector<float> singleNormals;
+		/**
+		 * The normals of the LANES paths of a block of the single precision kernel, stored by step and by lane
+		 */
+		std::vector<float> laneNormals;
+		/**
+		 * The jumps of the path being simulated and of its antithetic one, followed by the jump sizes
+		 */
+		std::vector<double> jumps;
+		std::vector<float> singleJumps;
+		/**
+		 * The inputs of every variance factor integrated over the steps of the grid and of its refinement
+		 */
+		StepTables<double> tables[MAX_LEVELS][MAX_FACTORS];
+		StepTables<float> singleTables[MAX_LEVELS][MAX_FACTORS];
+		/**
+		 * The instrumentation counters of the worker
+		 */
+		WorkerMetrics metrics;
+	};
+
+	LocalState* local;
+	int localNode;
+
+	/**
+	 * The slot where the progress is published
+	 */
+	ProgressSlot* progress;
+
 	/**
-	 * Variable used to accumulate the results from each run
+	 * The shared block of normals, if the worker does not draw its own ones
 	 */
-	double totalSum;
+	const CommonNormals* common;
+
+	/**
+	 * The store where the paths are written, if any
+	 */
+	PathStore* store;
+
+	/**
+	 * The ring where the results of the completed chunks are pushed, if any, and its signal
+	 */
+	ResultRing* results;
+	CompletionSignal* resultSignal;
+
+	/**
+	 * The additional options priced on the same paths
+	 */
+	std::vector<Option*> const* payoffs;
+
+	/**
+	 * The signal notified at the end of every chunk
+	 */
+	CompletionSignal* completion;
 	/**
 	 *  Variables used to setup the heston simulation
 	 */
 
 	double V0;
 	double rho;
-	double kappa;
-	double theta;
-	double xi;
+
+	/**
+	 * The time-dependent inputs of the model (constant curves by default)
+	 */
+	HestonTerms terms;
+
+	/**
+	 * The model simulated, and the curves of its second variance factor (if any)
+	 */
+	ModelParameters model;
+	HestonTerms secondTerms;
+
+	/**
+	 * The time grid, the number of grids simulated for every path and the weights of their payoffs
+	 */
+	TimeGrid timeGrid;
+	int levels;
+	double weights[MAX_LEVELS];
 
 	/**
 	 * Variable used to setup the option
 	 */
 	
-	Option* option;
+	std::unique_ptr<Option> option;
 	
 	/**
-	 * Random Generator 
+	 * The worker thread, it is kept alive between the chunks. The mutex protects the requests of a new chunk
+	 * and of the exit, and the end of the chunk is signalled on the finished condition
 	 */
-	
-	std::mt19937 generator;	
-	std::thread worker;	
+	std::thread worker;
+	std::mutex control;
+	std::condition_variable wake;
+	std::condition_variable finished;
+	bool pending;
+	bool exiting;
+	bool started;
+
+	/**
+	 * The thread function: it waits for a chunk, it simulates it and then it waits for the next one
+	 */
+	void loop();
+
+	/**
+	 * Method used to simulate the current chunk and then to notify the completion
+	 */
+	void run();
+
+	/**
+	 * Method used by the worker thread to pin itself on the assigned CPU and to move the local state on
+	 * the NUMA node of the CPU
+	 */
+	void bindLocalState();
+
+	/**
+	 * Method used to simulate the current chunk with the kernel of the model
+	 * @param first		The first simulation of the chunk to do
+	 * @param last		The end of the chunk
+	 * @param sum		The accumulator of the chunk
+	 * @param conditional	True to use the conditional Monte Carlo simulation
+	 */
+	template <typename Real>
+	int simulate(int first, int last, PairwiseSum& sum, bool conditional);
+
+	/**
+	 * Method used to do the Euler simulation of the spot price and of the variance factors of a model, with
+	 * the paths in the Real precision and the payoffs accumulated in double precision
+	 * @param first		The first simulation of the chunk to do
+	 * @param last		The end of the chunk
+	 * @param sum		The accumulator of the chunk
+	 */
+	template <typename Real, typename Model>
+	int eulerSimulation(int first, int last, PairwiseSum& sum);
+
+	/**
+	 * Method used to do the single precision Euler simulation of the Heston model LANES paths at a time, with
+	 * the state of the paths stored by lane and the logarithm of the spot, so the steps are vectorized
+	 * @param first		The first simulation of the chunk to do
+	 * @param last		The end of the chunk
+	 * @param sum		The accumulator of the chunk
+	 */
+	int laneSimulation(int first, int last, PairwiseSum& sum);
+
+	/**
+	 * Method used to do a conditional Monte Carlo simulation: only the variance factors (and the jumps) are
+	 * simulated, while the spot is integrated analytically (Willard mixing formula)
+	 * @param first		The first simulation of the chunk to do
+	 * @param last		The end of the chunk
+	 * @param sum		The accumulator of the chunk
+	 */
+	template <typename Real, typename Model>
+	int mixingSimulation(int first, int last, PairwiseSum& sum);
+
+	/**
+	 * Method used to get the buffer for the normal draws of a path in the requested precision
+	 */
+	template <typename Real>
+	std::vector<Real>& normalsBuffer();
+
+	/**
+	 * Method used to get the buffer for the jumps of a path in the requested precision
+	 */
+	template <typename Real>
+	std::vector<Real>& jumpsBuffer();
+
+	/**
+	 * Method used to get the lookup tables of a variance factor in the requested precision, built for the
+	 * current discretization
+	 * @param level		The grid (0 for the grid of the discretization, 1 for its refinement)
+	 * @param factor	The variance factor (0 for the Heston one)
+	 */
+	template <typename Real>
+	StepTables<Real>& stepTables(int level, int factor);
+
+	/**
+	 * Method used to integrate the inputs of a variance factor over the steps of a grid
+	 * @param tables	The tables to build
+	 * @param level		The grid (0 for the grid of the discretization, 1 for its refinement)
+	 * @param factor	The variance factor (0 for the Heston one)
+	 */
+	template <typename Real>
+	void buildTables(StepTables<Real>& tables, int level, int factor);
+
+	/**
+	 * Method used to invalidate the lookup tables, they are built again before the next simulation
+	 * @param firstFactor	The first variance factor to invalidate
+	 */
+	void clearTables(int firstFactor);
+
+	/**
+	 * Method used to compute the normals of the coarse grid from the ones of its refinement
+	 * @param fine		The normals of the refined grid
+	 * @param coarse	The normals of the coarse grid
+	 * @param width		The number of normals of every step
+	 * @param split		The weights of the normals of the two halves of every coarse step
+	 */
+	template <typename Real>
+	void coarsenNormals(const Real* fine, Real* coarse, int width, const Real* split);
+
+	/**
+	 * Method used to draw the jumps of a path and of its antithetic one, summed over every step
+	 * @param generator	The random generator to use
+	 * @param jumps		The buffer of the jumps, resized to 2 * steps plus the number of jumps
+	 * @param steps		The number of steps of the grid
+	 * @param times		The nodes of the grid, or NULL for a uniform grid
+	 */
+	template <typename Real>
+	void drawJumps(std::mt19937& generator, std::vector<Real>& jumps, int steps, const double* times);
+
+	/**
+	 * Method used to draw a uniform number in (0, 1) in the requested precision
+	 * @param generator	The random generator to use
+	 */
+	template <typename Real>
+	static Real uniform(std::mt19937& generator);
+
+	/**
+	 * Method used to add the payoffs of the additional options for the terminal spots of a simulation, weighted
+	 * over the grids
+	 * @param spot		The terminal spot price on every grid
+	 * @param antithetic	The terminal spot price of the antithetic path on every grid
+	 */
+	void addPayoffs(const double* spot, const double* antithetic);
 
 	/**
-	 * Method used to calculate an approximation of the passed value
-	 * @param t		The number to approximate	
+	 * Method used to add the conditional payoffs of the additional options for a simulation, weighted over
+	 * the grids
+	 * @param forward		The forward conditional on the volatility path on every grid
+	 * @param variance		The total variance conditional on the volatility path on every grid
+	 * @param antithetic_forward	The forward conditional on the antithetic volatility path on every grid
+	 * @param antithetic_variance	The total variance conditional on the antithetic volatility path on every grid
 	 */
-	double rationalApproximation(double t);
+	void addConditionalPayoffs(const double* forward, const double* variance, const double* antithetic_forward,
+		const double* antithetic_variance);
 
 	/**
-	 * Method used to calculate the inverse of the standard normal function
-	 * @param p		A value between 0 and 1 (exclused) that represents a value of a standard normal distribution
+	 * Method used by the worker thread to publish its progress. It is also the point where the worker
+	 * moves on a new CPU assigned while it is running
+	 * @param done		The simulations done in the current chunk
+	 * @param sum		The sum of the payoffs of the done simulations
 	 */
-	double normalCDFInverse(double p);
+	void publish(int done, double sum);
 
 	/**
 	 * Method used to get the max given to values
@@ -137,6 +568,7 @@ private:
 	 * @param y	The second parameter to check
 	 */
 	double maxValue(double, double);
+	float maxValue(float, float);
 };
 
 #endif // HESTONWORKER_H_
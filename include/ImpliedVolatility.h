@@ -0,0 +1,115 @@
+/**
+ *       @file  ImpliedVolatility.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The inversion of the Black-Scholes formula. The prices of a batch are inverted together, in arrays of
+ *		structures of the same field: every point is normalized (log-moneyness and out of the money price),
+ *		it starts from a rational initial guess and it is refined by the same fixed number of Householder
+ *		steps, so the loops over the points have no data dependent exit and almost no branch
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef IMPLIEDVOLATILITY_H_
+#define IMPLIEDVOLATILITY_H_
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A batch of prices to invert, one array per field
+ */
+struct VolatilityBatch {
+	std::vector<double> prices;	/**< The undiscounted prices */
+	std::vector<double> forwards;	/**< The forwards of the underlyings at the maturities */
+	std::vector<double> strikes;
+	std::vector<double> maturities;
+	std::vector<int> calls;		/**< 1 for a call, 0 for a put */
+
+	/**
+	 * Method used to add a price to the batch
+	 * @param price		The undiscounted price of the option
+	 * @param forward	The forward of the underlying at the maturity
+	 * @param strike	The strike price of the option
+	 * @param maturity	The maturity time (in years) of the option
+	 * @param call		True for a call, false for a put
+	 */
+	void add(double price, double forward, double strike, double maturity, bool call) {
+		prices.push_back(price);
+		forwards.push_back(forward);
+		strikes.push_back(strike);
+		maturities.push_back(maturity);
+		calls.push_back(call ? 1 : 0);
+	}
+
+	/**
+	 * Method used to get the number of prices in the batch
+	 */
+	size_t size() const {
+		return prices.size();
+	}
+};
+
+class ImpliedVolatility {
+
+public:
+
+	/**
+	 * Method used to compute the undiscounted Black-Scholes price of an option
+	 * @param forward	The forward of the underlying at the maturity
+	 * @param strike	The strike price of the option
+	 * @param volatility	The volatility of the underlying
+	 * @param maturity	The maturity time (in years) of the option
+	 * @param call		True for a call, false for a put
+	 */
+	static double blackPrice(double forward, double strike, double volatility, double maturity, bool call);
+
+	/**
+	 * Method used to invert all the prices of a batch. The volatility of a price outside the no-arbitrage
+	 * bounds (below the intrinsic value or above the forward, or the strike for a put) is NaN
+	 * @param batch		The prices to invert
+	 * @param volatilities	The implied volatilities, resized to the size of the batch
+	 */
+	static void invert(VolatilityBatch const & batch, std::vector<double> & volatilities);
+
+	/**
+	 * Method used to invert a single price
+	 * @param price		The undiscounted price of the option
+	 * @param forward	The forward of the underlying at the maturity
+	 * @param strike	The strike price of the option
+	 * @param maturity	The maturity time (in years) of the option
+	 * @param call		True for a call, false for a put
+	 */
+	static double invert(double price, double forward, double strike, double maturity, bool call);
+
+private:
+
+	/**
+	 * The number of Householder steps done for every point. The initial guess has a relative error of some
+	 * percent, and every step at least triples the correct digits
+	 */
+	static const int STEPS = 4;
+
+	/**
+	 * The number of points of the batch normalized and refined together
+	 */
+	static const int BLOCK = 64;
+
+	/**
+	 * Method used to invert a block of normalized prices: the out of the money calls b(x, s) with x <= 0 (the
+	 * log-moneyness ln(F/K), made negative by the put-call symmetry) and the price divided by sqrt(F*K)
+	 * @param x		The log-moneyness of the points
+	 * @param beta		The normalized prices of the points
+	 * @param s		The total standard deviations sigma*sqrt(T) of the points
+	 * @param n		The number of points (at most BLOCK)
+	 */
+	static void invertNormalized(double const * x, double const * beta, double* s, int n);
+};
+
+#endif // IMPLIEDVOLATILITY_H_
@@ -0,0 +1,169 @@
+/**
+ *       @file  InverseNormal.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The inverse of the standard normal distribution, used to turn the uniform draws in normal ones. The
+ *		accuracy tier is selected once for the whole run, and the uniforms of a path are transformed together
+ *		by a loop specialized for the tier, so the choice costs nothing per draw
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef INVERSENORMAL_H_
+#define INVERSENORMAL_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * The accuracy tiers of the inverse normal
+ */
+enum InverseNormalTier {
+	INVERSE_NORMAL_AS241,		/**< Wichura AS241 (PPND16), full double precision */
+	INVERSE_NORMAL_TABLE,		/**< Table of the octaves of the tail probability with linear interpolation */
+	INVERSE_NORMAL_RATIONAL,	/**< Abramowitz and Stegun 26.2.23, the transformation of the first versions */
+	INVERSE_NORMAL_POLYNOMIAL	/**< Giles polynomial in single precision, vectorized, with AS241 in the tails */
+};
+
+/**
+ * The cost and the accuracy of a tier, measured against AS241
+ */
+struct InverseNormalReport {
+	double nanoseconds;		/**< The time of a double precision draw */
+	double singleNanoseconds;	/**< The time of a single precision draw */
+	double maxError;		/**< The largest absolute error, the deep tails included */
+	double meanBias;		/**< The error of the mean of the normals (0 for the exact distribution) */
+	double varianceBias;		/**< The error of the variance of the normals (1 for the exact distribution) */
+};
+
+class InverseNormal {
+
+public:
+
+	/**
+	 * Method used to select the tier of the whole run. It must be called before the workers are started
+	 * @param tier		The tier to use
+	 */
+	static void setTier(InverseNormalTier tier);
+
+	/**
+	 * Method used to get the tier of the run
+	 */
+	static InverseNormalTier getTier();
+
+	/**
+	 * Method used to read the name of a tier ("as241", "table", "rational" or "polynomial"), it returns false
+	 * if the name is unknown
+	 * @param name		The name of the tier
+	 * @param tier		The tier read
+	 */
+	static bool parse(std::string const & name, InverseNormalTier & tier);
+
+	/**
+	 * Method used to get the name of a tier
+	 * @param tier		The tier
+	 */
+	static const char* name(InverseNormalTier tier);
+
+	/**
+	 * Method used to transform in place a buffer of uniforms in (0, 1) in normals, with the tier of the run
+	 * @param values	The uniforms to transform
+	 * @param n		The number of values
+	 */
+	template <typename Real>
+	static void transform(Real* values, size_t n);
+
+	/**
+	 * Method used to transform in place a buffer of uniforms in (0, 1) in normals, with a given tier
+	 * @param tier		The tier to use
+	 * @param values	The uniforms to transform
+	 * @param n		The number of values
+	 */
+	template <typename Real>
+	static void transform(InverseNormalTier tier, Real* values, size_t n);
+
+	/**
+	 * Method used to compute the inverse normal of a probability with AS241. It is -inf in 0, +inf in 1 and
+	 * NaN outside [0, 1]
+	 * @param p		The probability
+	 */
+	static double as241(double p);
+
+	/**
+	 * Method used to measure the cost and the accuracy of a tier
+	 * @param tier		The tier to measure
+	 */
+	static InverseNormalReport measure(InverseNormalTier tier);
+
+	/**
+	 * Method used to compare the table embedded in the program with the one built by AS241, it returns the
+	 * largest absolute difference of their nodes (0 unless the embedded table is out of date)
+	 */
+	static double checkTable();
+
+private:
+
+	static InverseNormalTier tier;
+
+	/**
+	 * The octaves of the tail probability in the table, and the cells of every octave: the probabilities
+	 * below 2^-OCTAVES (never drawn by a 32 bits generator) are clamped
+	 */
+	static const int OCTAVES = 40;
+	static const int CELLS = 64;
+
+	/**
+	 * The table of the inverse normal on the nodes 2^-(o+1) * (1 + c / CELLS), computed with AS241 and
+	 * embedded in the program (InverseNormalTable.cc), so the first draw of a run does not build it
+	 */
+	static const double TABLE[OCTAVES * (CELLS + 1)];
+
+	/**
+	 * Method used to build the table of the inverse normal with AS241, it is the source of the embedded table
+	 */
+	static std::vector<double> buildTable();
+
+	/**
+	 * Method used to compute the inverse normal with the table
+	 * @param nodes		The table
+	 * @param p		The probability
+	 */
+	static double interpolate(const double* nodes, double p);
+
+	/**
+	 * Method used to compute the inverse normal with the Abramowitz and Stegun rational approximation
+	 * @param p		The probability
+	 */
+	static double rational(double p);
+	static float rational(float p);
+
+	/**
+	 * The probabilities transformed together by the polynomial tier
+	 */
+	static const int BLOCK = 64;
+
+	/**
+	 * Method used to compute the inverse normal of a block of BLOCK probabilities in place with the polynomial
+	 * of Giles in single precision, and with AS241 in the tails
+	 * @param values	The probabilities to transform
+	 */
+	template <typename Real>
+	static void polynomialBlock(Real* values);
+
+	/**
+	 * Method used to compute the inverse normal of a buffer of probabilities in place with the polynomial tier
+	 * @param values	The probabilities to transform
+	 * @param n		The number of values
+	 */
+	template <typename Real>
+	static void polynomial(Real* values, size_t n);
+};
+
+#endif // INVERSENORMAL_H_
@@ -0,0 +1,238 @@
+/**
+ *       @file  JobRunner.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The runner of a batch of pricing jobs read from a job file. The jobs with the same model, maturity and
+ *		simulation grid are grouped and priced together on the same paths, the chunks of all the groups are
+ *		simulated concurrently by a pool of workers pinned on the assigned CPUs, and the prices of a group
+ *		are written as soon as all its chunks are done
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef JOBRUNNER_H_
+#define JOBRUNNER_H_
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Option.h"
+#include "HestonModel.h"
+#include "CosPricer.h"
+#include "TimeGrid.h"
+
+/**
+ * A pricing job: a contract and the parameters of its model
+ */
+struct Job {
+	std::string id;
+	std::string type;	/**< "call" or "put" */
+	double S0;
+	double K;
+	double r;
+	double T;
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	int simulations;	/**< The number of simulations (antithetic couples) */
+	int discretization;
+};
+
+class JobRunner {
+
+public:
+	/**
+	 * The constructor of the JobRunner class, the parameters are the defaults of the fields missing in the
+	 * job file
+	 *
+	 * @param defaults	The default job
+	 * @param chunkSimulations	The simulations of every chunk
+	 */
+	JobRunner(Job const & defaults, int chunkSimulations);
+
+	/**
+	 * Distructor of the JobRunner, used to delete the options of the groups
+	 */
+	~JobRunner();
+
+	/**
+	 * Method used to enable the conditional Monte Carlo (mixing formula) simulation of the jobs
+	 * @param mixing	True to simulate only the volatility path
+	 */
+	void setMixingMode(bool mixing);
+
+	/**
+	 * Method used to simulate the jobs in single precision
+	 * @param singlePrecision	True to simulate the paths in single precision
+	 */
+	void setSinglePrecision(bool singlePrecision);
+
+	/**
+	 * Method used to set the seed of the simulation (0 for a random seed)
+	 * @param seed		The seed of the simulation
+	 */
+	void setSeed(uint64_t seed);
+
+	/**
+	 * Method used to price the groups of European jobs with the COS method instead of the simulation
+	 * (enabled by default)
+	 * @param fourier	True to price the European jobs with the COS method
+	 */
+	void setFourier(bool fourier);
+
+	/**
+	 * Method used to select the model of all the jobs (Heston by default)
+	 * @param model		The model and its parameters
+	 */
+	void setModel(ModelParameters const & model);
+
+	/**
+	 * Method used to set the time grid of the simulated jobs (uniform by default)
+	 * @param grid		The time grid
+	 */
+	void setTimeGrid(TimeGrid const & grid);
+
+	/**
+	 * Method used to extrapolate the prices of the simulated jobs with Richardson, over their grid and its
+	 * refinement driven by the same Brownian increments
+	 * @param richardson	True to extrapolate the prices
+	 */
+	void setRichardson(bool richardson);
+
+	/**
+	 * Method used to choose the steps of every simulated group from a target on the discretization bias, instead
+	 * of the discr field of its jobs. The steps are the ones of the job of the group with the largest bias
+	 * @param bias		The target on the bias of the prices (0 to use the discr field)
+	 */
+	void setBiasTarget(double bias);
+
+	/**
+	 * Method used to read the job file. A line starting with '{' is a JSON object with the fields of a job
+	 * (for example {"id": "c1", "type": "put", "K": 90}), otherwise the file is CSV and its first line
+	 * names the columns. The fields are id, type, S0, K, r, T, V0, rho, kappa, theta, xi, sims and discr,
+	 * the missing ones take the default values
+	 * @param path		The job file
+	 */
+	bool load(std::string const & path);
+
+	/**
+	 * Method used to add a job, it returns false if the job is not valid
+	 * @param job		The job to add
+	 */
+	bool add(Job const & job);
+
+	/**
+	 * Method used to price all the jobs. The results are written in CSV, one line per job, as soon as the
+	 * group of the job is completed
+	 * @param output	The file where the results are written (NULL to only keep the prices)
+	 */
+	void run(FILE* output);
+
+	/**
+	 * Method used to get the number of jobs read
+	 */
+	int getJobsNumber();
+
+	/**
+	 * Method used to get the number of groups of jobs priced on the same paths
+	 */
+	int getGroupsNumber();
+
+	/**
+	 * Method used to get the price of a job, after the run
+	 * @param index		The index of the job, in the order of the file or of the additions
+	 */
+	double getPrice(int index);
+
+	/**
+	 * Method used to get the standard error of the price of a job, after the run
+	 * @param index		The index of the job, in the order of the file or of the additions
+	 */
+	double getStandardError(int index);
+
+private:
+
+	/**
+	 * The jobs priced on the same paths, with the sums of their payoffs (and of their squares) in every chunk
+	 */
+	struct JobGroup {
+		Job model;
+		std::vector<int> jobs;
+		std::vector<Option*> options;
+		int chunksNumber;
+		int completedChunks;
+		std::vector<std::vector<double> > chunkSums;
+		std::vector<std::vector<double> > chunkSquares;
+	};
+
+	Job defaults;
+	int chunkSimulations;
+	bool mixing;
+	bool singlePrecision;
+	uint64_t seed;
+	bool fourier;
+	ModelParameters modelParameters;
+	TimeGrid timeGrid;
+	bool richardson;
+	double biasTarget;
+
+	std::vector<Job> jobs;
+	std::vector<JobGroup> groups;
+	std::vector<double> prices;
+	std::vector<double> standardErrors;
+
+	/**
+	 * Method used to set a field of a job from its text value
+	 * @param job		The job to set
+	 * @param field		The name of the field
+	 * @param value		The value of the field
+	 */
+	static bool setField(Job & job, std::string const & field, std::string const & value);
+
+	/**
+	 * Method used to read a JSON object of a job (a flat object of strings and numbers)
+	 * @param job		The job to set
+	 * @param line		The line with the object
+	 */
+	static bool parseJson(Job & job, std::string const & line);
+
+	/**
+	 * Method used to add a job in its group, or in a new group if no group is compatible
+	 * @param index		The index of the job
+	 */
+	void group(int index);
+
+	/**
+	 * Method used to write the results of all the jobs of a completed group
+	 * @param group		The completed group
+	 * @param output	The file where the results are written
+	 */
+	void writeGroup(JobGroup const & group, FILE* output);
+
+	/**
+	 * Method used to price a group with the COS method and to write its results. It returns false, without
+	 * pricing the group, if some of its options has not a Fourier price
+	 * @param group		The group to price
+	 * @param pricer	The COS pricer, it keeps the coefficients of the maturities of the groups
+	 * @param output	The file where the results are written
+	 */
+	bool priceFourier(JobGroup const & group, CosPricer & pricer, FILE* output);
+
+	/**
+	 * Method used to choose the steps of a group from the bias target, with a pilot on the options of the group
+	 * @param group		The group to plan
+	 */
+	void plan(JobGroup & group);
+};
+
+#endif // JOBRUNNER_H_
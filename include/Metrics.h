@@ -0,0 +1,169 @@
+/**
+ *       @file  Metrics.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The instrumentation of the simulation. Every worker counts the done paths and its busy time, and, if the
+ *		application is built with CONFIG_CONTRIB_HESTONFIVE_METRICS, it measures with the timestamp counter the
+ *		time spent in each phase of a path: random number generation, Heston step kernel, payoff and reduction.
+ *		The phase timers and the trace markers are compiled out otherwise, so they cost nothing.
+ *		The collected metrics are exported in the Prometheus text format or in JSON
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+/**
+ * The phases of the simulation of a path
+ */
+enum MetricsPhase {
+	PHASE_RNG = 0,		/**< Uniform draws and inverse normal */
+	PHASE_KERNEL,		/**< Heston discretization steps */
+	PHASE_PAYOFF,		/**< Option payoff */
+	PHASE_REDUCTION,	/**< Accumulation and publication of the results */
+	PHASES_NUMBER
+};
+
+/**
+ * The metrics of a worker, accumulated over all its chunks
+ */
+struct WorkerMetrics {
+	uint64_t phaseTicks[PHASES_NUMBER];	/**< Timestamp ticks spent in each phase */
+	uint64_t paths;				/**< Simulated paths (an antithetic couple is one path) */
+	uint64_t chunks;			/**< Completed or stopped chunks */
+	double busySeconds;			/**< Wall time spent computing the chunks */
+};
+
+/**
+ * Method used to read the timestamp counter (or a monotonic clock in nanoseconds where it is not available)
+ */
+inline uint64_t readTimestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+#ifdef HESTONFIVE_METRICS
+
+/**
+ * Start a phase timer
+ */
+#define METRICS_TIMER_START(timer) uint64_t timer = readTimestamp()
+
+/**
+ * Close the current phase of the timer, account it and start the next one
+ */
+#define METRICS_TIMER_LAP(timer, metrics, phase) do {				\
+		uint64_t lap = readTimestamp();					\
+		(metrics).phaseTicks[phase] += lap - timer;			\
+		timer = lap;							\
+	} while (0)
+
+/**
+ * Emit a trace marker (visible in ftrace, trace-cmd and perf traces)
+ */
+#define METRICS_TRACE(...) TraceMarker::mark(__VA_ARGS__)
+
+#else
+
+#define METRICS_TIMER_START(timer) do {} while (0)
+#define METRICS_TIMER_LAP(timer, metrics, phase) do { (void) (metrics); } while (0)
+#define METRICS_TRACE(...) do {} while (0)
+
+#endif // HESTONFIVE_METRICS
+
+class TraceMarker {
+
+public:
+	/**
+	 * Method used to open the ftrace marker file. The markers are written only after this call
+	 */
+	static bool enable();
+
+	/**
+	 * Method used to write a marker, in the printf format
+	 * @param format	The format of the marker
+	 */
+	static void mark(const char* format, ...);
+
+private:
+	static int fd;
+};
+
+class AllocationCounter {
+
+public:
+	/**
+	 * Method used to get the number of heap allocations done so far by all the threads. The allocations are
+	 * counted only with the metrics compiled in (the global operator new is replaced), otherwise it is 0
+	 */
+	static uint64_t count();
+
+	/**
+	 * Method used to know if the allocations are counted
+	 */
+	static bool enabled();
+};
+
+class MetricsExporter {
+
+public:
+	/**
+	 * The constructor of the exporter. The format is JSON if the file name ends with ".json", otherwise
+	 * it is the Prometheus text format
+	 * @param path		The file where the metrics are written
+	 */
+	MetricsExporter(std::string const & path);
+
+	/**
+	 * Method used to write (overwriting the previous content) the current metrics
+	 * @param workers	The metrics of every worker
+	 * @param simulations	The simulations done
+	 * @param price		The current price
+	 * @param elapsed	The seconds elapsed since the setup of the application
+	 */
+	bool write(std::vector<WorkerMetrics> const & workers, int simulations, double price, double elapsed);
+
+	/**
+	 * Method used to know if the phase timers are compiled in
+	 */
+	static bool phasesEnabled();
+
+	/**
+	 * Method used to get the frequency of the timestamp counter, calibrated on the first call
+	 */
+	static double ticksPerSecond();
+
+private:
+	std::string path;
+	bool json;
+
+	void writePrometheus(FILE* file, std::vector<WorkerMetrics> const & workers, int simulations,
+		double price, double elapsed);
+	void writeJson(FILE* file, std::vector<WorkerMetrics> const & workers, int simulations,
+		double price, double elapsed);
+};
+
+#endif // METRICS_H_
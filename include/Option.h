@@ -17,6 +17,7 @@
 #ifndef OPTION_H
 #define OPTION_H
 
+class CosPricer;
 
 class Option
 {
@@ -58,7 +59,40 @@ class Option
 	 */  
       	virtual double optionCalculator(double) =0;
 
+	/**
+	 * Method used to know if the option payoff has a closed form expectation under a lognormal spot
+	 * (used by the conditional Monte Carlo simulation). By default an option has not a closed form
+	 */
+	virtual bool hasConditionalCalculator();
+
+	/**
+	 * Method used to compute the expected (undiscounted) payoff when the terminal spot price is lognormal.
+	 * It must be implemented by the options which have a closed form (see hasConditionalCalculator())
+	 * @param forward		The forward price of the terminal spot
+	 * @param totalVariance		The total variance of the log of the terminal spot
+	 */
+	virtual double conditionalCalculator(double forward, double totalVariance);
+
+	/**
+	 * Method used to know if the option can be priced by the COS method, so that it does not need a
+	 * simulation when the model has constant parameters. By default an option is priced by simulation
+	 */
+	virtual bool hasFourierCalculator();
+
+	/**
+	 * Method used to compute the price of the option with the COS method. It must be implemented by the
+	 * options which can be priced by the COS method (see hasFourierCalculator())
+	 * @param pricer		The COS pricer of the model
+	 */
+	virtual double fourierCalculator(CosPricer & pricer);
+
     protected:
+	/**
+	 * Method used to compute the cumulative distribution function of a standard normal
+	 * @param x	The value where the function is evaluated
+	 */
+	static double normalCDF(double x);
+
         double S0;      /**< Represent the initial Spot Price */
         double K;       /**< Represent the Strike Price of the Option */
         double r;       /**< Represent the Risk Free Rate of the Option */
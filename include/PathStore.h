@@ -0,0 +1,162 @@
+/**
+ *       @file  PathStore.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: A memory-mapped file where the simulated paths are stored, to price new payoffs on the same paths
+ *		without simulating them again. The file has a header with the parameters of the model, then one column
+ *		per time step for the spot prices and one for the volatilities, in float or in double. The workers
+ *		write the paths directly in the mapped file while they simulate, and a reader maps it read-only and
+ *		uses the columns without any copy
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef PATHSTORE_H_
+#define PATHSTORE_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+
+#include "Option.h"
+
+/**
+ * The header of the file, the columns start at the next page
+ */
+struct PathStoreHeader {
+	char magic[8];		/**< "HFPATHS" */
+	uint32_t version;	/**< The version of the layout */
+	uint32_t valueSize;	/**< The size of a value: 4 (float) or 8 (double) */
+	uint64_t paths;		/**< The number of stored paths (an antithetic couple is two paths) */
+	uint32_t steps;		/**< The number of time steps */
+	uint32_t completed;	/**< 1 if all the paths have been written */
+	double S0;
+	double r;
+	double T;
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	double discount;	/**< The discount factor to the maturity, from the rate curve */
+	double forward;		/**< The forward of the spot at the maturity, from the rate and the dividend curves */
+};
+
+class PathStore {
+
+public:
+
+	PathStore();
+
+	/**
+	 * Distructor of the PathStore, it unmaps the file
+	 */
+	~PathStore();
+
+	/**
+	 * Method used to create a new store, sized for all the paths of a run
+	 * @param path			The file to create (it is overwritten)
+	 * @param paths			The number of paths to store
+	 * @param steps			The number of time steps of every path
+	 * @param singlePrecision	True to store the values as float
+	 * @param model			The header with the parameters of the model
+	 */
+	bool create(std::string const & path, uint64_t paths, int steps, bool singlePrecision,
+		PathStoreHeader const & model);
+
+	/**
+	 * Method used to open an existing store, read-only
+	 * @param path		The file to open
+	 */
+	bool open(std::string const & path);
+
+	/**
+	 * Method used to mark that all the paths have been written
+	 */
+	void markCompleted();
+
+	/**
+	 * Method used to flush the store and to unmap it
+	 */
+	void close();
+
+	/**
+	 * Method used to write the state of a path after a time step. It is called by the workers while they
+	 * simulate: every path is written by only one worker, so no synchronization is needed
+	 * @param step		The time step (0 is the state after the first step)
+	 * @param path		The index of the path
+	 * @param spot		The spot price
+	 * @param volatility	The volatility
+	 */
+	template <typename Real>
+	void record(int step, uint64_t path, Real spot, Real volatility) {
+		if (header->valueSize == sizeof(float)) {
+			float* column = (float*) (data + (uint64_t) step * columnPairBytes);
+			column[path] = (float) spot;
+			column[header->paths + path] = (float) volatility;
+		} else {
+			double* column = (double*) (data + (uint64_t) step * columnPairBytes);
+			column[path] = (double) spot;
+			column[header->paths + path] = (double) volatility;
+		}
+	}
+
+	/**
+	 * Method used to get the header of the store
+	 */
+	PathStoreHeader const & getHeader();
+
+	/**
+	 * Method used to get the column of the spot prices after a time step, without copying it
+	 * @param step		The time step (0 is the state after the first step)
+	 */
+	template <typename Real>
+	const Real* spotColumn(int step) {
+		return (const Real*) (data + (uint64_t) step * columnPairBytes);
+	}
+
+	/**
+	 * Method used to get the column of the volatilities after a time step, without copying it
+	 * @param step		The time step (0 is the state after the first step)
+	 */
+	template <typename Real>
+	const Real* volatilityColumn(int step) {
+		return spotColumn<Real>(step) + header->paths;
+	}
+
+	/**
+	 * Method used to sum the payoffs of an option over the terminal spot prices of all the stored paths
+	 * @param option	The option to price
+	 */
+	double payoffSum(Option* option);
+
+private:
+
+	PathStoreHeader* header;
+	char* data;
+	size_t mappedBytes;
+	uint64_t columnPairBytes;
+	bool writable;
+
+	/**
+	 * Method used to map the file and to set the column pointers
+	 * @param fd		The descriptor of the file
+	 * @param bytes		The size of the file
+	 */
+	bool map(int fd, size_t bytes);
+
+	/**
+	 * Method used to sum the payoffs of an option over a terminal column of values in the Real precision
+	 * @param option	The option to price
+	 */
+	template <typename Real>
+	double terminalPayoffSum(Option* option);
+};
+
+#endif // PATHSTORE_H_
@@ -0,0 +1,227 @@
+/**
+ *       @file  PricingService.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The asynchronous pricing API. A contract is submitted to the service and the caller gets immediately
+ *		a handle: a future of the final price, the last estimate with its confidence interval, a progress
+ *		callback called at every completed chunk and the cancellation. The chunks of all the submitted
+ *		contracts are simulated by the persistent pool of workers of the service, and a contract is completed
+ *		early as soon as the confidence interval of its price is within the requested tolerance
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef PRICINGSERVICE_H_
+#define PRICINGSERVICE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "JobRunner.h"
+#include "CompletionSignal.h"
+#include "CpuTopology.h"
+#include "HestonModel.h"
+#include "TermStructure.h"
+#include "TimeGrid.h"
+
+class HestonWorker;
+struct ChunkTask;
+
+/**
+ * The running estimate of a price
+ */
+struct PricingProgress {
+	double price;		/**< The discounted price estimated so far */
+	double halfWidth;	/**< The half width of the 95% confidence interval (0 with less than two couples) */
+	int simulations;	/**< The simulations of the estimate */
+	int chunks;		/**< The completed chunks of the estimate */
+};
+
+/**
+ * How a pricing ended
+ */
+enum PricingStatus {
+	PRICING_COMPLETED,	/**< All the simulations have been done */
+	PRICING_CONVERGED,	/**< The confidence interval reached the tolerance */
+	PRICING_CANCELLED	/**< The pricing has been cancelled, the estimate is partial */
+};
+
+/**
+ * The final result of a pricing
+ */
+struct PricingResult {
+	PricingProgress estimate;
+	PricingStatus status;
+};
+
+/**
+ * A contract to price and the options of its simulation
+ */
+struct PricingRequest {
+	Job contract;			/**< The contract and its model */
+	double tolerance;		/**< The half width of the confidence interval to reach (0 to do all the simulations) */
+	int chunkSimulations;		/**< The simulations of every chunk, the progress is reported at every chunk */
+	uint64_t seed;			/**< The seed of the simulation */
+	bool mixing;			/**< True to use the conditional Monte Carlo simulation */
+	bool singlePrecision;		/**< True to simulate the paths in single precision */
+	ModelParameters model;		/**< The model simulated (Heston by default) */
+	TimeGrid timeGrid;		/**< The time grid of the discretization (uniform by default) */
+	bool richardson;		/**< True to price the Richardson extrapolation of the grid and of its refinement */
+	bool curves;			/**< True to simulate the curves of terms instead of the constant values of the contract */
+	HestonTerms terms;		/**< The curves of the rate, of the dividend yield and of the Heston parameters */
+	std::function<void(PricingProgress const &)> progress;	/**< Called at every completed chunk (optional) */
+
+	PricingRequest() : tolerance(0.0), chunkSimulations(0), seed(0), mixing(false), singlePrecision(false),
+		richardson(false), curves(false) {}
+};
+
+class PricingHandle {
+
+public:
+	/**
+	 * Method used to get the future of the final result
+	 */
+	std::shared_future<PricingResult> getResult();
+
+	/**
+	 * Method used to get the last estimate, without waiting
+	 */
+	PricingProgress getProgress();
+
+	/**
+	 * Method used to cancel the pricing. The running chunks are stopped and the future gets the partial
+	 * estimate of the completed chunks
+	 */
+	void cancel();
+
+	/**
+	 * Distructor of the PricingHandle, used to delete the option of the contract
+	 */
+	~PricingHandle();
+
+private:
+
+	friend class PricingService;
+
+	PricingRequest request;
+	std::vector<Option*> options;
+	double discount;
+	std::promise<PricingResult> promise;
+	std::shared_future<PricingResult> result;
+	std::atomic<bool> cancelled;
+
+	std::mutex mutex;
+	PricingProgress progress;
+
+	/**
+	 * The chunks of the contract, used only by the dispatcher thread of the service
+	 */
+	int chunksNumber;
+	int nextChunk;
+	int completedChunks;
+	int runningChunks;
+	bool stopping;
+	PricingStatus status;
+	std::vector<double> chunkSums;
+	std::vector<double> chunkSquares;
+	std::vector<int> chunkDone;
+
+	/**
+	 * The constructor of the PricingHandle class, used only by the service
+	 * @param request	The contract to price
+	 */
+	PricingHandle(PricingRequest const & request);
+};
+
+class PricingService {
+
+public:
+	/**
+	 * The constructor of the PricingService class, it starts the dispatcher thread
+	 * @param workersNumber		The size of the pool of workers (0 for one worker per assigned CPU)
+	 */
+	PricingService(int workersNumber = 0);
+
+	/**
+	 * Distructor of the PricingService: the pending pricings are cancelled and the dispatcher is joined
+	 */
+	~PricingService();
+
+	/**
+	 * Method used to submit a contract. It returns immediately
+	 * @param request	The contract to price
+	 */
+	std::shared_ptr<PricingHandle> submit(PricingRequest const & request);
+
+	/**
+	 * The minimum number of chunks of an estimate before the tolerance is checked
+	 */
+	static const int MIN_CHUNKS = 4;
+
+private:
+
+	CpuTopology topology;
+	int workersNumber;
+
+	/**
+	 * The submitted pricings, shared with the callers
+	 */
+	std::mutex mutex;
+	std::vector<std::shared_ptr<PricingHandle> > submitted;
+	bool stopping;
+
+	/**
+	 * The pool: a worker, its chunk and its pricing (empty if the slot is free) for every slot. The workers
+	 * are created at the first chunk of their slot and then kept, with their thread, for all the pricings.
+	 * They are used only by the dispatcher
+	 */
+	std::vector<HestonWorker*> workers;
+	std::vector<ChunkTask*> tasks;
+	std::vector<std::shared_ptr<PricingHandle> > owners;
+	std::vector<std::shared_ptr<PricingHandle> > active;
+	size_t roundRobin;
+
+	CompletionSignal completion;
+	std::thread dispatcher;
+
+	/**
+	 * The thread function of the dispatcher: it starts the chunks, collects them and completes the pricings
+	 */
+	void dispatch();
+
+	/**
+	 * Method used to start the next chunks of the active pricings on the free workers, in round robin
+	 */
+	void schedule();
+
+	/**
+	 * Method used to collect the workers that have completed (or stopped) their chunk
+	 */
+	void collect();
+
+	/**
+	 * Method used to update the estimate of a pricing and to check its tolerance
+	 * @param handle	The pricing
+	 */
+	void update(PricingHandle & handle);
+
+	/**
+	 * Method used to stop the running chunks of a pricing
+	 * @param handle	The pricing
+	 */
+	void stopChunks(PricingHandle & handle);
+};
+
+#endif // PRICINGSERVICE_H_
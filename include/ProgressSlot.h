@@ -0,0 +1,134 @@
+/**
+ *       @file  ProgressSlot.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The slot used by a worker to publish its progress (done simulations and partial sum) while it is
+ *		running. The slot is a triple buffer: the worker writes a new snapshot and swaps it with the middle
+ *		buffer, the monitor swaps the middle buffer with its own one. Both sides only do one atomic exchange,
+ *		so publishing and reading are wait-free. Every slot is aligned to a cache line, so the slots of
+ *		different workers never share a line
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef PROGRESSSLOT_H_
+#define PROGRESSSLOT_H_
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+/**
+ * The size of a cache line of the target processors
+ */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * Method used to allocate an array of objects aligned to a cache line. The C++11 new operator does not
+ * respect an alignment greater than the one of the malloc
+ * @param n	The number of objects to allocate
+ */
+template <typename T>
+T* newAligned(size_t n = 1) {
+	void* memory;
+	if (posix_memalign(&memory, CACHE_LINE_SIZE, n * sizeof(T)) != 0)
+		throw std::bad_alloc();
+
+	T* objects = static_cast<T*>(memory);
+	for (size_t i = 0; i < n; i++)
+		new (objects + i) T();
+	return objects;
+}
+
+/**
+ * Method used to copy an object in a new memory area aligned to a cache line
+ * @param object	The object to copy
+ */
+template <typename T>
+T* newAligned(T const & object) {
+	void* memory;
+	if (posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(T)) != 0)
+		throw std::bad_alloc();
+	return new (memory) T(object);
+}
+
+/**
+ * Method used to delete an array allocated with newAligned()
+ * @param objects	The array to delete
+ * @param n		The number of objects in the array
+ */
+template <typename T>
+void deleteAligned(T* objects, size_t n = 1) {
+	if (!objects)
+		return;
+	for (size_t i = 0; i < n; i++)
+		objects[i].~T();
+	free(objects);
+}
+
+/**
+ * The progress of a worker in the current chunk of simulations
+ */
+struct WorkerProgress {
+	int done;	/**< The simulations done */
+	double sum;	/**< The sum of the payoffs of the done simulations */
+};
+
+class alignas(CACHE_LINE_SIZE) ProgressSlot {
+
+public:
+
+	ProgressSlot() : middle(2 | FRESH), back(0), front(1) {
+		for (int i = 0; i < 3; i++) {
+			buffers[i].done = 0;
+			buffers[i].sum = 0.0;
+		}
+	}
+
+	/**
+	 * Method used by the worker to publish a new snapshot of its progress
+	 * @param progress	The progress to publish
+	 */
+	void publish(WorkerProgress const & progress) {
+		buffers[back] = progress;
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	/**
+	 * Method used by the monitor to read the last published snapshot. It never waits for the worker
+	 */
+	WorkerProgress read() {
+		if (middle.load(std::memory_order_relaxed) & FRESH)
+			front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+		return buffers[front];
+	}
+
+private:
+
+	static const int INDEX = 3;
+	static const int FRESH = 4;
+
+	/**
+	 * The three snapshots and the index of the middle one (with the fresh flag)
+	 */
+	WorkerProgress buffers[3];
+	std::atomic<int> middle;
+
+	/**
+	 * The index of the buffer owned by the worker
+	 */
+	int back;
+
+	/**
+	 * The index of the buffer owned by the monitor, on its own cache line
+	 */
+	alignas(CACHE_LINE_SIZE) int front;
+};
+
+#endif // PROGRESSSLOT_H_
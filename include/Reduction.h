@@ -0,0 +1,143 @@
+/**
+ *       @file  Reduction.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The accumulators used to sum the payoffs of the simulations. The pairwise sum collects the values
+ *		in small blocks, sums every block with independent lanes (that the compiler can vectorize) and merges
+ *		the block sums as a binary tree: its error grows as O(log n) and its result depends only on the
+ *		sequence of the values, so it is deterministic whatever the number of threads
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef REDUCTION_H_
+#define REDUCTION_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <cmath>
+
+class PairwiseSum {
+
+public:
+
+	/**
+	 * The number of values summed in a block
+	 */
+	static const int BLOCK = 64;
+
+	PairwiseSum() {
+		reset();
+	}
+
+	/**
+	 * Method used to restart the sum from zero
+	 */
+	void reset() {
+		fill = 0;
+		blocks = 0;
+		for (int i = 0; i < LEVELS; i++)
+			levels[i] = 0.0;
+	}
+
+	/**
+	 * Method used to add a value to the sum
+	 * @param value		The value to add
+	 */
+	void add(double value) {
+		block[fill++] = value;
+		if (fill == BLOCK)
+			flush();
+	}
+
+	/**
+	 * Method used to get the current value of the sum. The partial block and the tree levels are always
+	 * summed in the same order, so the value depends only on the added values
+	 */
+	double get() const {
+		double total = sumBlock(block, fill);
+		for (int i = 0; i < LEVELS; i++)
+			if (blocks & ((uint64_t) 1 << i))
+				total += levels[i];
+		return total;
+	}
+
+	/**
+	 * Method used to sum an array with the pairwise algorithm
+	 * @param values	The values to sum
+	 * @param n		The number of values
+	 */
+	static double sum(const double* values, size_t n) {
+		if (n <= (size_t) BLOCK)
+			return sumBlock(values, (int) n);
+		size_t half = (n / 2 + BLOCK - 1) / BLOCK * BLOCK;
+		return sum(values, half) + sum(values + half, n - half);
+	}
+
+	/**
+	 * Method used to sum a block of values: eight independent lanes, combined as a tree at the end
+	 * @param values	The values to sum
+	 * @param n		The number of values (at most BLOCK)
+	 */
+	static double sumBlock(const double* values, int n) {
+		double lanes[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+		int i = 0;
+		for (; i + 8 <= n; i += 8)
+			for (int l = 0; l < 8; l++)
+				lanes[l] += values[i + l];
+		for (int l = 0; l < 8 && i + l < n; l++)
+			lanes[l] += values[i + l];
+		return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+	}
+
+private:
+
+	static const int LEVELS = 48;
+
+	/**
+	 * The partial block and the sums of 2^i blocks at every level of the tree: the set bits of the
+	 * number of blocks tell which levels are used (like a binary counter)
+	 */
+	double block[BLOCK];
+	int fill;
+	double levels[LEVELS];
+	uint64_t blocks;
+
+	/**
+	 * Method used to sum the full block and to merge it in the tree
+	 */
+	void flush() {
+		double carry = sumBlock(block, BLOCK);
+		int level = 0;
+		while (blocks & ((uint64_t) 1 << level)) {
+			carry = levels[level] + carry;
+			level++;
+		}
+		levels[level] = carry;
+		blocks++;
+		fill = 0;
+	}
+};
+
+/**
+ * Method used to get the standard error of the mean of n independent values from their sum and from the sum of
+ * their squares (0 with less than two values)
+ * @param sum		The sum of the values
+ * @param squares	The sum of the squares of the values
+ * @param n		The number of values
+ */
+inline double standardError(double sum, double squares, double n) {
+	if (n < 2.0)
+		return 0.0;
+	double mean = sum / n;
+	double variance = (squares - sum * mean) / (n - 1.0);
+	return variance > 0.0 ? sqrt(variance / n) : 0.0;
+}
+
+#endif // REDUCTION_H_
@@ -0,0 +1,186 @@
+/**
+ *       @file  ResultAggregator.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The aggregator stage of the result pipeline. A dedicated thread consumes the rings of the workers while
+ *		they simulate their next chunks: it stores the chunk sums for the final reduction, keeps the running
+ *		statistics of the chunk prices and exports the metrics, so the bookkeeping never runs on the workers
+ *		nor on the EXC control thread
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef RESULTAGGREGATOR_H_
+#define RESULTAGGREGATOR_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ResultRing.h"
+#include "CompletionSignal.h"
+#include "RunJournal.h"
+
+/**
+ * The statistics of the chunks consumed so far
+ */
+struct AggregateSnapshot {
+	int chunks;		/**< The consumed chunks */
+	int simulations;	/**< The simulations of the consumed chunks */
+	double sum;		/**< The sum of the payoffs of the consumed chunks */
+	double price;		/**< The discounted price of the consumed chunks */
+	double standardError;	/**< The standard error of the price, from the dispersion of the chunk prices */
+};
+
+class ResultAggregator {
+
+public:
+	/**
+	 * The constructor of the ResultAggregator class
+	 * @param producers	The number of workers, every one with its own ring
+	 * @param chunksNumber	The number of chunks of the run
+	 * @param discount	The discount factor at the maturity
+	 */
+	ResultAggregator(int producers, int chunksNumber, double discount);
+
+	/**
+	 * Distructor of the ResultAggregator, it stops the thread if it is running
+	 */
+	~ResultAggregator();
+
+	/**
+	 * Method used to export the metrics of the workers every time new results are consumed
+	 * @param metricsFile	The file to write: JSON if it ends with ".json", Prometheus text otherwise
+	 */
+	void setMetricsFile(std::string const & metricsFile);
+
+	/**
+	 * Method used to record the accumulator of every consumed chunk in the journal of the run
+	 * @param journal	The journal, or NULL to not record the chunks
+	 */
+	void setJournal(RunJournal* journal);
+
+	/**
+	 * Method used to get the ring of a worker
+	 * @param producer	The index of the worker
+	 */
+	ResultRing* getRing(int producer);
+
+	/**
+	 * Method used to get the signal notified by the workers after a push
+	 */
+	CompletionSignal* getSignal();
+
+	/**
+	 * Method used to start the aggregator thread
+	 */
+	void start();
+
+	/**
+	 * Method used to stop the aggregator thread, after it has consumed all the pushed results
+	 */
+	void stop();
+
+	/**
+	 * Method used to read the statistics of the chunks consumed so far
+	 */
+	AggregateSnapshot getSnapshot();
+
+	/**
+	 * Method used to set the metrics of a worker which are not in the rings (the ones of its stopped chunks).
+	 * It must be called only when the aggregator is stopped
+	 * @param producer	The index of the worker
+	 * @param metrics	The metrics of the worker
+	 */
+	void setWorkerMetrics(int producer, WorkerMetrics const & metrics);
+
+	/**
+	 * Method used to write the metrics file, if it is requested
+	 * @param price		The price to export
+	 */
+	void exportMetrics(double price);
+
+	/**
+	 * Method used to get the sum of every chunk (zero for the chunks not completed). It must be called only
+	 * when the aggregator is stopped
+	 */
+	std::vector<double> const & getChunkSums();
+
+	/**
+	 * Method used to get the simulations of every chunk. It must be called only when the aggregator is stopped
+	 */
+	std::vector<int> const & getChunkDone();
+
+private:
+
+	int producers;
+	double discount;
+
+	/**
+	 * The rings of the workers and the signal used to wake up the aggregator
+	 */
+	ResultRing* rings;
+	CompletionSignal signal;
+
+	/**
+	 * The state of the aggregator thread
+	 */
+	std::thread aggregator;
+	std::atomic<bool> hasToWork;
+
+	/**
+	 * The results of the chunks and the running mean and variance (Welford) of the chunk prices, used only by
+	 * the aggregator thread
+	 */
+	std::vector<double> chunkSums;
+	std::vector<int> chunkDone;
+	std::vector<WorkerMetrics> metrics;
+	double meanPrice;
+	double squaresPrice;
+
+	/**
+	 * The last statistics, read by the monitor
+	 */
+	std::mutex snapshotMutex;
+	AggregateSnapshot snapshot;
+
+	std::string metricsFile;
+	std::chrono::steady_clock::time_point startTime;
+
+	/**
+	 * The journal of the run, if any
+	 */
+	RunJournal* journal;
+
+	/**
+	 * The maximum time (in milliseconds) the aggregator sleeps without a push
+	 */
+	static const int WAIT_MS = 50;
+
+	/**
+	 * The thread function: it consumes the rings until it is stopped
+	 */
+	void run();
+
+	/**
+	 * Method used to consume all the results in the rings. It returns the number of consumed results
+	 */
+	int drain();
+
+	/**
+	 * Method used to add a result to the statistics
+	 * @param producer	The index of the worker
+	 * @param result	The result of the chunk
+	 */
+	void consume(int producer, ChunkResult const & result);
+};
+
+#endif // RESULTAGGREGATOR_H_
@@ -0,0 +1,99 @@
+/**
+ *       @file  ResultRing.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The lock-free ring where a worker pushes the results of its completed chunks. Every worker has its own
+ *		ring, with a single producer (the worker) and a single consumer (the aggregator), so a push is a copy
+ *		and a release store, and the worker never waits for the aggregator
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef RESULTRING_H_
+#define RESULTRING_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#include "ProgressSlot.h"
+#include "Metrics.h"
+
+/**
+ * The result of a completed chunk
+ */
+struct ChunkResult {
+	int index;			/**< The index of the chunk */
+	int done;			/**< The simulations of the chunk */
+	double sum;			/**< The sum of the payoffs of the chunk */
+	WorkerMetrics metrics;		/**< The metrics of the worker, accumulated over all its chunks */
+};
+
+class alignas(CACHE_LINE_SIZE) ResultRing {
+
+public:
+
+	ResultRing() : head(0), tail(0), mask(0) {}
+
+	/**
+	 * Method used to allocate the slots of the ring. It must be called before any push, and the capacity
+	 * must be the maximum number of results not consumed yet (the number of chunks is always enough)
+	 * @param capacity	The minimum number of slots
+	 */
+	void reserve(size_t capacity) {
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+		slots.resize(size);
+		mask = size - 1;
+	}
+
+	/**
+	 * Method used by the producer to push a result. It returns false if the ring is full
+	 * @param result	The result to push
+	 */
+	bool push(ChunkResult const & result) {
+		uint64_t position = tail.load(std::memory_order_relaxed);
+		if (position - head.load(std::memory_order_acquire) == slots.size())
+			return false;
+		slots[position & mask] = result;
+		tail.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Method used by the consumer to pop the oldest result. It returns false if the ring is empty
+	 * @param result	The popped result
+	 */
+	bool pop(ChunkResult & result) {
+		uint64_t position = head.load(std::memory_order_relaxed);
+		if (position == tail.load(std::memory_order_acquire))
+			return false;
+		result = slots[position & mask];
+		head.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+
+	/**
+	 * The position of the next pop, written only by the consumer
+	 */
+	std::atomic<uint64_t> head;
+
+	/**
+	 * The position of the next push, written only by the producer, on its own cache line
+	 */
+	alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+
+	alignas(CACHE_LINE_SIZE) std::vector<ChunkResult> slots;
+	uint64_t mask;
+};
+
+#endif // RESULTRING_H_
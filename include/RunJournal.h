@@ -0,0 +1,233 @@
+/**
+ *       @file  RunJournal.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The append-only binary journal of a run. It records the inputs of the run (parameters, seed, chunk
+ *		layout, scheme), every reconfiguration of the resources, the accumulator of every completed chunk and
+ *		the final result, so a price can be audited and every chunk replayed on its own. The records are
+ *		copied in a buffer and written by a journal thread, and every record has its length and checksum,
+ *		so a journal cut by a crash is read up to its last complete record
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef RUNJOURNAL_H_
+#define RUNJOURNAL_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <cstdio>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * The types of the records of the journal
+ */
+enum JournalRecordType {
+	JOURNAL_INPUTS = 1,	/**< The parameters of the run (JournalInputs) */
+	JOURNAL_CURVES = 2,	/**< The curves of the rate, of the dividend yield, of kappa, theta and xi and the time grid, one per line */
+	JOURNAL_CONFIGURE = 3,	/**< A reconfiguration of the resources (JournalConfigure) */
+	JOURNAL_CHUNK = 4,	/**< The accumulator of a completed chunk (JournalChunk) */
+	JOURNAL_RESULT = 5	/**< The final result of the run (JournalResult) */
+};
+
+/**
+ * The parameters of a run. Together with the curves they are all the inputs of the simulation of a chunk:
+ * the chunk i has the simulations from i * chunkSimulations and the substream of (seed, i)
+ */
+struct JournalInputs {
+	double S0;
+	double K;
+	double r;
+	double T;
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	uint64_t seed;
+	int32_t simulations;		/**< The simulations (antithetic couples) of the run */
+	int32_t discretization;
+	int32_t chunkSimulations;	/**< The simulations of every chunk */
+	int32_t mixing;			/**< 1 for the conditional Monte Carlo simulation */
+	int32_t singlePrecision;	/**< 1 for the paths in single precision */
+	int32_t inverseNormal;		/**< The tier of the inverse normal (InverseNormalTier) */
+	int32_t model;			/**< The model (ModelType) */
+	int32_t richardson;		/**< 1 for the Richardson extrapolation */
+	double jumpIntensity;
+	double jumpMean;
+	double jumpVolatility;
+	double V02;			/**< The parameters of the second variance factor */
+	double rho2;
+	double kappa2;
+	double theta2;
+	double xi2;
+};
+
+/**
+ * A reconfiguration of the resources assigned by the BarbequeRTRM
+ */
+struct JournalConfigure {
+	double seconds;			/**< The time from the start of the journal */
+	int32_t awm;			/**< The working mode */
+	int32_t workers;		/**< The workers running in the working mode */
+	int32_t cpus;			/**< The CPUs assigned */
+	int32_t nodes;			/**< The NUMA nodes of the CPUs */
+};
+
+/**
+ * The accumulator of a completed chunk
+ */
+struct JournalChunk {
+	double seconds;			/**< The time from the start of the journal */
+	double sum;			/**< The sum of the payoffs of the chunk */
+	int32_t index;			/**< The index of the chunk */
+	int32_t done;			/**< The simulations of the chunk */
+	int32_t worker;			/**< The worker that completed the chunk */
+	int32_t reserved;
+};
+
+/**
+ * The final result of a run
+ */
+struct JournalResult {
+	double seconds;			/**< The time from the start of the journal */
+	double price;			/**< The price, the pairwise sum of the chunks in their order */
+	double standardDeviation;	/**< The standard deviation of the chunk prices */
+	int32_t simulations;		/**< The simulations of the completed chunks */
+	int32_t chunks;			/**< The completed chunks */
+};
+
+/**
+ * A record read from a journal
+ */
+struct JournalRecord {
+	uint32_t type;
+	std::vector<char> payload;
+
+	/**
+	 * Method used to read the payload of a record of a fixed size, it returns false if the size is not
+	 * the one of the structure
+	 * @param value		The structure to fill
+	 */
+	template <typename T>
+	bool get(T & value) const {
+		if (payload.size() != sizeof(T))
+			return false;
+		memcpy(&value, &payload[0], sizeof(T));
+		return true;
+	}
+};
+
+class RunJournal {
+
+public:
+
+	RunJournal();
+
+	/**
+	 * Distructor of the RunJournal, it closes the journal
+	 */
+	~RunJournal();
+
+	/**
+	 * Method used to create the journal and to start the journal thread. An existing file is replaced
+	 * @param path		The file of the journal
+	 */
+	bool open(std::string const & path);
+
+	/**
+	 * Method used to know if the journal is open
+	 */
+	bool isOpen() const;
+
+	/**
+	 * Method used to append a record. The record is copied in the buffer of the journal thread, so the
+	 * caller never waits for the disk. It does nothing if the journal is not open
+	 * @param type		The type of the record
+	 * @param payload	The content of the record
+	 * @param size		The size of the content
+	 */
+	void append(JournalRecordType type, const void* payload, size_t size);
+
+	/**
+	 * Method used to append a record of a fixed size structure
+	 * @param type		The type of the record
+	 * @param value		The content of the record
+	 */
+	template <typename T>
+	void append(JournalRecordType type, T const & value) {
+		append(type, &value, sizeof(T));
+	}
+
+	/**
+	 * Method used to get the seconds from the opening of the journal, the time of the records
+	 */
+	double elapsed() const;
+
+	/**
+	 * Method used to stop the journal thread, after it has written and synchronized all the records, and
+	 * to close the file
+	 */
+	void close();
+
+	/**
+	 * Method used to read all the complete records of a journal. A truncated or corrupted record ends the
+	 * reading (it is the record being written when the run stopped). It returns false if the file is not
+	 * a journal
+	 * @param path		The file of the journal
+	 * @param records	The records read
+	 * @param truncated	True if the journal ends with an incomplete record
+	 */
+	static bool read(std::string const & path, std::vector<JournalRecord> & records, bool & truncated);
+
+private:
+
+	FILE* file;
+
+	/**
+	 * The records appended and not yet taken by the journal thread, and the ones being written
+	 */
+	std::vector<char> pending;
+	std::vector<char> writing;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::thread writer;
+	bool closing;
+
+	std::chrono::steady_clock::time_point startTime;
+
+	/**
+	 * The capacity reserved for the buffers, so the appends of a run do not allocate
+	 */
+	static const size_t BUFFER_SIZE = 64 * 1024;
+
+	/**
+	 * The thread function: it writes the appended records and synchronizes them on the disk
+	 */
+	void run();
+
+	/**
+	 * Method used to compute the CRC-32 of a block of bytes
+	 * @param crc		The CRC of the previous bytes (0 at the start)
+	 * @param data		The bytes
+	 * @param size		The number of bytes
+	 */
+	static uint32_t checksum(uint32_t crc, const void* data, size_t size);
+
+	RunJournal(RunJournal const &);
+	RunJournal& operator=(RunJournal const &);
+};
+
+#endif // RUNJOURNAL_H_
@@ -0,0 +1,186 @@
+/**
+ *       @file  ScenarioEngine.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The engine used to revalue the option under a grid of shocked parameters (stress scenarios). All the
+ *		scenarios are simulated on the same block of normals (common random numbers), so the difference between
+ *		two scenarios is due to the shock and not to the Monte Carlo noise. The scenarios are run in parallel
+ *		by a pool of workers pinned on the assigned CPUs, and the results are written in a columnar file.
+ *		In the lane mode the scenarios are simulated together instead: every path is drawn once and it is
+ *		carried by all the scenarios, LANES parameter sets at a time, so the random numbers cost the same
+ *		for one scenario or for many
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef SCENARIOENGINE_H_
+#define SCENARIOENGINE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "ChunkTask.h"
+#include "CommonNormals.h"
+
+/**
+ * The parameters of the option under a scenario, and its price
+ */
+struct Scenario {
+	std::string name;
+	double S0;
+	double K;
+	double r;
+	double T;
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	double price;
+};
+
+class ScenarioEngine {
+
+public:
+	/**
+	 * The constructor of the ScenarioEngine class, the parameters are the ones of the base scenario
+	 *
+	 * @param S0		The spot price of the option
+	 * @param K		The strike price of the option
+	 * @param r		The risk-free rate of the option
+	 * @param T		The maturity time of the option (in years)
+	 * @param V0		The initial volatility of the option
+	 * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+	 * @param kappa		The mean reversion rate of the Heston Model for the considered option
+	 * @param theta		The long-term volatility value
+	 * @param xi		The volatility of volatility (V0)
+	 * @param todo_simulations	The number of the simulations (antithetic couples) of every scenario
+	 * @param discretization	The value of discretization of the simulation
+	 */
+	ScenarioEngine(double S0, double K, double r, double T, double V0, double rho, double kappa, double theta,
+		double xi, int todo_simulations, int discretization);
+
+	/**
+	 * Method used to enable the conditional Monte Carlo (mixing formula) simulation of the scenarios
+	 * @param mixing	True to simulate only the volatility path
+	 */
+	void setMixingMode(bool mixing);
+
+	/**
+	 * Method used to simulate the scenarios in single precision
+	 * @param singlePrecision	True to simulate the paths in single precision
+	 */
+	void setSinglePrecision(bool singlePrecision);
+
+	/**
+	 * Method used to set the seed of the common block of normals (0 for a random seed)
+	 * @param seed		The seed of the block
+	 */
+	void setSeed(uint64_t seed);
+
+	/**
+	 * Method used to simulate the scenarios in lanes: the paths are split in chunks simulated by a pool of
+	 * threads, and every path is drawn once from the substream of its chunk and simulated under all the
+	 * scenarios. The lanes use the Euler simulation (the mixing mode is ignored)
+	 * @param lanes		True to simulate the scenarios in lanes
+	 */
+	void setLanes(bool lanes);
+
+	/**
+	 * Method used to set the number of simulations of every chunk of the lane mode
+	 * @param chunkSimulations	The simulations (antithetic couples) of every chunk
+	 */
+	void setChunkSize(int chunkSimulations);
+
+	/**
+	 * Method used to read the shock file. Every line is a scenario: its name followed by the shocks of the
+	 * base parameters, in the form "param=value", "param+=shift" or "param*=factor" (for example
+	 * "crash S0*=0.7 V0+=0.04"). The parameters are S0, K, r, T, V0, rho, kappa, theta and xi, the empty
+	 * lines and the ones starting with '#' are ignored. The base scenario is always the first one
+	 * @param path		The shock file
+	 */
+	bool load(std::string const & path);
+
+	/**
+	 * Method used to price all the scenarios
+	 */
+	void run();
+
+	/**
+	 * Method used to write the results. The format is CSV if the file name ends with ".csv", otherwise it is
+	 * the columnar binary format: the "HFSC" magic, the number of scenarios and of columns (32 bits each),
+	 * the zero terminated names of the columns, then every column as an array of doubles, and at the end
+	 * the zero terminated names of the scenarios
+	 * @param path		The result file
+	 */
+	bool write(std::string const & path);
+
+	/**
+	 * Method used to get the priced scenarios
+	 */
+	std::vector<Scenario> const & getScenarios();
+
+	/**
+	 * The number of scenarios simulated together on a path in the lane mode
+	 */
+	static const int LANES = 8;
+
+private:
+
+	std::vector<Scenario> scenarios;
+	int todo_simulations;
+	int discretization;
+	bool mixing;
+	bool singlePrecision;
+	bool lanes;
+	int chunkSimulations;
+	uint64_t seed;
+
+	/**
+	 * The normals shared by all the scenarios
+	 */
+	CommonNormals common;
+
+	/**
+	 * The results of the chunks of the lane mode: the sum of every scenario and the simulations done
+	 */
+	std::vector<std::vector<double> > chunkSums;
+	std::vector<int> chunkDone;
+
+	/**
+	 * Method used to price all the scenarios in lanes
+	 */
+	void runLanes();
+
+	/**
+	 * The thread function of the pool of the lane mode: it simulates the next chunk until all the chunks
+	 * are taken
+	 * @param cpu		The CPU where the thread is pinned
+	 * @param next		The index of the next chunk to simulate
+	 */
+	void runWorker(int cpu, std::atomic<int>* next);
+
+	/**
+	 * Method used to simulate a chunk of paths under all the scenarios, in the Real precision
+	 * @param task		The chunk to simulate, with one payoff sum for every scenario
+	 */
+	template <typename Real>
+	void simulateLanes(ChunkTask & task);
+
+	/**
+	 * Method used to apply a shock to a parameter of a scenario
+	 * @param scenario	The scenario to shock
+	 * @param shock		The shock, in the form "param=value", "param+=shift" or "param*=factor"
+	 */
+	static bool applyShock(Scenario & scenario, std::string const & shock);
+};
+
+#endif // SCENARIOENGINE_H_
@@ -0,0 +1,66 @@
+/**
+ *       @file  StartupTimeline.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The timeline of the start of the application: the time of every phase from the initialization of
+ *		the program (logger, command line, RTLib, registration of the EXC, setup, first configuration, first
+ *		chunk and first price), so the fixed costs of a short run can be told apart from the simulation
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef STARTUPTIMELINE_H_
+#define STARTUPTIMELINE_H_
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+/**
+ * A phase of the start, with the time it ended
+ */
+struct StartupPhase {
+	const char* name;	/**< The name of the phase, a string literal */
+	double seconds;		/**< The seconds from the initialization of the program */
+};
+
+class StartupTimeline {
+
+public:
+	/**
+	 * Method used to record the end of a phase. Only the first mark of a phase is kept, so a phase repeated
+	 * at every cycle (e.g. a configuration) is the time of its first occurrence. It can be called by any thread
+	 * @param phase		The name of the phase, a string literal
+	 */
+	static void mark(const char* phase);
+
+	/**
+	 * Method used to get the seconds from the initialization of the program
+	 */
+	static double elapsed();
+
+	/**
+	 * Method used to get the recorded phases, in the order of their marks
+	 */
+	static std::vector<StartupPhase> getPhases();
+
+	/**
+	 * The maximum number of phases recorded, the later ones are ignored
+	 */
+	static const int MAX_PHASES = 16;
+
+private:
+
+	static std::chrono::steady_clock::time_point origin;
+	static std::mutex lock;
+	static StartupPhase phases[MAX_PHASES];
+	static int phasesNumber;
+};
+
+#endif // STARTUPTIMELINE_H_
@@ -0,0 +1,172 @@
+/**
+ *       @file  StepPlanner.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The choice of the number of steps of a contract from a target on the discretization bias. A short
+ *		pilot simulates every path on a coarse grid and on its refinement with the same Brownian increments:
+ *		the difference of the two payoffs has a small variance, so a short run of paths measures the bias
+ *		constant of the contract, and the steps are the fewest that bring the bias under the target
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef STEPPLANNER_H_
+#define STEPPLANNER_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "Option.h"
+#include "HestonModel.h"
+#include "TermStructure.h"
+#include "TimeGrid.h"
+
+class StepPlanner {
+
+public:
+	/**
+	 * The constructor of the StepPlanner class
+	 *
+	 * @param S0		The spot price of the option
+	 * @param K		The strike price of the option
+	 * @param r		The risk-free rate of the option
+	 * @param T		The maturity time of the option (in years)
+	 * @param V0		The initial volatility of the option
+	 * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+	 * @param kappa		The mean reversion rate of the Heston Model for the considered option
+	 * @param theta		The long-term volatility value
+	 * @param xi		The volatility of volatility (V0)
+	 */
+	StepPlanner(double S0, double K, double r, double T, double V0, double rho, double kappa, double theta, double xi);
+
+	/**
+	 * Method used to select the model of the contract (Heston by default)
+	 * @param model		The model and its parameters
+	 */
+	void setModel(ModelParameters const & model);
+
+	/**
+	 * Method used to set the time-dependent inputs of the model
+	 * @param terms		The curves of the model
+	 */
+	void setTerms(HestonTerms const & terms);
+
+	/**
+	 * Method used to set the time grid of the discretization (uniform by default)
+	 * @param grid		The time grid
+	 */
+	void setTimeGrid(TimeGrid const & grid);
+
+	/**
+	 * Method used to plan for the conditional Monte Carlo (mixing formula) simulation
+	 * @param mixing	True to simulate only the volatility path
+	 */
+	void setMixingMode(bool mixing);
+
+	/**
+	 * Method used to plan for the Richardson extrapolation: its bias decreases with the square of the steps,
+	 * so the pilot measures the second order constant on three grids
+	 * @param richardson	True if the run is extrapolated
+	 */
+	void setRichardson(bool richardson);
+
+	/**
+	 * Method used to plan also for other options on the same paths: the steps are the ones of the option with
+	 * the largest bias
+	 * @param payoffs	The additional options, or NULL to plan only for the call of the constructor
+	 */
+	void setPayoffs(std::vector<Option*> const* payoffs);
+
+	/**
+	 * Method used to set the seed of the pilot, so the plan of a contract is reproducible
+	 * @param seed		The seed of the pilot
+	 */
+	void setSeed(uint64_t seed);
+
+	/**
+	 * Method used to get the fewest steps that bring the discretization bias of the price under a target.
+	 * The bias of the Euler scheme is c / N and the one of the Richardson extrapolation is c / N^2: the constant
+	 * c is measured by the pilot, plus SIGMAS standard errors, so a bias hidden by the noise of the pilot is
+	 * not underestimated
+	 * @param bias		The target on the bias of the price
+	 */
+	int plan(double bias);
+
+	/**
+	 * Method used to get a bound on the discretization bias of the price with a number of steps: the bias
+	 * constant is measured by the pilot (plus SIGMAS standard errors) and the bias is c / N for the Euler
+	 * scheme and c / (2 * N^2) for the Richardson extrapolation
+	 * @param steps		The steps of the grid
+	 */
+	double bound(int steps);
+
+	/**
+	 * Method used to get the bias constant measured by the last plan (the largest over the options)
+	 */
+	double getConstant();
+
+	/**
+	 * The steps of the coarsest grid of the pilot
+	 */
+	static const int PILOT_STEPS = 16;
+
+	/**
+	 * The chunks of the pilot and their simulations (antithetic couples)
+	 */
+	static const int PILOT_CHUNKS = 8;
+	static const int PILOT_SIMULATIONS = 2048;
+
+	/**
+	 * The bounds of the planned steps
+	 */
+	static const int MIN_STEPS = 2;
+	static const int MAX_STEPS = 4096;
+
+	/**
+	 * The standard errors added to the measured differences
+	 */
+	static const double SIGMAS;
+
+private:
+
+	double S0;
+	double K;
+	double r;
+	double T;
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+
+	ModelParameters model;
+	HestonTerms terms;
+	TimeGrid timeGrid;
+	bool mixing;
+	bool richardson;
+	std::vector<Option*> const* payoffs;
+	uint64_t seed;
+
+	double constant;
+
+	/**
+	 * Method used to measure the bias constant with the pilot (the largest over the options)
+	 */
+	void measureConstant();
+
+	/**
+	 * Method used to measure the difference of the prices on a grid and on its refinement, for every option
+	 * @param steps		The steps of the grid
+	 * @param mean		The mean difference of every option (the call first)
+	 * @param error		The standard error of the difference of every option
+	 */
+	void measure(int steps, std::vector<double> & mean, std::vector<double> & error);
+};
+
+#endif // STEPPLANNER_H_
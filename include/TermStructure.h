@@ -0,0 +1,125 @@
+/**
+ *       @file  TermStructure.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The time-dependent inputs of the model: piecewise-constant curves of the risk-free rate, of the
+ *		dividend yield and of the Heston parameters. The curves are never evaluated in the simulation: they
+ *		are integrated once over the steps of the discretization grid into lookup tables, so a time-dependent
+ *		model costs the same indexed loads of a constant one
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef TERMSTRUCTURE_H_
+#define TERMSTRUCTURE_H_
+
+#include <string>
+#include <vector>
+
+class TermStructure {
+
+public:
+	/**
+	 * The constructor of a constant curve
+	 * @param value		The value of the curve at every time
+	 */
+	TermStructure(double value = 0.0);
+
+	/**
+	 * Method used to read a curve. The text is a single value (a constant curve) or a list of pieces
+	 * "time:value", where every value holds up to its time and the last value holds after the last time
+	 * (for example "1:0.02,2:0.025,5:0.03")
+	 * @param text		The curve to read
+	 */
+	bool parse(std::string const & text);
+
+	/**
+	 * Method used to write the curve in the form read by parse(), with all the digits of the doubles, so
+	 * the curve read back is the same
+	 */
+	std::string format() const;
+
+	/**
+	 * Method used to integrate the curve over an interval
+	 * @param from		The start of the interval (in years)
+	 * @param to		The end of the interval (in years)
+	 */
+	double integral(double from, double to) const;
+
+	/**
+	 * Method used to know if the curve has a single value
+	 */
+	bool isConstant() const;
+
+private:
+
+	/**
+	 * The end of every piece (the last piece has no end) and its value
+	 */
+	std::vector<double> times;
+	std::vector<double> values;
+};
+
+/**
+ * The time-dependent inputs of the Heston model
+ */
+struct HestonTerms {
+	TermStructure rate;		/**< The risk-free rate */
+	TermStructure dividend;		/**< The dividend yield */
+	TermStructure kappa;		/**< The mean reversion rate */
+	TermStructure theta;		/**< The long-term volatility */
+	TermStructure xi;		/**< The volatility of volatility */
+};
+
+/**
+ * The inputs of the model integrated over every step of a discretization grid, in the Real precision
+ */
+template <typename Real>
+struct StepTables {
+
+	int steps;			/**< The steps of the grid, 0 if the tables are not built */
+	std::vector<double> times;	/**< The nodes of the grid */
+	std::vector<Real> deltaT;	/**< The length of the step */
+	std::vector<Real> drift;	/**< The integral of the rate minus the dividend yield over the step */
+	std::vector<Real> reversion;	/**< The integral of the mean reversion rate over the step */
+	std::vector<Real> theta;	/**< The average long-term volatility over the step */
+	std::vector<Real> xi;		/**< The average volatility of volatility over the step */
+	std::vector<Real> split;	/**< The weights of the normals of the two halves of every step (refined grids only) */
+
+	StepTables() : steps(0) {}
+
+	/**
+	 * Method used to integrate the curves over the steps of a grid
+	 * @param terms		The curves of the model
+	 * @param times		The nodes of the grid
+	 * @param lengths	The lengths of the steps of the grid
+	 */
+	void build(HestonTerms const & terms, std::vector<double> const & times, std::vector<double> const & lengths) {
+		int steps = (int) lengths.size();
+		this->times = times;
+		deltaT.resize(steps);
+		drift.resize(steps);
+		reversion.resize(steps);
+		theta.resize(steps);
+		xi.resize(steps);
+
+		for (int j = 0; j < steps; j++) {
+			double from = times[j];
+			double to = times[j + 1];
+			deltaT[j] = (Real) lengths[j];
+			drift[j] = (Real) (terms.rate.integral(from, to) - terms.dividend.integral(from, to));
+			reversion[j] = (Real) terms.kappa.integral(from, to);
+			theta[j] = (Real) (terms.theta.integral(from, to) / lengths[j]);
+			xi[j] = (Real) (terms.xi.integral(from, to) / lengths[j]);
+		}
+		this->steps = steps;
+	}
+};
+
+#endif // TERMSTRUCTURE_H_
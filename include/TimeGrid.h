@@ -0,0 +1,88 @@
+/**
+ *       @file  TimeGrid.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The time grid of the discretization. A uniform grid has steps of the same length, a concentrated
+ *		grid has geometric steps that shrink towards the expiry and towards the observation dates, where the
+ *		Euler scheme loses most of its accuracy on the payoff. The grid gives the times of its nodes and the
+ *		lengths of its steps, from which the lookup tables of the model are integrated
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef TIMEGRID_H_
+#define TIMEGRID_H_
+
+#include <string>
+#include <vector>
+
+class TimeGrid {
+
+public:
+	/**
+	 * The constructor of the TimeGrid class
+	 * @param concentration	The ratio between the first and the last step of every segment (1 for a uniform grid)
+	 */
+	TimeGrid(double concentration = 1.0);
+
+	/**
+	 * Method used to read a grid. The text is the concentration, optionally followed by the observation dates
+	 * (for example "4" or "4:0.25,0.5,0.75"). The dates split the grid in segments, every segment has a
+	 * number of steps proportional to its length and its steps shrink towards its end
+	 * @param text		The grid to read
+	 */
+	bool parse(std::string const & text);
+
+	/**
+	 * Method used to write the grid in the form read by parse(), with all the digits of the doubles
+	 */
+	std::string format() const;
+
+	/**
+	 * Method used to know if the grid has steps of the same length
+	 */
+	bool isUniform() const;
+
+	/**
+	 * Method used to compute the nodes of the grid over a maturity. A uniform grid has the nodes j * T / steps
+	 * and the steps T / steps, the ones of the constant discretization
+	 * @param T		The maturity (in years)
+	 * @param steps		The number of steps
+	 * @param times		The steps + 1 nodes of the grid
+	 * @param lengths	The lengths of the steps
+	 */
+	void build(double T, int steps, std::vector<double> & times, std::vector<double> & lengths) const;
+
+	/**
+	 * Method used to compute the grid made of every other node of a grid with an even number of steps: every
+	 * step of the coarse grid is the union of two steps of the fine one
+	 * @param times		The nodes of the fine grid
+	 * @param lengths	The lengths of the steps of the fine grid
+	 * @param coarseTimes	The nodes of the coarse grid
+	 * @param coarseLengths	The lengths of the steps of the coarse grid
+	 */
+	static void coarsen(std::vector<double> const & times, std::vector<double> const & lengths,
+		std::vector<double> & coarseTimes, std::vector<double> & coarseLengths);
+
+	/**
+	 * The maximum ratio between the first and the last step of a segment
+	 */
+	static const double MAX_CONCENTRATION;
+
+private:
+
+	double concentration;
+
+	/**
+	 * The observation dates (in years), in increasing order
+	 */
+	std::vector<double> dates;
+};
+
+#endif // TIMEGRID_H_
@@ -0,0 +1,148 @@
+/**
+ *       @file  ValidationSuite.h
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The validation of the Monte Carlo engine on a grid of contracts and models. Every case is simulated
+ *		in chunks by a worker, as in the application, and its call and put prices must be within a number of
+ *		standard errors of the semi-analytic prices, so a bias introduced by an optimization is caught. The
+ *		throughput of every case is compared with the baseline of the machine, so a slowdown is caught too
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#ifndef VALIDATIONSUITE_H_
+#define VALIDATIONSUITE_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "HestonModel.h"
+
+/**
+ * A case of the validation: a contract, its model and the configuration of the engine
+ */
+struct ValidationCase {
+	std::string name;
+	double S0;
+	double K;
+	double r;
+	double T;
+	double V0;
+	double rho;
+	double kappa;
+	double theta;
+	double xi;
+	int discretization;
+	bool mixing;
+	bool singlePrecision;
+	bool richardson;		/**< True to extrapolate the price over the grid and its refinement */
+	ModelParameters model;
+};
+
+/**
+ * The result of a case
+ */
+struct ValidationResult {
+	double call;			/**< The Monte Carlo prices */
+	double put;
+	double callError;		/**< The standard errors of the prices */
+	double putError;
+	double analyticCall;		/**< The semi-analytic prices */
+	double analyticPut;
+	double bias;			/**< The allowance for the discretization bias of the prices */
+	double pathsPerSecond;		/**< The paths simulated per second of work of the worker */
+	double baseline;		/**< The baseline throughput of the machine (0 if there is none) */
+	bool converged;			/**< True if both the prices are within the tolerance */
+	bool fast;			/**< True if the throughput is not below the baseline tolerance */
+};
+
+class ValidationSuite {
+
+public:
+	/**
+	 * The constructor of the ValidationSuite class
+	 *
+	 * @param chunks		The chunks simulated for every case
+	 * @param chunkSimulations	The simulations (antithetic couples) of every chunk
+	 * @param seed			The seed of the chunks (0 for a fixed seed)
+	 */
+	ValidationSuite(int chunks, int chunkSimulations, uint64_t seed);
+
+	/**
+	 * Method used to add a case
+	 * @param validationCase	The case to add
+	 */
+	void add(ValidationCase const & validationCase);
+
+	/**
+	 * Method used to add the grid of the cases around a base case: the base contract with the Euler, the
+	 * conditional and the single precision engines, in and out of the money contracts of one year with a
+	 * steeper skew and their Richardson extrapolation on a coarser grid, a short contract with a low volatility,
+	 * and the Bates and double Heston models
+	 * @param base		The base case (the parameters of the command line)
+	 * @param model		The parameters of the jumps and of the second variance factor of the grid
+	 */
+	void addGrid(ValidationCase const & base, ModelParameters const & model);
+
+	/**
+	 * Method used to read the baseline throughputs, one "host case paths-per-second" line for every case
+	 * of every machine. A missing file is an empty baseline
+	 * @param path		The baseline file
+	 */
+	bool loadBaseline(std::string const & path);
+
+	/**
+	 * Method used to write the baseline with the throughputs measured by the last run for this machine, the
+	 * lines of the other machines are kept
+	 * @param path		The baseline file
+	 */
+	bool saveBaseline(std::string const & path);
+
+	/**
+	 * Method used to run all the cases and to print their report. It returns the number of failed cases
+	 */
+	int run();
+
+	/**
+	 * Method used to get the result of a case, after the run
+	 * @param index		The index of the case
+	 */
+	ValidationResult const & getResult(int index);
+
+	/**
+	 * The tolerance of the prices, in standard errors, and of the throughput, as a fraction of the baseline
+	 */
+	static const double SIGMAS;
+	static const double THROUGHPUT_TOLERANCE;
+
+private:
+
+	int chunks;
+	int chunkSimulations;
+	uint64_t seed;
+	std::string host;
+
+	std::vector<ValidationCase> cases;
+	std::vector<ValidationResult> results;
+
+	/**
+	 * The baseline throughputs, by machine and by case
+	 */
+	std::map<std::string, std::map<std::string, double> > baseline;
+
+	/**
+	 * Method used to simulate a case
+	 * @param validationCase	The case to simulate
+	 */
+	ValidationResult simulate(ValidationCase const & validationCase);
+};
+
+#endif // VALIDATIONSUITE_H_
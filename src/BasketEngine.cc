@@ -0,0 +1,437 @@
+/**
+ *       @file  BasketEngine.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The multi-asset Heston engine. Every asset has its own spot and variance, and all the 2N drivers are
+ *		correlated by a full correlation matrix. The correlated draws of a block of paths are obtained with a
+ *		single multiplication of the Cholesky factor by the block of independent normals, and the basket,
+ *		best-of and worst-of payoffs are priced on the same paths
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "BasketEngine.h"
+#include "HestonWorker.h"
+#include "CpuTopology.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+/**
+ * The constructor of the BasketEngine class
+ *
+ * @param defaults	The default parameters of the assets, used for the fields missing in the basket file
+ * @param r		The risk-free rate
+ * @param T		The maturity time (in years)
+ * @param todo_simulations	The number of the simulations (antithetic couples)
+ * @param discretization	The value of discretization of the simulation
+ */
+BasketEngine::BasketEngine(BasketAsset const & defaults, double r, double T, int todo_simulations,
+		int discretization) {
+	this->defaults = defaults;
+	this->r = r;
+	this->T = T;
+	this->todo_simulations = todo_simulations;
+	this->discretization = discretization;
+	this->chunkSimulations = 10000;
+	this->seed = 0;
+}
+
+/**
+ * Method used to set the seed of the simulation (0 for a random seed)
+ * @param seed		The seed of the simulation
+ */
+void BasketEngine::setSeed(uint64_t seed) {
+	this->seed = seed;
+}
+
+/**
+ * Method used to set the number of simulations of every chunk
+ * @param chunkSimulations	The simulations (antithetic couples) of every chunk
+ */
+void BasketEngine::setChunkSize(int chunkSimulations) {
+	this->chunkSimulations = std::max(chunkSimulations, BLOCK_PATHS);
+}
+
+/**
+ * Method used to read the basket file. Every line is an asset ("asset NAME param=value ..."), a correlation
+ * ("corr A B value") or a payoff ("payoff NAME TYPE K")
+ * @param path		The basket file
+ */
+bool BasketEngine::load(std::string const & path) {
+
+	std::ifstream file(path.c_str());
+	if (!file) {
+		std::cout << "Unable to open the basket file " << path << std::endl;
+		return false;
+	}
+
+	// The correlations are applied at the end, when all the assets are known
+	std::vector<std::string> pairs;
+	std::vector<double> values;
+	std::vector<int> lines;
+
+	std::string line;
+	int number = 0;
+	while (std::getline(file, line)) {
+		number++;
+
+		std::istringstream tokens(line);
+		std::string kind;
+		if (!(tokens >> kind) || kind[0] == '#')
+			continue;
+
+		bool valid = true;
+		if (kind == "asset") {
+			BasketAsset asset = defaults;
+			std::string field;
+			valid = (bool) (tokens >> asset.name) && driver(asset.name) < 0;
+			while (valid && tokens >> field) {
+				size_t equal = field.find('=');
+				char* last;
+				double value = (equal == std::string::npos) ? 0.0 : strtod(field.c_str() + equal + 1, &last);
+				if (equal == std::string::npos || equal + 1 == field.size() || *last != '\0') {
+					valid = false;
+					break;
+				}
+
+				std::string name = field.substr(0, equal);
+				if (name == "S0")		asset.S0 = value;
+				else if (name == "V0")		asset.V0 = value;
+				else if (name == "rho")		asset.rho = value;
+				else if (name == "kappa")	asset.kappa = value;
+				else if (name == "theta")	asset.theta = value;
+				else if (name == "xi")		asset.xi = value;
+				else if (name == "q")		asset.dividend = value;
+				else if (name == "weight")	asset.weight = value;
+				else
+					valid = false;
+			}
+			valid = valid && asset.S0 > 0.0 && asset.V0 >= 0.0 && fabs(asset.rho) <= 1.0;
+			if (valid)
+				assets.push_back(asset);
+		} else if (kind == "corr") {
+			std::string first, second;
+			double value;
+			valid = (bool) (tokens >> first >> second >> value) && fabs(value) <= 1.0;
+			pairs.push_back(first);
+			pairs.push_back(second);
+			values.push_back(value);
+			lines.push_back(number);
+		} else if (kind == "payoff") {
+			BasketPayoff payoff;
+			std::string type;
+			valid = (bool) (tokens >> payoff.name >> type >> payoff.K);
+
+			size_t dash = type.rfind('-');
+			std::string underlying = type.substr(0, dash == std::string::npos ? 0 : dash);
+			std::string side = (dash == std::string::npos) ? "" : type.substr(dash + 1);
+			if (underlying == "basket")		payoff.underlying = BASKET_SUM;
+			else if (underlying == "best-of")	payoff.underlying = BASKET_BEST;
+			else if (underlying == "worst-of")	payoff.underlying = BASKET_WORST;
+			else
+				valid = false;
+			valid = valid && (side == "call" || side == "put");
+			payoff.call = (side == "call");
+			payoff.price = 0.0;
+			payoff.standardError = 0.0;
+			if (valid)
+				payoffs.push_back(payoff);
+		} else {
+			valid = false;
+		}
+
+		if (!valid) {
+			std::cout << path << ":" << number << ": invalid line" << std::endl;
+			return false;
+		}
+	}
+
+	if (assets.empty() || payoffs.empty()) {
+		std::cout << path << ": the basket needs at least an asset and a payoff" << std::endl;
+		return false;
+	}
+
+	// The drivers are independent, apart from the spot and the variance of the same asset
+	int drivers = 2 * (int) assets.size();
+	correlation.assign(drivers * drivers, 0.0);
+	for (int d = 0; d < drivers; d++)
+		correlation[d * drivers + d] = 1.0;
+	for (size_t a = 0; a < assets.size(); a++) {
+		correlation[(2 * a) * drivers + 2 * a + 1] = assets[a].rho;
+		correlation[(2 * a + 1) * drivers + 2 * a] = assets[a].rho;
+	}
+
+	for (size_t c = 0; c < values.size(); c++) {
+		int i = driver(pairs[2 * c]);
+		int j = driver(pairs[2 * c + 1]);
+		if (i < 0 || j < 0 || i == j) {
+			std::cout << path << ":" << lines[c] << ": invalid correlation" << std::endl;
+			return false;
+		}
+		correlation[i * drivers + j] = values[c];
+		correlation[j * drivers + i] = values[c];
+	}
+
+	return true;
+}
+
+/**
+ * Method used to get the index of a driver from its name
+ * @param name		The asset name, or NAME.v for its variance
+ */
+int BasketEngine::driver(std::string const & name) {
+
+	bool variance = name.size() > 2 && name.compare(name.size() - 2, 2, ".v") == 0;
+	std::string asset = variance ? name.substr(0, name.size() - 2) : name;
+	for (size_t a = 0; a < assets.size(); a++)
+		if (assets[a].name == asset)
+			return 2 * (int) a + (variance ? 1 : 0);
+	return -1;
+}
+
+/**
+ * Method used to compute the Cholesky factor of the correlation matrix. It fails if the matrix is not
+ * positive definite
+ */
+bool BasketEngine::factorize() {
+
+	int drivers = 2 * (int) assets.size();
+	cholesky.assign(drivers * (drivers + 1) / 2, 0.0);
+
+	for (int i = 0; i < drivers; i++) {
+		double* row = &cholesky[i * (i + 1) / 2];
+		for (int j = 0; j <= i; j++) {
+			const double* column = &cholesky[j * (j + 1) / 2];
+			double value = correlation[i * drivers + j];
+			for (int k = 0; k < j; k++)
+				value -= row[k] * column[k];
+
+			if (i == j) {
+				if (value <= 0.0)
+					return false;
+				row[i] = sqrt(value);
+			} else {
+				row[j] = value / column[j];
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Method used to price all the payoffs. The chunks are simulated by a pool of threads pinned on the assigned
+ * CPUs, and their sums are reduced in the chunk order, so the prices depend only on the seed and on the chunk
+ * size
+ */
+void BasketEngine::run() {
+
+	if (seed == 0)
+		seed = ((uint64_t) std::random_device()() << 32) | std::random_device()();
+
+	int chunksNumber = (todo_simulations + chunkSimulations - 1) / chunkSimulations;
+	chunkSums.assign(payoffs.size(), std::vector<double>(chunksNumber, 0.0));
+	chunkSquares.assign(payoffs.size(), std::vector<double>(chunksNumber, 0.0));
+	chunkDone.assign(chunksNumber, 0);
+
+	CpuTopology topology;
+	int workersNumber = std::min(std::max(topology.getCpusNumber(), 1), chunksNumber);
+
+	std::atomic<int> next(0);
+	std::vector<std::thread> workers;
+	for (int i = 0; i < workersNumber; i++)
+		workers.push_back(std::thread(&BasketEngine::runWorker, this, topology.getCpu(i), &next));
+	for (int i = 0; i < workersNumber; i++)
+		workers[i].join();
+
+	// The standard error comes from the variance of the payoffs of all the antithetic couples, so a run of a
+	// single chunk has one too
+	double discount = exp(-r * T);
+	for (size_t k = 0; k < payoffs.size(); k++) {
+		BasketPayoff & payoff = payoffs[k];
+		double sum = PairwiseSum::sum(&chunkSums[k][0], chunksNumber);
+		double squares = PairwiseSum::sum(&chunkSquares[k][0], chunksNumber);
+		payoff.price = sum / (2.0 * todo_simulations) * discount;
+		payoff.standardError = standardError(sum, squares, todo_simulations) / 2.0 * discount;
+	}
+}
+
+/**
+ * The thread function of the pool: it simulates the next chunk until all the chunks are taken
+ * @param cpu		The CPU where the thread is pinned
+ * @param next		The index of the next chunk to simulate
+ */
+void BasketEngine::runWorker(int cpu, std::atomic<int>* next) {
+
+	CpuTopology::pinCurrentThread(cpu);
+
+	ChunkTask task;
+	task.setPayoffs(payoffs.size());
+
+	int chunksNumber = (int) chunkDone.size();
+	int chunk;
+	while ((chunk = next->fetch_add(1)) < chunksNumber) {
+		int first = chunk * chunkSimulations;
+		task.reset(chunk, first, std::min(chunkSimulations, todo_simulations - first), seed);
+		simulateChunk(task);
+
+		for (size_t k = 0; k < payoffs.size(); k++) {
+			chunkSums[k][chunk] = task.payoffSums[k].get();
+			chunkSquares[k][chunk] = task.payoffSquares[k].get();
+		}
+		chunkDone[chunk] = task.done;
+	}
+}
+
+/**
+ * Method used to simulate a chunk of paths, BLOCK_PATHS paths (and their antithetic ones) at a time.
+ * The state of the block is stored by asset, with the paths contiguous, so every update runs over the
+ * BLOCK_PATHS lanes of an asset
+ * @param task		The chunk to simulate
+ */
+void BasketEngine::simulateChunk(ChunkTask & task) {
+
+	const int assetsNumber = (int) assets.size();
+	const int drivers = 2 * assetsNumber;
+	const double deltaT = T / discretization;
+
+	std::vector<double> independent(drivers * BLOCK_PATHS, 0.0);
+	std::vector<double> correlated(drivers * BLOCK_PATHS, 0.0);
+	std::vector<double> spot(assetsNumber * BLOCK_PATHS);
+	std::vector<double> volatility(assetsNumber * BLOCK_PATHS);
+	std::vector<double> antithetic_spot(assetsNumber * BLOCK_PATHS);
+	std::vector<double> antithetic_volatility(assetsNumber * BLOCK_PATHS);
+
+	for (int i = 0; i < task.todo; i += BLOCK_PATHS) {
+		int paths = std::min(BLOCK_PATHS, task.todo - i);
+
+		for (int a = 0; a < assetsNumber; a++) {
+			for (int p = 0; p < BLOCK_PATHS; p++) {
+				spot[a * BLOCK_PATHS + p] = assets[a].S0;
+				volatility[a * BLOCK_PATHS + p] = assets[a].V0;
+			}
+		}
+		antithetic_spot = spot;
+		antithetic_volatility = volatility;
+
+		for (int j = 0; j < discretization; j++) {
+
+			// The lanes after the last path of a partial block keep zero draws
+			for (int d = 0; d < drivers; d++)
+				HestonWorker::drawNormals<double>(task.generator, &independent[d * BLOCK_PATHS], paths);
+			correlate(&independent[0], &correlated[0]);
+
+			for (int a = 0; a < assetsNumber; a++) {
+				BasketAsset const & asset = assets[a];
+				const double drift = (r - asset.dividend) * deltaT;
+				const double reversion = asset.kappa * deltaT;
+				const double* random_spot = &correlated[(2 * a) * BLOCK_PATHS];
+				const double* random_volatility = &correlated[(2 * a + 1) * BLOCK_PATHS];
+				double* S = &spot[a * BLOCK_PATHS];
+				double* V = &volatility[a * BLOCK_PATHS];
+				double* antithetic_S = &antithetic_spot[a * BLOCK_PATHS];
+				double* antithetic_V = &antithetic_volatility[a * BLOCK_PATHS];
+
+				for (int p = 0; p < BLOCK_PATHS; p++) {
+					double correct_volatility = std::max(V[p], 0.0);
+					double diffusion = sqrt(correct_volatility * deltaT);
+					V[p] += reversion * (asset.theta - correct_volatility) + asset.xi * diffusion * random_volatility[p];
+					S[p] *= exp(drift - 0.5 * correct_volatility * deltaT + diffusion * random_spot[p]);
+
+					correct_volatility = std::max(antithetic_V[p], 0.0);
+					diffusion = sqrt(correct_volatility * deltaT);
+					antithetic_V[p] += reversion * (asset.theta - correct_volatility) -
+						asset.xi * diffusion * random_volatility[p];
+					antithetic_S[p] *= exp(drift - 0.5 * correct_volatility * deltaT - diffusion * random_spot[p]);
+				}
+			}
+		}
+
+		for (int p = 0; p < paths; p++) {
+			for (size_t k = 0; k < payoffs.size(); k++) {
+				double value = payoffValue(payoffs[k], &spot[p]) + payoffValue(payoffs[k], &antithetic_spot[p]);
+				task.payoffSums[k].add(value);
+				task.payoffSquares[k].add(value * value);
+			}
+		}
+		task.done += paths;
+	}
+}
+
+/**
+ * Method used to compute the correlated draws of a block of paths: correlated = L * independent. The factor is
+ * lower triangular, so the row of a driver only reads the drivers before it, and every coefficient of the
+ * factor multiplies the BLOCK_PATHS contiguous draws of a driver at once
+ * @param independent	The independent normals, BLOCK_PATHS for every driver
+ * @param correlated	The correlated normals, BLOCK_PATHS for every driver
+ */
+void BasketEngine::correlate(const double* independent, double* correlated) {
+
+	const int drivers = 2 * (int) assets.size();
+	for (int i = 0; i < drivers; i++) {
+		const double* row = &cholesky[i * (i + 1) / 2];
+		double* out = correlated + i * BLOCK_PATHS;
+
+		for (int p = 0; p < BLOCK_PATHS; p++)
+			out[p] = 0.0;
+		for (int k = 0; k <= i; k++) {
+			const double coefficient = row[k];
+			const double* in = independent + k * BLOCK_PATHS;
+			for (int p = 0; p < BLOCK_PATHS; p++)
+				out[p] += coefficient * in[p];
+		}
+	}
+}
+
+/**
+ * Method used to compute the payoff of a terminal state
+ * @param payoff	The payoff to compute
+ * @param spots		The terminal spots, with a stride of BLOCK_PATHS between the assets
+ */
+double BasketEngine::payoffValue(BasketPayoff const & payoff, const double* spots) {
+
+	double underlying;
+	if (payoff.underlying == BASKET_SUM) {
+		underlying = 0.0;
+		for (size_t a = 0; a < assets.size(); a++)
+			underlying += assets[a].weight * spots[a * BLOCK_PATHS];
+	} else {
+		underlying = spots[0] / assets[0].S0;
+		for (size_t a = 1; a < assets.size(); a++) {
+			double performance = spots[a * BLOCK_PATHS] / assets[a].S0;
+			underlying = (payoff.underlying == BASKET_BEST) ? std::max(underlying, performance) :
+				std::min(underlying, performance);
+		}
+	}
+
+	return payoff.call ? std::max(underlying - payoff.K, 0.0) : std::max(payoff.K - underlying, 0.0);
+}
+
+/**
+ * Method used to write the prices of the payoffs in CSV
+ * @param output	The file where the results are written
+ */
+void BasketEngine::write(FILE* output) {
+
+	static const char* underlyings[] = { "basket", "best-of", "worst-of" };
+
+	fprintf(output, "name,type,K,price,stderr\n");
+	for (size_t k = 0; k < payoffs.size(); k++) {
+		BasketPayoff const & payoff = payoffs[k];
+		fprintf(output, "%s,%s-%s,%g,%.10g,%.6g\n", payoff.name.c_str(), underlyings[payoff.underlying],
+			payoff.call ? "call" : "put", payoff.K, payoff.price, payoff.standardError);
+	}
+	fflush(output);
+}
@@ -0,0 +1,212 @@
+/**
+ *       @file  ChunkScheduler.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The scheduling of the chunks of a run on the persistent workers. The tasks of the chunks are created
+ *		in the arena of the run and reused from a free list, a stopped chunk is queued and resumed by the next
+ *		idle worker, and a run cycle waits at most a slice of time for a completed chunk
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "ChunkScheduler.h"
+#include "StartupTimeline.h"
+
+/**
+ * The constructor of the ChunkScheduler class
+ * @param workers	The workers of the run, created by the owner of the scheduler
+ */
+ChunkScheduler::ChunkScheduler(std::vector<std::unique_ptr<HestonWorker> > & workers) : workers(workers) {
+	logger = NULL;
+	seed = 0;
+	simulations = 0;
+	chunkSimulations = 0;
+	discretization = 0;
+	chunksNumber = 0;
+	nextChunk = 0;
+	completedChunks = 0;
+	taskPool = NULL;
+}
+
+/**
+ * Method used to set the logger of the scheduling events (none by default)
+ * @param logger	The logger
+ */
+void ChunkScheduler::setLogger(bbque::utils::Logger* logger) {
+	this->logger = logger;
+}
+
+/**
+ * Method used to lay out the chunks of a run and to create their tasks in the arena of the run. The arena must
+ * have room for Arena::footprint<ChunkTask>(tasksNumber)
+ * @param arena			The arena of the run
+ * @param tasksNumber		The number of tasks, at least one for every worker and one for every stopped chunk
+ * @param simulations		The simulations of the run
+ * @param chunkSimulations	The simulations of every chunk
+ * @param seed			The seed of the substreams of the chunks
+ * @param discretization	The number of time steps of every path
+ */
+void ChunkScheduler::setup(Arena & arena, int tasksNumber, int simulations, int chunkSimulations, uint64_t seed,
+		int discretization) {
+	this->seed = seed;
+	this->simulations = simulations;
+	this->chunkSimulations = chunkSimulations;
+	this->discretization = discretization;
+	chunksNumber = (simulations + chunkSimulations - 1) / chunkSimulations;
+	nextChunk = 0;
+	completedChunks = 0;
+
+	// A task is either running on a worker or stopped and waiting to be resumed
+	taskPool = arena.create<ChunkTask>(tasksNumber);
+	freeTasks.clear();
+	resumeQueue.clear();
+	freeTasks.reserve(tasksNumber);
+	resumeQueue.reserve(tasksNumber);
+	for (int i = 0; i < tasksNumber; i++)
+		freeTasks.push_back(&taskPool[i]);
+}
+
+/**
+ * Method used to get the signal the workers use to wake up the run cycles when they complete a chunk
+ */
+CompletionSignal* ChunkScheduler::getCompletionSignal() {
+	return &completion;
+}
+
+/**
+ * Method used to do a run cycle on the first active workers: the completed chunks are collected, the idle workers
+ * start a chunk and the cycle waits at most sliceMs for a completed chunk. It returns false, without starting any
+ * chunk, when all the chunks are completed
+ * @param active	The number of workers of the assignment
+ * @param sliceMs	The maximum time of the cycle (in milliseconds)
+ */
+bool ChunkScheduler::cycle(int active, int sliceMs) {
+	collectCompletedWorkers();
+
+	if (completedChunks == chunksNumber)
+		return false;
+
+	startChunks(active);
+
+	if (completion.waitFor(sliceMs))
+		collectCompletedWorkers();
+	return true;
+}
+
+/**
+ * Method used to start a chunk on every idle worker of the assignment: the stopped chunks are resumed first,
+ * then the new ones are started
+ * @param active	The number of workers of the assignment
+ */
+void ChunkScheduler::startChunks(int active) {
+	for (int i = 0; i < active; i++) {
+		if (workers[i]->isStarted())
+			continue;
+
+		ChunkTask* task;
+		if (!resumeQueue.empty()) {
+			task = resumeQueue.front();
+			resumeQueue.erase(resumeQueue.begin());
+		} else if (nextChunk < chunksNumber) {
+			int remaining = simulations - nextChunk * chunkSimulations;
+			task = freeTasks.back();
+			freeTasks.pop_back();
+			task->reset(nextChunk, nextChunk * chunkSimulations,
+				(remaining < chunkSimulations) ? remaining : chunkSimulations, seed);
+			nextChunk++;
+		} else {
+			break;
+		}
+
+		workers[i]->start(task, discretization);
+	}
+	StartupTimeline::mark("first chunk");
+}
+
+/**
+ * Method used to join a worker and to collect its chunk. The result of a completed chunk has already been pushed
+ * to the aggregator, so only its task is released, while a stopped one is queued to be resumed (with its
+ * substream and its partial sum) by the next free worker. It returns true if the chunk is completed
+ * @param i		The index of the worker
+ */
+bool ChunkScheduler::collectWorker(int i) {
+
+	workers[i]->join();
+	workers[i]->clearProgress();
+
+	ChunkTask* task = workers[i]->getTask();
+	if (!task->completed()) {
+		if (logger)
+			logger->Notice("Worker %d stopped chunk %d at %d/%d simulations",
+				i, task->index, task->done, task->todo);
+		resumeQueue.push_back(task);
+		return false;
+	}
+
+	completedChunks++;
+	if (logger)
+		logger->Warn("Worker %d completed chunk %d", i, task->index);
+
+	freeTasks.push_back(task);
+	return true;
+}
+
+/**
+ * Method used to collect all the workers that have completed their chunk
+ */
+void ChunkScheduler::collectCompletedWorkers() {
+	for (int i = 0; i < (int) workers.size(); i++) {
+		if (workers[i]->isStarted() && !workers[i]->isRunning())
+			collectWorker(i);
+	}
+}
+
+/**
+ * Method used to read, without waiting, the progress of the chunks not completed yet: the ones published by the
+ * running workers and the ones stopped and waiting to be resumed
+ * @param done		The simulations done in the chunks not completed
+ * @param sum		The sum of the payoffs of those simulations
+ */
+void ChunkScheduler::collectProgress(int & done, double & sum) {
+	done = 0;
+	sum = 0.0;
+	for (int i = 0; i < (int) workers.size(); i++) {
+		// A finished worker has already pushed its chunk to the aggregator
+		if (!workers[i]->isRunning())
+			continue;
+		WorkerProgress progress = workers[i]->getProgress();
+		done += progress.done;
+		sum += progress.sum;
+	}
+	for (size_t i = 0; i < resumeQueue.size(); i++) {
+		done += resumeQueue[i]->done;
+		sum += resumeQueue[i]->sum.get();
+	}
+}
+
+/**
+ * Method used to get the number of the chunks of the run
+ */
+int ChunkScheduler::getChunksNumber() {
+	return chunksNumber;
+}
+
+/**
+ * Method used to get the number of the chunks started at least once
+ */
+int ChunkScheduler::getStartedChunks() {
+	return nextChunk;
+}
+
+/**
+ * Method used to get the number of the completed chunks
+ */
+int ChunkScheduler::getCompletedChunks() {
+	return completedChunks;
+}
@@ -0,0 +1,254 @@
+/**
+ *       @file  CosPricer.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The Fourier-cosine (COS) pricer of Fang and Oosterlee for the European options of the models of the
+ *		Heston family with constant parameters. The density of the log return at a maturity is expanded in
+ *		a cosine series from the characteristic function of the model, whose coefficients are computed once
+ *		for every maturity and parameter set and kept in a cache. A strike is then priced in O(N) by a
+ *		closed form integral of its payoff against the series, so a whole strike grid costs O(N K)
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "CosPricer.h"
+#include "HestonAnalytic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+const double CosPricer::RANGE = 10.0;
+const double CosPricer::TOLERANCE = 1e-12;
+
+/**
+ * The constructor of the CosPricer class
+ *
+ * @param V0		The initial volatility of the model
+ * @param rho		The Correlation Coefficient parameter of Heston model
+ * @param kappa		The mean reversion rate of the Heston Model
+ * @param theta		The long-term volatility value
+ * @param xi		The volatility of volatility (V0)
+ */
+CosPricer::CosPricer(double V0, double rho, double kappa, double theta, double xi) {
+	setParameters(V0, rho, kappa, theta, xi);
+	this->dividend = 0.0;
+	this->terms = DEFAULT_TERMS;
+}
+
+/**
+ * Method used to change the Heston parameters of the model, the coefficients already computed for the
+ * other parameters stay in the cache
+ * @param V0		The initial volatility of the model
+ * @param rho		The Correlation Coefficient parameter of Heston model
+ * @param kappa		The mean reversion rate of the Heston Model
+ * @param theta		The long-term volatility value
+ * @param xi		The volatility of volatility (V0)
+ */
+void CosPricer::setParameters(double V0, double rho, double kappa, double theta, double xi) {
+	this->V0 = V0;
+	this->rho = rho;
+	this->kappa = kappa;
+	this->theta = theta;
+	this->xi = xi;
+}
+
+/**
+ * Method used to select the model (Heston by default)
+ * @param model		The model and its parameters
+ */
+void CosPricer::setModel(ModelParameters const & model) {
+	this->model = model;
+}
+
+/**
+ * Method used to set the dividend yield (zero by default)
+ * @param dividend	The dividend yield
+ */
+void CosPricer::setDividendYield(double dividend) {
+	this->dividend = dividend;
+}
+
+/**
+ * Method used to set the minimum number of terms of the cosine series (DEFAULT_TERMS by default). It
+ * empties the cache
+ * @param terms		The number of terms, rounded up to a multiple of LANES (at most MAX_TERMS)
+ */
+void CosPricer::setTerms(int terms) {
+	this->terms = std::min(std::max((terms + LANES - 1) / LANES * LANES, LANES), MAX_TERMS);
+	cache.clear();
+}
+
+/**
+ * Method used to compute the price of a European option. The put is priced by the series and the call by
+ * the put-call parity, which is exact whatever the truncation of the range
+ * @param S0		The spot price of the option
+ * @param K		The strike price of the option
+ * @param r		The risk-free rate of the option
+ * @param T		The maturity time (in years) of the option
+ * @param call		True for a call, false for a put
+ */
+double CosPricer::price(double S0, double K, double r, double T, bool call) {
+	Coefficients const & c = coefficients(r, T);
+	double put = std::max(K * exp(-r * T) * unitPut(c, log(S0 / K)), 0.0);
+	if (!call)
+		return put;
+	return std::max(put + S0 * exp(-dividend * T) - K * exp(-r * T), 0.0);
+}
+
+/**
+ * Method used to compute the prices of a grid of strikes of the same maturity, with a single lookup of
+ * the coefficients
+ * @param S0		The spot price of the options
+ * @param r		The risk-free rate of the options
+ * @param T		The maturity time (in years) of the options
+ * @param strikes	The strike prices of the options
+ * @param call		True for calls, false for puts
+ * @param prices	The prices, resized to the number of strikes
+ */
+void CosPricer::price(double S0, double r, double T, std::vector<double> const & strikes, bool call,
+	std::vector<double> & prices) {
+
+	Coefficients const & c = coefficients(r, T);
+	double discount = exp(-r * T);
+	double forward = S0 * exp(-dividend * T);
+
+	prices.resize(strikes.size());
+	for (size_t i = 0; i < strikes.size(); i++) {
+		double K = strikes[i];
+		double put = std::max(K * discount * unitPut(c, log(S0 / K)), 0.0);
+		prices[i] = call ? std::max(put + forward - K * discount, 0.0) : put;
+	}
+}
+
+/**
+ * Method used to get the number of maturities and parameter sets in the cache
+ */
+int CosPricer::getCacheSize() const {
+	return (int) cache.size();
+}
+
+/**
+ * Method used to get the coefficients of a maturity for the current parameters, from the cache or
+ * computed and added to the cache. The range of the log return is the one of Fang and Oosterlee, centered
+ * on the mean and RANGE times sqrt(c2 + sqrt(c4)) wide on each side, with the cumulants of the log return
+ * from the logarithm of the characteristic function near 0
+ * @param r		The risk-free rate
+ * @param T		The maturity time (in years)
+ */
+CosPricer::Coefficients const & CosPricer::coefficients(double r, double T) {
+
+	double values[] = {r, dividend, T, V0, rho, kappa, theta, xi, (double) model.type, model.jumpIntensity,
+		model.jumpMean, model.jumpVolatility, model.V0, model.rho, model.kappa, model.theta, model.xi};
+	std::vector<double> key(values, values + sizeof(values) / sizeof(values[0]));
+
+	for (size_t i = 0; i < cache.size(); i++)
+		if (cache[i].key == key)
+			return cache[i];
+
+	if ((int) cache.size() == CACHE_SIZE)
+		cache.erase(cache.begin());
+
+	HestonAnalytic analytic(1.0, r, T, V0, rho, kappa, theta, xi);
+	analytic.setDividendYield(dividend);
+	analytic.setModel(model);
+
+	// The real part of the logarithm is -c2 u^2 / 2 + c4 u^4 / 24 + O(u^6): the values in h and 2h give c2
+	// and c4, the imaginary part c1 u + O(u^3) gives c1
+	const double h = 1e-2;
+	std::complex<double> near = std::log(analytic.characteristicFunction(h));
+	std::complex<double> far = std::log(analytic.characteristicFunction(2.0 * h));
+	double mean = (8.0 * near.imag() - far.imag()) / (6.0 * h);
+	double variance = std::max(-(16.0 * near.real() - far.real()) / (6.0 * h * h), 1e-12);
+	double kurtosis = std::max(2.0 * (far.real() - 4.0 * near.real()) / (h * h * h * h), 0.0);
+	double width = RANGE * sqrt(variance + sqrt(kurtosis));
+
+	Coefficients c;
+	c.key = key;
+	c.a = mean - width;
+	c.b = mean + width;
+	// The series is extended beyond the terms set, up to MAX_TERMS, while the characteristic function has
+	// not vanished (a wide range on a peaked density)
+	for (int k = 0; ; k += LANES) {
+		double tail = 0.0;
+		for (int j = k; j < k + LANES; j++) {
+			double u = j * M_PI / (c.b - c.a);
+			std::complex<double> phi = analytic.characteristicFunction(u);
+			tail = std::max(tail, std::abs(phi));
+			c.density.push_back(2.0 / (c.b - c.a) * (phi * std::exp(std::complex<double>(0.0, -u * c.a))).real());
+			c.frequency.push_back(u);
+			c.inverseFrequency.push_back(j > 0 ? 1.0 / u : 0.0);
+			c.damping.push_back(1.0 / (1.0 + u * u));
+		}
+		if (k + LANES >= MAX_TERMS || (k + LANES >= terms && tail < TOLERANCE))
+			break;
+	}
+	c.density[0] *= 0.5;
+
+	cache.push_back(c);
+	return cache.back();
+}
+
+/**
+ * Method used to compute the undiscounted price of a put of unit strike with log-moneyness x = ln(S0/K). The
+ * put pays 1 - exp(x + y) for a log return y below -x, so its price is the sum over k of the density
+ * coefficients times
+ *	psi_k - exp(x) chi_k,	psi_k = sin(u_k (d - a)) / u_k,
+ *				chi_k = (exp(d) (cos(u_k (d - a)) + u_k sin(u_k (d - a))) - exp(a)) / (1 + u_k^2)
+ * with d = min(-x, b). The angles u_k (d - a) grow by the same step, so the cosines and the sines of LANES
+ * consecutive terms are rotated together by LANES steps, with no trigonometric call in the loop
+ * @param c		The coefficients of the maturity
+ * @param x		The log-moneyness of the put
+ */
+double CosPricer::unitPut(Coefficients const & c, double x) const {
+
+	double d = std::min(-x, c.b);
+	if (d <= c.a)
+		return 0.0;
+
+	double step = M_PI * (d - c.a) / (c.b - c.a);
+	double rotationCos = cos(LANES * step);
+	double rotationSin = sin(LANES * step);
+	double expD = exp(d);
+	double expA = exp(c.a);
+	double expX = exp(x);
+
+	double cosines[LANES];
+	double sines[LANES];
+	double sums[LANES];
+	for (int j = 0; j < LANES; j++) {
+		cosines[j] = cos(j * step);
+		sines[j] = sin(j * step);
+		sums[j] = 0.0;
+	}
+
+	const double* density = &c.density[0];
+	const double* frequency = &c.frequency[0];
+	const double* inverseFrequency = &c.inverseFrequency[0];
+	const double* damping = &c.damping[0];
+
+	int n = (int) c.density.size();
+	for (int k = 0; k < n; k += LANES) {
+		for (int j = 0; j < LANES; j++) {
+			double psi = sines[j] * inverseFrequency[k + j];
+			double chi = (expD * (cosines[j] + frequency[k + j] * sines[j]) - expA) * damping[k + j];
+			sums[j] += density[k + j] * (psi - expX * chi);
+
+			double rotated = cosines[j] * rotationCos - sines[j] * rotationSin;
+			sines[j] = cosines[j] * rotationSin + sines[j] * rotationCos;
+			cosines[j] = rotated;
+		}
+	}
+
+	// The term k = 0 has psi_0 = d - a
+	double sum = density[0] * (d - c.a);
+	for (int j = 0; j < LANES; j++)
+		sum += sums[j];
+	return sum;
+}
@@ -0,0 +1,173 @@
+/**
+ *       @file  CpuTopology.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: This class describes the processors that the BarbequeRTRM assigned to our application. The set of
+ *		CPUs is read from the affinity mask of the process (the RTRM writes it through the cpuset cgroup),
+ *		while the NUMA node and the core of each CPU are read from sysfs. It is used to pin every worker on
+ *		its own CPU and to keep the memory of the worker on the same NUMA node
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "CpuTopology.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+#include <sched.h>
+#include <dirent.h>
+
+/**
+ * The constructor of the CpuTopology class, it reads immediately the assigned CPUs
+ */
+CpuTopology::CpuTopology() {
+	update();
+}
+
+/**
+ * Method used to read again the CPUs assigned to the application. It must be called every time the
+ * BarbequeRTRM reconfigures the application, since the cpuset can be changed.
+ * The CPUs are sorted by NUMA node and then by core, so that the first CPUs of the list are on the same
+ * node and on different physical cores
+ */
+void CpuTopology::update() {
+
+	cpus.clear();
+
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &mask))
+				cpus.push_back(cpu);
+	}
+
+	// Map every CPU on its NUMA node, a system without the node directory is a single node system
+	nodes.assign(cpus.empty() ? 0 : cpus.back() + 1, 0);
+	DIR* dir = opendir("/sys/devices/system/node");
+	if (dir) {
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != NULL) {
+			int node;
+			if (sscanf(entry->d_name, "node%d", &node) != 1)
+				continue;
+
+			char path[128];
+			snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+			std::vector<int> nodeCpus = readCpuList(path);
+			for (size_t i = 0; i < nodeCpus.size(); i++)
+				if (nodeCpus[i] < (int) nodes.size())
+					nodes[nodeCpus[i]] = node;
+		}
+		closedir(dir);
+	}
+
+	// A CPU is a secondary hardware thread if it is not the first sibling of its core
+	std::vector<int> secondary(nodes.size(), 0);
+	for (size_t i = 0; i < cpus.size(); i++) {
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpus[i]);
+		std::vector<int> siblings = readCpuList(path);
+		if (!siblings.empty() && siblings.front() != cpus[i])
+			secondary[cpus[i]] = 1;
+	}
+
+	std::vector<int> const & nodeOf = nodes;
+	std::stable_sort(cpus.begin(), cpus.end(), [&nodeOf, &secondary](int a, int b) {
+		if (nodeOf[a] != nodeOf[b])
+			return nodeOf[a] < nodeOf[b];
+		return secondary[a] < secondary[b];
+	});
+
+	std::set<int> usedNodes;
+	for (size_t i = 0; i < cpus.size(); i++)
+		usedNodes.insert(nodes[cpus[i]]);
+	nodesNumber = usedNodes.empty() ? 1 : (int) usedNodes.size();
+}
+
+/**
+ * Method used to get the number of the CPUs assigned to the application
+ */
+int CpuTopology::getCpusNumber() {
+	return (int) cpus.size();
+}
+
+/**
+ * Method used to get the i-th CPU to use
+ * @param i	The index of the CPU (it wraps around if it is greater than the number of CPUs)
+ */
+int CpuTopology::getCpu(int i) {
+	if (cpus.empty())
+		return -1;
+	return cpus[i % cpus.size()];
+}
+
+/**
+ * Method used to get the NUMA node of a CPU
+ * @param cpu	The CPU identifier
+ */
+int CpuTopology::getNode(int cpu) {
+	if (cpu < 0 || cpu >= (int) nodes.size())
+		return 0;
+	return nodes[cpu];
+}
+
+/**
+ * Method used to get the number of NUMA nodes used by the assigned CPUs
+ */
+int CpuTopology::getNodesNumber() {
+	return nodesNumber;
+}
+
+/**
+ * Method used to pin the calling thread on a CPU
+ * @param cpu	The CPU identifier, a negative value does nothing
+ */
+bool CpuTopology::pinCurrentThread(int cpu) {
+	if (cpu < 0)
+		return false;
+
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	CPU_SET(cpu, &mask);
+	return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+}
+
+/**
+ * Method used to read a sysfs list of CPUs (e.g. "0-3,8,10-11")
+ * @param path	The path of the file to read
+ */
+std::vector<int> CpuTopology::readCpuList(const char* path) {
+	std::vector<int> list;
+
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return list;
+
+	int first, last;
+	char separator;
+	while (fscanf(file, "%d", &first) == 1) {
+		last = first;
+		separator = (char) fgetc(file);
+		if (separator == '-') {
+			if (fscanf(file, "%d", &last) != 1)
+				break;
+			separator = (char) fgetc(file);
+		}
+		for (int cpu = first; cpu <= last; cpu++)
+			list.push_back(cpu);
+		if (separator != ',')
+			break;
+	}
+
+	fclose(file);
+	return list;
+}
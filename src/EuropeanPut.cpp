@@ -14,6 +14,9 @@
  * =====================================================================================
  */
 #include "EuropeanPut.h"
+#include "CosPricer.h"
+
+#include <cmath>
 
 /**
  * The constructor of an European Put option, it used the constructor of the Option base class
@@ -37,3 +40,40 @@ double EuropeanPut::optionCalculator(double S)
         return K - S;
     return 0.0;
 }
+
+/**
+ * The European payoff has the Black-Scholes closed form, so the conditional calculator is available
+ */
+bool EuropeanPut::hasConditionalCalculator() {
+    return true;
+}
+
+/**
+ * Method used to compute the undiscounted Black-Scholes price given the forward and the total variance
+ * @param forward		The forward price of the terminal spot
+ * @param totalVariance	The total variance of the log of the terminal spot
+ */
+double EuropeanPut::conditionalCalculator(double forward, double totalVariance) {
+    if (totalVariance <= 0.0)
+        return optionCalculator(forward);
+
+    double stdDev = sqrt(totalVariance);
+    double d1 = (log(forward / K) + 0.5 * totalVariance) / stdDev;
+    double d2 = d1 - stdDev;
+    return K * normalCDF(-d2) - forward * normalCDF(-d1);
+}
+
+/**
+ * The European payoff is priced by the COS method
+ */
+bool EuropeanPut::hasFourierCalculator() {
+    return true;
+}
+
+/**
+ * Method used to compute the price of the option with the COS method
+ * @param pricer		The COS pricer of the model
+ */
+double EuropeanPut::fourierCalculator(CosPricer & pricer) {
+    return pricer.price(S0, K, r, T, false);
+}
@@ -0,0 +1,204 @@
+/**
+ *       @file  HestonAnalytic.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The semi-analytic prices of the models of the Heston family with constant parameters. The
+ *		characteristic function of the log spot is in closed form (the formulation of Albrecher et al., which
+ *		is continuous in the complex plane), and the price of a vanilla option is the Gil-Pelaez inversion
+ *		of it, integrated by Gauss-Legendre panels until the integrand vanishes. It is the reference of the
+ *		Monte Carlo engine
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "HestonAnalytic.h"
+
+#include <cmath>
+
+namespace {
+
+/**
+ * The nodes and the weights of the 8 points Gauss-Legendre rule on [-1, 1]
+ */
+const int GAUSS_POINTS = 8;
+const double GAUSS_NODES[GAUSS_POINTS] = {
+	-0.960289856497536232, -0.796666477413626740, -0.525532409916328986, -0.183434642495649805,
+	0.183434642495649805, 0.525532409916328986, 0.796666477413626740, 0.960289856497536232
+};
+const double GAUSS_WEIGHTS[GAUSS_POINTS] = {
+	0.101228536290376259, 0.222381034453374471, 0.313706645877887287, 0.362683783378361983,
+	0.362683783378361983, 0.313706645877887287, 0.222381034453374471, 0.101228536290376259
+};
+
+/**
+ * The contribution of a panel below which the integrand has vanished
+ */
+const double TOLERANCE = 1e-14;
+
+}
+
+const double HestonAnalytic::PANEL = 2.0;
+const double HestonAnalytic::LIMIT = 4000.0;
+
+/**
+ * The constructor of the HestonAnalytic class
+ *
+ * @param S0		The spot price of the option
+ * @param r		The risk-free rate of the option
+ * @param T		The maturity time of the option (in years)
+ * @param V0		The initial volatility of the option
+ * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+ * @param kappa		The mean reversion rate of the Heston Model for the considered option
+ * @param theta		The long-term volatility value
+ * @param xi		The volatility of volatility (V0)
+ */
+HestonAnalytic::HestonAnalytic(double S0, double r, double T, double V0, double rho, double kappa, double theta,
+	double xi) : S0(S0), r(r), T(T), dividend(0.0), V0(V0), rho(rho), kappa(kappa), theta(theta), xi(xi) {
+}
+
+/**
+ * Method used to set the dividend yield (zero by default)
+ * @param dividend	The dividend yield
+ */
+void HestonAnalytic::setDividendYield(double dividend) {
+	this->dividend = dividend;
+}
+
+/**
+ * Method used to select the model (Heston by default)
+ * @param model		The model and its parameters
+ */
+void HestonAnalytic::setModel(ModelParameters const & model) {
+	this->model = model;
+}
+
+/**
+ * Method used to compute the logarithm of the characteristic function of a variance factor, without the
+ * drift of the spot. A factor without volatility has a deterministic integrated variance
+ * @param u		The argument
+ * @param V0		The initial variance of the factor
+ * @param rho		The correlation of the factor with its spot driver
+ * @param kappa		The mean reversion rate of the factor
+ * @param theta		The long-term variance of the factor
+ * @param xi		The volatility of the variance of the factor
+ */
+std::complex<double> HestonAnalytic::factorExponent(std::complex<double> u, double V0, double rho, double kappa,
+	double theta, double xi) const {
+
+	const std::complex<double> i(0.0, 1.0);
+	std::complex<double> iu = i * u;
+
+	if (xi <= 0.0) {
+		double decay = kappa > 0.0 ? (1.0 - exp(-kappa * T)) / kappa : T;
+		double variance = theta * (T - decay) + V0 * decay;
+		return -0.5 * (iu + u * u) * variance;
+	}
+
+	double xi2 = xi * xi;
+	std::complex<double> b = kappa - rho * xi * iu;
+	std::complex<double> d = std::sqrt(b * b + xi2 * (iu + u * u));
+	std::complex<double> g = (b - d) / (b + d);
+	std::complex<double> e = std::exp(-d * T);
+
+	std::complex<double> C = kappa * theta / xi2 * ((b - d) * T - 2.0 * std::log((1.0 - g * e) / (1.0 - g)));
+	std::complex<double> D = (b - d) / xi2 * (1.0 - e) / (1.0 - g * e);
+	return C + D * V0;
+}
+
+/**
+ * Method used to compute the characteristic function E[exp(i u ln(S_T))] of the log spot at the maturity,
+ * for a complex argument
+ * @param u		The argument
+ */
+std::complex<double> HestonAnalytic::characteristicFunction(std::complex<double> u) const {
+
+	const std::complex<double> i(0.0, 1.0);
+	std::complex<double> iu = i * u;
+
+	std::complex<double> exponent = iu * (log(S0) + (r - dividend) * T) +
+		factorExponent(u, V0, rho, kappa, theta, xi);
+
+	if (model.type == MODEL_DOUBLE_HESTON)
+		exponent += factorExponent(u, model.V0, model.rho, model.kappa, model.theta, model.xi);
+
+	if (model.type == MODEL_BATES) {
+		double s2 = model.jumpVolatility * model.jumpVolatility;
+		std::complex<double> jump = std::exp(iu * model.jumpMean - 0.5 * s2 * u * u) - 1.0;
+		exponent += model.jumpIntensity * T * jump - iu * model.jumpCompensator() * T;
+	}
+
+	return std::exp(exponent);
+}
+
+/**
+ * Method used to compute the price of a vanilla option. The call is S exp(-qT) P1 - K exp(-rT) P2, with the
+ * probabilities of the exercise under the stock and the bank account measures
+ *	P1 = 1/2 + 1/pi int Re[exp(-iu ln K) phi(u - i) / (iu phi(-i))] du
+ *	P2 = 1/2 + 1/pi int Re[exp(-iu ln K) phi(u) / (iu)] du
+ * and the put follows by the put-call parity
+ * @param K		The strike price of the option
+ * @param call		True for a call, false for a put
+ */
+double HestonAnalytic::price(double K, bool call) const {
+
+	const std::complex<double> i(0.0, 1.0);
+	double logStrike = log(K);
+	double forward = getForward();
+
+	double P1 = 0.0;
+	double P2 = 0.0;
+	for (double a = 0.0; a < LIMIT; a += PANEL) {
+		double panel1 = 0.0;
+		double panel2 = 0.0;
+		for (int k = 0; k < GAUSS_POINTS; k++) {
+			double u = a + 0.5 * PANEL * (GAUSS_NODES[k] + 1.0);
+			std::complex<double> kernel = std::exp(-i * u * logStrike) / (i * u);
+			panel1 += GAUSS_WEIGHTS[k] * std::real(kernel * characteristicFunction(u - i)) / forward;
+			panel2 += GAUSS_WEIGHTS[k] * std::real(kernel * characteristicFunction(u));
+		}
+		P1 += 0.5 * PANEL * panel1;
+		P2 += 0.5 * PANEL * panel2;
+		if (fabs(panel1) + fabs(panel2) < TOLERANCE)
+			break;
+	}
+	P1 = 0.5 + P1 / M_PI;
+	P2 = 0.5 + P2 / M_PI;
+
+	double discount = getDiscount();
+	double value = S0 * exp(-dividend * T) * P1 - K * discount * P2;
+	return call ? value : value - S0 * exp(-dividend * T) + K * discount;
+}
+
+/**
+ * Method used to get the maturity of the model
+ */
+double HestonAnalytic::getMaturity() const {
+	return T;
+}
+
+/**
+ * Method used to get the spot price of the model
+ */
+double HestonAnalytic::getSpotPrice() const {
+	return S0;
+}
+
+/**
+ * Method used to get the forward of the spot at the maturity
+ */
+double HestonAnalytic::getForward() const {
+	return S0 * exp((r - dividend) * T);
+}
+
+/**
+ * Method used to get the discount factor at the maturity
+ */
+double HestonAnalytic::getDiscount() const {
+	return exp(-r * T);
+}
@@ -18,6 +18,8 @@
 
 
 #include "HestonFive_exc.h"
+#include "InverseNormal.h"
+#include "StartupTimeline.h"
 
 #include <cstdio>
 #include <bbque/utils/utility.h>
@@ -44,7 +46,7 @@ HestonFive::HestonFive(std::string const & name,
 		std::string const & recipe,
 		RTLIB_Services_t *rtlib, double S0, double K, double r, double T, double V0, double rho, double kappa, double theta, double xi,
 		int todo_simulations, int discretization) :
-	BbqueEXC(name, recipe, rtlib) {
+	BbqueEXC(name, recipe, rtlib), scheduler(workers) {
 
 	logger->Warn("New HestonFive::HestonFive()");
 
@@ -75,10 +77,19 @@ HestonFive::HestonFive(std::string const & name,
 	this->doneSimulations = 0;
 	
 	this->correctValueIsKnown = false;
+	this->mixing = false;
+	this->richardson = false;
+	this->singlePrecision = false;
+	this->fastStart = false;
 	
-	this->pricesToCompute = (int) (todo_simulations / WORKERS_SIM);
-	this->computedPrices = new double[pricesToCompute];
-	this->computedPricesIndex = 0;	
+	this->chunkSimulations = WORKERS_SIM;
+	this->seed = 0;
+	this->pathStoreSingle = false;
+
+	this->terms.rate = TermStructure(r);
+	this->terms.kappa = TermStructure(kappa);
+	this->terms.theta = TermStructure(theta);
+	this->terms.xi = TermStructure(xi);
 
 	std::cout << std::endl;
 
@@ -106,6 +117,59 @@ void HestonFive::setCorrectValue(double correctValue) {
 	this->correctValueIsKnown = true;
 }
 
+void HestonFive::setMixingMode(bool mixing) {
+	this->mixing = mixing;
+}
+
+void HestonFive::setSinglePrecision(bool singlePrecision) {
+	this->singlePrecision = singlePrecision;
+}
+
+void HestonFive::setSeed(uint64_t seed) {
+	this->seed = seed;
+}
+
+void HestonFive::setChunkSize(int chunkSimulations) {
+	if (chunkSimulations < PUBLISH_CHUNK_MIN) {
+		std::cout << "Chunk size lower than allowed. Minimum is: " << PUBLISH_CHUNK_MIN << std::endl;
+		chunkSimulations = PUBLISH_CHUNK_MIN;
+	}
+	this->chunkSimulations = chunkSimulations;
+}
+
+void HestonFive::setMetricsFile(std::string const & metricsFile) {
+	this->metricsFile = metricsFile;
+}
+
+void HestonFive::setPathStore(std::string const & pathStoreFile, bool singlePrecision) {
+	this->pathStoreFile = pathStoreFile;
+	this->pathStoreSingle = singlePrecision;
+}
+
+void HestonFive::setTerms(HestonTerms const & terms) {
+	this->terms = terms;
+}
+
+void HestonFive::setModel(ModelParameters const & model) {
+	this->modelParameters = model;
+}
+
+void HestonFive::setTimeGrid(TimeGrid const & grid) {
+	this->timeGrid = grid;
+}
+
+void HestonFive::setRichardson(bool richardson) {
+	this->richardson = richardson;
+}
+
+void HestonFive::setJournal(std::string const & journalFile) {
+	this->journalFile = journalFile;
+}
+
+void HestonFive::setFastStart(bool fastStart) {
+	this->fastStart = fastStart;
+}
+
 /**
  * Method used to do all the Setup operations
  */
@@ -116,7 +180,10 @@ RTLIB_ExitCode_t HestonFive::onSetup() {
 	// acquire system resources (e.g. thread creation)
 	logger->Warn("HestonFive::onSetup()");
 	
-	workersFinalSum = 0.0;
+	threadFinalPrice = 0.0;
+	discount = exp(-terms.rate.integral(0.0, T));
+	monitoredChunks = 0;
+	lastMonitor = std::chrono::steady_clock::now();
 
 	/**
 	 * @brief Number of max processor in the computer
@@ -126,18 +193,135 @@ RTLIB_ExitCode_t HestonFive::onSetup() {
 
 
 	/**
-	 * @brief Create the workers with the NUM_PROC variables
+	 * @brief Reserve the workers with the NUM_PROC variables, they are created by the configurations
 	 */	
-	workers = new HestonWorker*[cpuNumber]; 	
+	workers.clear();
+	workers.reserve(cpuNumber);
+	workersNumber = 0;
+	int tasksNumber = 2 * cpuNumber;
+	arena.reserve(Arena::footprint<ProgressSlot>(cpuNumber) + Arena::footprint<ChunkTask>(tasksNumber), 2);
+	progressSlots = arena.create<ProgressSlot>(cpuNumber);
+
+	// Every chunk has its own random substream and result: the final price is reduced in the order of the
+	// chunks, so it does not depend on the number of workers nor on the reconfigurations
+	if (seed == 0) {
+		std::random_device device;
+		seed = ((uint64_t) device() << 32) | device();
+	}
+	logger->Notice("HestonFive::onSetup(): seed %llu, chunks of %d simulations",
+		(unsigned long long) seed, chunkSimulations);
+
+	// A task is either running on a worker or stopped and waiting to be resumed
+	scheduler.setLogger(logger.get());
+	scheduler.setup(arena, tasksNumber, todo_simulations, chunkSimulations, seed, discretization);
+	chunksNumber = scheduler.getChunksNumber();
+
+	// The workers push the results of their chunks in their rings, and the aggregator thread consumes them
+	// while the workers go on with the next chunks
+	aggregator.reset(new ResultAggregator(cpuNumber, chunksNumber, discount));
+	aggregator->setMetricsFile(metricsFile);
+
+	// The journal starts with all the inputs needed to replay a chunk, the chunks are recorded by the
+	// aggregator thread
+	if (!journalFile.empty()) {
+		if (journal.open(journalFile)) {
+			JournalInputs inputs = JournalInputs();
+			inputs.S0 = S0;
+			inputs.K = K;
+			inputs.r = r;
+			inputs.T = T;
+			inputs.V0 = V0;
+			inputs.rho = rho;
+			inputs.kappa = kappa;
+			inputs.theta = theta;
+			inputs.xi = xi;
+			inputs.seed = seed;
+			inputs.simulations = todo_simulations;
+			inputs.discretization = discretization;
+			inputs.chunkSimulations = chunkSimulations;
+			inputs.mixing = mixing;
+			inputs.richardson = richardson;
+			inputs.singlePrecision = singlePrecision;
+			inputs.inverseNormal = InverseNormal::getTier();
+			inputs.model = modelParameters.type;
+			inputs.jumpIntensity = modelParameters.jumpIntensity;
+			inputs.jumpMean = modelParameters.jumpMean;
+			inputs.jumpVolatility = modelParameters.jumpVolatility;
+			inputs.V02 = modelParameters.V0;
+			inputs.rho2 = modelParameters.rho;
+			inputs.kappa2 = modelParameters.kappa;
+			inputs.theta2 = modelParameters.theta;
+			inputs.xi2 = modelParameters.xi;
+			journal.append(JOURNAL_INPUTS, inputs);
+
+			std::string curves = terms.rate.format() + "\n" + terms.dividend.format() + "\n" +
+				terms.kappa.format() + "\n" + terms.theta.format() + "\n" + terms.xi.format() + "\n" +
+				timeGrid.format();
+			journal.append(JOURNAL_CURVES, curves.data(), curves.size());
+			aggregator->setJournal(&journal);
+		} else {
+			logger->Error("HestonFive::onSetup(): unable to create the journal %s", journalFile.c_str());
+		}
+	}
+	aggregator->start();
+
+	// Every simulation writes its two paths (the antithetic one too) in the store
+	storePaths = false;
+	if (!pathStoreFile.empty() && mixing) {
+		logger->Warn("HestonFive::onSetup(): the mixing mode does not simulate the spot, paths not stored");
+	} else if (!pathStoreFile.empty() && !timeGrid.isUniform()) {
+		logger->Warn("HestonFive::onSetup(): the store has uniform steps, paths of a concentrated grid not stored");
+	} else if (!pathStoreFile.empty()) {
+		PathStoreHeader model = PathStoreHeader();
+		model.S0 = S0;
+		model.r = r;
+		model.T = T;
+		model.V0 = V0;
+		model.rho = rho;
+		model.kappa = kappa;
+		model.theta = theta;
+		model.xi = xi;
+		model.discount = discount;
+		model.forward = S0 * exp(terms.rate.integral(0.0, T) - terms.dividend.integral(0.0, T));
+		storePaths = pathStore.create(pathStoreFile, 2 * (uint64_t) todo_simulations, discretization,
+			pathStoreSingle, model);
+		if (!storePaths)
+			logger->Error("HestonFive::onSetup(): unable to create the path store %s", pathStoreFile.c_str());
+	}
 
-	for(int i=0;i<cpuNumber; i++){
-		logger->Warn("Creating new worker"); 
-		workers[i] = new HestonWorker( S0, K, r, T, V0, rho, kappa, theta, xi);
+	// The first chunk runs on one worker while the BarbequeRTRM assigns the resources
+	if (fastStart) {
+		workersNumber = 1;
+		createWorkers(workersNumber);
+		scheduler.startChunks(workersNumber);
 	}
-	
+
+	StartupTimeline::mark("setup");
 	return RTLIB_OK;
 }
 
+/**
+ * Method used to create the workers up to the given number. The workers are created when a configuration needs
+ * them, and a new worker allocates its local state and its thread at its first chunk
+ * @param number	The number of workers needed
+ */
+void HestonFive::createWorkers(int number) {
+	for (int i = (int) workers.size(); i < number; i++) {
+		logger->Warn("Creating new worker"); 
+		workers.emplace_back(new HestonWorker( S0, K, r, T, V0, rho, kappa, theta, xi));
+		workers[i]->setMixingMode(mixing);
+		workers[i]->setSinglePrecision(singlePrecision);
+		workers[i]->setProgressSlot(&progressSlots[i]);
+		workers[i]->setCompletionSignal(scheduler.getCompletionSignal());
+		workers[i]->setPathStore(storePaths ? &pathStore : NULL);
+		workers[i]->setTerms(terms);
+		workers[i]->setModel(modelParameters);
+		workers[i]->setTimeGrid(timeGrid);
+		workers[i]->setRefinement(richardson ? -1.0 : 0.0, richardson ? 2.0 : 0.0);
+		workers[i]->setResultRing(aggregator->getRing(i), aggregator->getSignal());
+	}
+}
+
 /**
  * Method used to do all the Configure operations. Every time the BarbequeRTRM changes the resources assigned to this application,
  * Resource Manager calls this method to reconfigure the application
@@ -156,46 +340,68 @@ RTLIB_ExitCode_t HestonFive::onConfigure(int8_t awm_id) {
 		exc_name.c_str(), awm_id, proc_quota, proc_nr, mem);
 
 	workersNumber = proc_nr;
+	if (workersNumber > cpuNumber)
+		workersNumber = cpuNumber;
+	if (workersNumber < 1)
+		workersNumber = 1;
+
+	createWorkers(workersNumber);
+
+	// The workers are not joined at the end of onRun(), so the ones out of the new
+	// assignment are still running: stop them now, keeping their partial results
+	for (int i = workersNumber; i < (int) workers.size(); i++) {
+		if (workers[i]->isStarted()) {
+			workers[i]->stop();
+			scheduler.collectWorker(i);
+		}
+	}
+
+	METRICS_TRACE("hestonfive: configure awm %d workers %d", awm_id, workersNumber);
 
+	// The RTRM can change the cpuset at every reconfiguration: pin again every worker on the
+	// assigned CPUs, filling a NUMA node before moving on the next one
+	topology.update();
+	logger->Notice("HestonFive::onConfigure(): %d CPUs assigned on %d NUMA nodes",
+		topology.getCpusNumber(), topology.getNodesNumber());
+
+	for (int i = 0; i < workersNumber; i++) {
+		int cpu = topology.getCpu(i);
+		workers[i]->setCpu(cpu, topology.getNode(cpu));
+		logger->Debug("HestonFive::onConfigure(): worker %d => CPU %d (node %d)",
+			i, cpu, topology.getNode(cpu));
+	}
+
+	JournalConfigure configure = JournalConfigure();
+	configure.seconds = journal.elapsed();
+	configure.awm = awm_id;
+	configure.workers = workersNumber;
+	configure.cpus = topology.getCpusNumber();
+	configure.nodes = topology.getNodesNumber();
+	journal.append(JOURNAL_CONFIGURE, configure);
+
+	StartupTimeline::mark("configured");
 	return RTLIB_OK;
 }
 
 /**
- * Method used to start the computation of an Option price after our app is configured correctly in onCofigure() method
+ * Method used to start the computation of an Option price after our app is configured correctly in onCofigure() method.
+ * The workers are started with a chunk of simulations and they keep running across the cycles: every cycle waits at
+ * most RUN_SLICE_MS for a completed chunk, in this way the control returns quickly to the RTLib and a new
+ * configuration is applied without waiting for the whole chunk
  */
 RTLIB_ExitCode_t HestonFive::onRun() {
 	RTLIB_WorkingModeParams_t const wmp = WorkingModeParams();
 
-	// Return when all the simulations are done
-	if (doneSimulations >= todo_simulations){
-		
-		return RTLIB_EXC_WORKLOAD_NONE;
-	}
-
-	if(doneSimulations + workersNumber * WORKERS_SIM > todo_simulations) {
-		workersNumber = (todo_simulations - doneSimulations) / WORKERS_SIM;
-		if(workersNumber == 0)
-			workersNumber = 1;
-	}
+	// Return when all the chunks are done
+	if (!scheduler.cycle(workersNumber, RUN_SLICE_MS)) {
 
-	for(int i = 0; i < workersNumber; i++){
-		workers[i]->start(WORKERS_SIM, discretization);
-	}
-	
-	for(int i = 0; i < workersNumber; i++){
-		workers[i]->join();
-		doneSimulations += WORKERS_SIM;
-		double temp =  ( ( workers[i]->getCalculus() / (double) ( WORKERS_SIM * 2)) * exp( -(r) * (T) ) );
-		logger->Warn("Worker %d computed price: %f ", i, temp );
-
-		workersFinalSum += workers[i]->getCalculus();
-		computedPrices[computedPricesIndex] = temp;
-		computedPricesIndex++;
+		return RTLIB_EXC_WORKLOAD_NONE;
 	}
 
 	// Do one more cycle
-	logger->Warn("HestonFive::onRun()      : EXC [%s]  @ AWM [%02d]",
-		exc_name.c_str(), wmp.awm_id);
+	if (scheduler.getCompletedChunks() != monitoredChunks)
+		logger->Warn("HestonFive::onRun()      : EXC [%s]  @ AWM [%02d]",
+			exc_name.c_str(), wmp.awm_id);
 
 	return RTLIB_OK;
 }
@@ -206,11 +412,31 @@ RTLIB_ExitCode_t HestonFive::onRun() {
 RTLIB_ExitCode_t HestonFive::onMonitor() {
 	RTLIB_WorkingModeParams_t const wmp = WorkingModeParams();
 
+	// The cycles are short: print the partial result only when a chunk is completed or periodically
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (scheduler.getCompletedChunks() == monitoredChunks &&
+			now - lastMonitor < std::chrono::milliseconds(MONITOR_PERIOD_MS))
+		return RTLIB_OK;
+	monitoredChunks = scheduler.getCompletedChunks();
+	lastMonitor = now;
+
 	logger->Warn("HestonFive::onMonitor()  : EXC [%s]  @ AWM [%02d], Cycle [%4d]",
 		exc_name.c_str(), wmp.awm_id, Cycles());
 
-	threadFinalPrice = ( ( workersFinalSum / (double) ((doneSimulations * 2))) * exp( -(r) * (T) ) );
+	// The completed chunks are in the statistics of the aggregator, while the workers still running publish
+	// their partial results: read both without waiting
+	AggregateSnapshot completed = aggregator->getSnapshot();
+	int runningDone;
+	double runningSum;
+	scheduler.collectProgress(runningDone, runningSum);
+
+	if (completed.simulations + runningDone == 0)
+		return RTLIB_OK;
+
+	threadFinalPrice = ( ( (completed.sum + runningSum) / (double) (((completed.simulations + runningDone) * 2))) * discount );
 	logger->Warn("ON_MONITOR: Price updated: %f", threadFinalPrice);
+	if (completed.chunks > 1)
+		logger->Warn("ON_MONITOR: Standard error: %f (%d chunks)", completed.standardError, completed.chunks);
 	if(correctValueIsKnown) {
 		double error;
 		if(threadFinalPrice > correctValue) 
@@ -221,6 +447,7 @@ RTLIB_ExitCode_t HestonFive::onMonitor() {
 		logger->Warn("ON_MONITOR: Correct Value: %f", correctValue);
 		logger->Warn("ON_MONITOR: Error: %f", error);
 	}
+
 	return RTLIB_OK;
 }
 
@@ -230,24 +457,70 @@ RTLIB_ExitCode_t HestonFive::onMonitor() {
 RTLIB_ExitCode_t HestonFive::onRelease() {
 
 	logger->Warn("HestonFive::onRelease()  : exit");
+
+	// Stop the workers still running, their partial results are kept
+	for (int i = 0; i < (int) workers.size(); i++) {
+		if (workers[i]->isStarted()) {
+			workers[i]->stop();
+			scheduler.collectWorker(i);
+		}
+	}
 	
+	// All the pushed results are consumed before the aggregator stops
+	aggregator->stop();
+	chunkSums = aggregator->getChunkSums();
+	chunkDone = aggregator->getChunkDone();
+	doneSimulations = aggregator->getSnapshot().simulations;
+	for (int i = 0; i < (int) workers.size(); i++)
+		aggregator->setWorkerMetrics(i, workers[i]->getMetrics());
+
+	// The final price is the pairwise sum of the chunks in their order, so it is reproducible with the same
+	// seed whatever the number of workers
+	std::vector<double> chunkPrices;
+	for (int i = 0; i < chunksNumber; i++)
+		if (chunkDone[i] > 0)
+			chunkPrices.push_back(chunkSums[i] / (double) (chunkDone[i] * 2) * discount);
+
+	if (doneSimulations > 0) {
+		threadFinalPrice = PairwiseSum::sum(&chunkSums[0], chunksNumber) / (double) (doneSimulations * 2) * discount;
+		logger->Warn("Final price: %.10f (%d simulations, seed %llu)", threadFinalPrice,
+			doneSimulations, (unsigned long long) seed);
+	}
+
 	//Standard Deviation Calculus
 	double std_dev = 0.0;
 
-	for(int i=0; i < this->pricesToCompute; i++){
-		computedPrices[i] = (computedPrices[i] - threadFinalPrice) * (computedPrices[i] - threadFinalPrice);	
+	for(size_t i=0; i < chunkPrices.size(); i++){
+		chunkPrices[i] = (chunkPrices[i] - threadFinalPrice) * (chunkPrices[i] - threadFinalPrice);	
 	} 
 
-	for(int i=0; i < this->pricesToCompute; i++){
-		std_dev += computedPrices[i];
+	for(size_t i=0; i < chunkPrices.size(); i++){
+		std_dev += chunkPrices[i];
 	}
-	std_dev = sqrt(std_dev / (this->pricesToCompute));	
+	if (!chunkPrices.empty())
+		std_dev = sqrt(std_dev / (chunkPrices.size()));	
 	logger->Warn("Standard Deviation: %f", std_dev);	
 
-	for(int i=0; i<cpuNumber; i++){
-		delete workers[i];
-	}
-	delete[] workers;
+	JournalResult result = JournalResult();
+	result.seconds = journal.elapsed();
+	result.price = threadFinalPrice;
+	result.standardDeviation = std_dev;
+	result.simulations = doneSimulations;
+	result.chunks = scheduler.getCompletedChunks();
+	journal.append(JOURNAL_RESULT, result);
+	journal.close();
+
+	aggregator->exportMetrics(threadFinalPrice);
+	aggregator.reset();
+
+	// The workers end their threads, then the slots and the tasks they used are destroyed with the arena
+	workers.clear();
+	arena.release();
+
+	// The store is complete only if all the chunks have been simulated
+	if (scheduler.getCompletedChunks() == chunksNumber)
+		pathStore.markCompleted();
+	pathStore.close();
 
 	return RTLIB_OK;
 }
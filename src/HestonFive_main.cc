@@ -20,6 +20,10 @@
 #include <random>
 #include <cstring>
 #include <memory>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <limits>
 
 #include <libgen.h>
 
@@ -29,6 +33,24 @@
 
 #include "version.h"
 #include "HestonFive_exc.h"
+#include "ScenarioEngine.h"
+#include "PathStore.h"
+#include "JobRunner.h"
+#include "PricingService.h"
+#include "BasketEngine.h"
+#include "ResultAggregator.h"
+#include "ChunkScheduler.h"
+#include "Arena.h"
+#include "ImpliedVolatility.h"
+#include "InverseNormal.h"
+#include "RunJournal.h"
+#include "ValidationSuite.h"
+#include "HestonPde.h"
+#include "CosPricer.h"
+#include "StepPlanner.h"
+#include "StartupTimeline.h"
+#include "EuropeanCall.h"
+#include "EuropeanPut.h"
 #include <bbque/utils/utility.h>
 #include <bbque/utils/logging/logger.h>
 
@@ -139,6 +161,213 @@ int discretization;
  */
 double correctValue;
 
+/**
+ * @brief Enable the conditional Monte Carlo (mixing formula) simulation. By default it is disabled
+ */
+bool mixing;
+
+/**
+ * @brief Simulate the paths in single precision. By default the simulation is in double precision
+ */
+bool singlePrecision;
+
+/**
+ * @brief Compare the single and the double precision engines and exit. By default it is disabled
+ */
+bool comparePrecision;
+
+/**
+ * @brief The file where the metrics are exported. By default the metrics are not exported
+ */
+std::string metricsFile;
+
+/**
+ * @brief Emit ftrace markers (only if the metrics are compiled in). By default they are disabled
+ */
+bool traceMarkers;
+
+/**
+ * @brief Check that the steady state of the workers does no heap allocation and exit. By default it is disabled
+ */
+bool checkAllocations;
+
+/**
+ * @brief The seed of the random substreams of the chunks. By default (0) a random seed is used
+ */
+unsigned long long seed;
+
+/**
+ * @brief The number of simulations of every chunk. By default the value is 20000
+ */
+int chunkSimulations;
+
+/**
+ * @brief The shock file of the stress scenarios. By default no scenario is run
+ */
+std::string scenarioFile;
+
+/**
+ * @brief The file where the prices of the scenarios are written. By default the value is scenarios.hfc
+ */
+std::string scenarioOutput;
+
+/**
+ * @brief Simulate the scenarios in lanes over the same paths. By default every scenario is simulated by a worker
+ */
+bool scenarioLanes;
+
+/**
+ * @brief The file where the simulated paths are stored. By default the paths are not stored
+ */
+std::string pathStoreFile;
+
+/**
+ * @brief Store the paths in single precision. By default they are stored in double precision
+ */
+bool pathStoreSingle;
+
+/**
+ * @brief The path store to reprice. By default no store is repriced
+ */
+std::string repriceFile;
+
+/**
+ * @brief The strikes of the options priced on the stored paths or of the volatility surface. By default the value is "100"
+ */
+std::string strikes;
+
+/**
+ * @brief The job file of a batch of contracts. By default a single contract is priced
+ */
+std::string jobFile;
+
+/**
+ * @brief The file where the prices of the jobs are written. By default they are written on the standard output
+ */
+std::string jobOutput;
+
+/**
+ * @brief Price the European jobs and the volatility surface by Monte Carlo. By default they are priced by the COS method
+ */
+bool monteCarlo;
+
+/**
+ * @brief The piecewise-constant curves of the model ("time:value,..."). By default the scalar values are used
+ */
+std::string rateCurve;
+std::string dividendCurve;
+std::string kappaCurve;
+std::string thetaCurve;
+std::string xiCurve;
+
+/**
+ * @brief The basket file of a multi-asset contract. By default a single asset is simulated
+ */
+std::string basketFile;
+
+/**
+ * @brief Price the option with the asynchronous pricing service. By default the BarbequeRTRM application is run
+ */
+bool asyncPricing;
+
+/**
+ * @brief The half width of the confidence interval that completes the asynchronous pricing. By default (0) all the simulations are done
+ */
+double tolerance;
+
+/**
+ * @brief The file of the implied volatility surface. By default the BarbequeRTRM application is run
+ */
+std::string surfaceFile;
+
+/**
+ * @brief The maturities of the volatility surface. By default the value is "0.5,1,2,5"
+ */
+std::string maturities;
+
+/**
+ * @brief The tier of the inverse normal. By default the value is "as241"
+ */
+std::string inverseNormal;
+
+/**
+ * @brief Measure the cost and the bias of the inverse normal tiers. By default the BarbequeRTRM application is run
+ */
+bool benchmarkNormals;
+
+/**
+ * @brief The model simulated. By default the value is "heston"
+ */
+std::string modelName;
+
+/**
+ * @brief The parameters of the jumps (Bates) and of the second variance factor (double Heston)
+ */
+ModelParameters modelParameters;
+
+/**
+ * @brief The journal of the run. By default the run is not recorded
+ */
+std::string journalFile;
+
+/**
+ * @brief The journal to replay, and the chunk to replay (-1 for all the chunks). By default the BarbequeRTRM application is run
+ */
+std::string replayFile;
+int replayChunk;
+
+/**
+ * @brief Validate the prices and the throughput of the engine on a grid of cases. By default the BarbequeRTRM application is run
+ */
+bool validate;
+
+/**
+ * @brief Price the option with the ADI solver of the Heston PDE. By default the BarbequeRTRM application is run
+ */
+bool pde;
+
+/**
+ * @brief The intervals of the spot and variance grids and the time steps of the PDE solver. By default the value is "100,50,50"
+ */
+std::string pdeGrid;
+
+/**
+ * @brief The ADI scheme of the PDE solver. By default the value is "craig-sneyd"
+ */
+std::string pdeScheme;
+
+/**
+ * @brief The file of the baseline throughputs of the validation, and the update of the lines of this machine. By default no baseline is used
+ */
+std::string baselineFile;
+bool updateBaseline;
+
+/**
+ * @brief The time grid of the simulation, the concentration of the steps towards the expiry and the observation dates. By default the value is "1" (uniform)
+ */
+std::string timeGridText;
+TimeGrid timeGrid;
+
+/**
+ * @brief Extrapolate the price with Richardson over the grid and its refinement. By default it is disabled
+ */
+bool richardson;
+
+/**
+ * @brief The target on the discretization bias that chooses the steps of every contract. By default (0) the steps are the ones of --discr
+ */
+double biasTarget;
+
+/**
+ * @brief Print the timeline of the start of the run (from the initialization of the program to the first price). By default it is disabled
+ */
+bool startupReport;
+
+/**
+ * @brief Start the first chunk at the setup, before the first configuration of the BarbequeRTRM. By default it is disabled
+ */
+bool fastStart;
+
 void ParseCommandLine(int argc, char *argv[]) {
 	// Parse command line params
 	try {
@@ -175,6 +404,721 @@ void ParseCommandLine(int argc, char *argv[]) {
 	}
 }
 
+/**
+ * Validation of the single precision engine. The two engines simulate the same chunks with the same seeds, so
+ * they draw the same random stream and the difference of their prices is only the float rounding error.
+ * The validation passes if this error is at least ten times smaller than the Monte Carlo standard error of
+ * the double precision price
+ */
+int ComparePrecision() {
+	const int chunks = 10;
+	const int chunkSize = 10000;
+
+	HestonWorker doubleWorker(S0, K, r, T, V0, rho, kappa, theta, xi);
+	HestonWorker singleWorker(S0, K, r, T, V0, rho, kappa, theta, xi);
+	doubleWorker.setMixingMode(mixing);
+	singleWorker.setMixingMode(mixing);
+	singleWorker.setSinglePrecision(true);
+
+	double discount = exp(-r * T);
+	double doublePrices[chunks];
+	double singlePrices[chunks];
+	double doubleSeconds = 0.0;
+	double singleSeconds = 0.0;
+
+	ChunkTask task;
+	for (int c = 0; c < chunks; c++) {
+		task.reset(c, c * chunkSize, chunkSize, seed ? seed : 1);
+		doubleWorker.start(&task, discretization);
+		doubleWorker.join();
+		doublePrices[c] = task.sum.get() / (2.0 * chunkSize) * discount;
+
+		task.reset(c, c * chunkSize, chunkSize, seed ? seed : 1);
+		singleWorker.start(&task, discretization);
+		singleWorker.join();
+		singlePrices[c] = task.sum.get() / (2.0 * chunkSize) * discount;
+	}
+	doubleSeconds = doubleWorker.getMetrics().busySeconds;
+	singleSeconds = singleWorker.getMetrics().busySeconds;
+
+	double doublePrice = 0.0, singlePrice = 0.0, maxError = 0.0;
+	for (int c = 0; c < chunks; c++) {
+		doublePrice += doublePrices[c] / chunks;
+		singlePrice += singlePrices[c] / chunks;
+		maxError = std::max(maxError, fabs(doublePrices[c] - singlePrices[c]));
+	}
+
+	double variance = 0.0;
+	for (int c = 0; c < chunks; c++)
+		variance += (doublePrices[c] - doublePrice) * (doublePrices[c] - doublePrice) / (chunks - 1);
+	double standardError = sqrt(variance / chunks);
+
+	std::cout << "Double precision price: " << doublePrice << " (" << doubleSeconds << " s)" << std::endl;
+	std::cout << "Single precision price: " << singlePrice << " (" << singleSeconds << " s)" << std::endl;
+	std::cout << "Monte Carlo standard error: " << standardError << std::endl;
+	std::cout << "Max chunk rounding error: " << maxError << std::endl;
+
+	bool passed = maxError < 0.1 * standardError;
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Validation of the prices and of the throughput of the engine. The grid of cases is built around the parameters
+ * of the command line, and every case is simulated in chunks of --chunk simulations: a price farther than
+ * SIGMAS standard errors from the analytic one is a bias, a throughput below the baseline of the machine is a
+ * slowdown, and both make the validation fail
+ */
+int Validate() {
+	const int chunks = 16;
+
+	ValidationCase base;
+	base.name = "base";
+	base.S0 = S0;
+	base.K = K;
+	base.r = r;
+	base.T = T;
+	base.V0 = V0;
+	base.rho = rho;
+	base.kappa = kappa;
+	base.theta = theta;
+	base.xi = xi;
+	base.discretization = discretization;
+	base.mixing = false;
+	base.singlePrecision = false;
+	base.richardson = false;
+
+	ValidationSuite suite(chunks, std::max(chunkSimulations / 2, 1), seed);
+	suite.addGrid(base, modelParameters);
+	if (!baselineFile.empty() && !suite.loadBaseline(baselineFile))
+		return EXIT_FAILURE;
+
+	int failures = suite.run();
+
+	if (!baselineFile.empty() && updateBaseline) {
+		if (!suite.saveBaseline(baselineFile)) {
+			std::cout << "Unable to write the baseline " << baselineFile << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::cout << "Baseline written in " << baselineFile << std::endl;
+	}
+
+	std::cout << (failures == 0 ? "PASSED" : "FAILED") << std::endl;
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Validation of the allocation-free steady state. The chunks are run by the scheduler of the application, with its
+ * run cycles and its logs: persistent workers, tasks in the arena reused from a free list, stopped chunks resumed,
+ * results pushed to the aggregator thread. The first chunk of every worker creates its thread and its buffers,
+ * then the heap allocations of all the threads are counted until the end of the run: the validation passes if
+ * there is none
+ */
+int CheckAllocations() {
+	if (!AllocationCounter::enabled()) {
+		std::cout << "The allocation counter is not compiled in (CONFIG_CONTRIB_HESTONFIVE_METRICS)" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const int workersNumber = 2;
+	const int chunkSize = 2 * HestonWorker::PUBLISH_PERIOD;
+	const int chunks = 16;
+	const int tasksNumber = 2 * workersNumber;
+
+	std::vector<std::unique_ptr<HestonWorker> > workers(workersNumber);
+	ChunkScheduler scheduler(workers);
+	Arena arena;
+	arena.reserve(Arena::footprint<ChunkTask>(tasksNumber), 1);
+	scheduler.setLogger(logger.get());
+	scheduler.setup(arena, tasksNumber, chunks * chunkSize, chunkSize, seed ? seed : 1, discretization);
+
+	ResultAggregator aggregator(workersNumber, chunks, exp(-r * T));
+	aggregator.start();
+
+	for (int i = 0; i < workersNumber; i++) {
+		workers[i].reset(new HestonWorker(S0, K, r, T, V0, rho, kappa, theta, xi));
+		workers[i]->setMixingMode(mixing);
+		workers[i]->setSinglePrecision(singlePrecision);
+		workers[i]->setCompletionSignal(scheduler.getCompletionSignal());
+		workers[i]->setResultRing(aggregator.getRing(i), aggregator.getSignal());
+	}
+
+	uint64_t before = 0;
+	int warmWorkers = 0;
+	std::vector<bool> warm(workersNumber, false);
+	bool stopped = false;
+	while (scheduler.cycle(workersNumber, 100)) {
+		// A chunk in the steady state is stopped, as by a reconfiguration, to exercise the resume of a task too
+		if (scheduler.getStartedChunks() >= chunks / 2 && !stopped && workers[0]->isStarted()) {
+			workers[0]->stop();
+			scheduler.collectWorker(0);
+			stopped = true;
+		}
+
+		// The steady state begins when every worker has simulated its first chunk: the local state and the
+		// buffers of a worker are allocated by its thread at its first chunk
+		for (int i = 0; i < workersNumber; i++) {
+			if (!warm[i] && !workers[i]->isStarted() && workers[i]->getMetrics().chunks > 0) {
+				warm[i] = true;
+				warmWorkers++;
+			}
+		}
+		if (warmWorkers == workersNumber && before == 0)
+			before = AllocationCounter::count();
+	}
+
+	uint64_t allocations = AllocationCounter::count() - before;
+	aggregator.stop();
+	AggregateSnapshot result = aggregator.getSnapshot();
+
+	std::cout << "Chunks: " << result.chunks << ", price: " << result.price << " +/- " << result.standardError
+		<< std::endl;
+	std::cout << "Heap allocations in the steady state: " << allocations << std::endl;
+
+	bool passed = before != 0 && allocations == 0 && result.chunks == chunks;
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Revaluation of the option under the stress scenarios of the shock file. All the scenarios are simulated on
+ * the same block of normals, so the differences between their prices are not hidden by the Monte Carlo noise
+ */
+int RunScenarios() {
+	ScenarioEngine engine(S0, K, r, T, V0, rho, kappa, theta, xi, simulationNumber / 2, discretization);
+	engine.setMixingMode(mixing);
+	engine.setSinglePrecision(singlePrecision);
+	engine.setSeed(seed);
+	engine.setLanes(scenarioLanes);
+	engine.setChunkSize(std::max(chunkSimulations / 2, 1));
+
+	if (!engine.load(scenarioFile))
+		return EXIT_FAILURE;
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	engine.run();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+	std::cout << engine.getScenarios().size() << " scenarios priced in " << elapsed.count() << " s" << std::endl;
+	if (!engine.write(scenarioOutput))
+		return EXIT_FAILURE;
+	std::cout << "Results written in " << scenarioOutput << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Method used to read a comma separated list of numbers
+ * @param values	The list
+ */
+std::vector<double> ParseList(std::string const & values) {
+	std::vector<double> list;
+	std::stringstream stream(values);
+	std::string value;
+	while (std::getline(stream, value, ','))
+		list.push_back(atof(value.c_str()));
+	return list;
+}
+
+/**
+ * Pricing of European calls and puts on the paths of a store. The paths are not simulated again: every
+ * contract only reads the terminal column of the mapped store, and it is discounted with the discount factor of
+ * the curves the paths have been simulated with
+ */
+int RepriceStore() {
+	PathStore store;
+	if (!store.open(repriceFile)) {
+		std::cout << "Unable to open the path store " << repriceFile << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	PathStoreHeader const & model = store.getHeader();
+	if (!model.completed)
+		std::cout << "Warning: the path store has not been completed" << std::endl;
+
+	std::vector<double> strikeList = ParseList(strikes);
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	double discount = model.discount / (double) model.paths;
+
+	std::cout << "strike,call,put" << std::endl;
+	for (size_t i = 0; i < strikeList.size(); i++) {
+		EuropeanCall call(model.S0, strikeList[i], model.r, model.T);
+		EuropeanPut put(model.S0, strikeList[i], model.r, model.T);
+		std::cout << strikeList[i] << "," << store.payoffSum(&call) * discount << ","
+			<< store.payoffSum(&put) * discount << std::endl;
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+	std::cout << 2 * strikeList.size() << " contracts priced on " << model.paths << " paths in "
+		<< elapsed.count() << " s (forward " << model.forward << ", discount " << model.discount << ")" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Pricing of a batch of contracts. The jobs with the same model are priced on the same paths, and the groups
+ * of jobs are simulated concurrently by the pool of workers, in a single process
+ */
+int RunJobs() {
+	Job defaults = {"", "call", S0, K, r, T, V0, rho, kappa, theta, xi, simulationNumber / 2, discretization};
+	JobRunner runner(defaults, std::max(chunkSimulations / 2, 1));
+	runner.setMixingMode(mixing);
+	runner.setSinglePrecision(singlePrecision);
+	runner.setSeed(seed);
+	runner.setModel(modelParameters);
+	runner.setFourier(!monteCarlo);
+	runner.setTimeGrid(timeGrid);
+	runner.setRichardson(richardson);
+	runner.setBiasTarget(biasTarget);
+
+	if (!runner.load(jobFile))
+		return EXIT_FAILURE;
+
+	FILE* output = stdout;
+	if (jobOutput != "-" && (output = fopen(jobOutput.c_str(), "w")) == NULL) {
+		std::cout << "Unable to write the job results in " << jobOutput << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	runner.run(output);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+	if (output != stdout)
+		fclose(output);
+	std::cerr << runner.getJobsNumber() << " jobs in " << runner.getGroupsNumber() << " groups priced in "
+		<< elapsed.count() << " s" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Pricing of the option with the asynchronous pricing service. The estimate is written at every completed chunk,
+ * and the pricing is completed as soon as its confidence interval is within the tolerance. The model, the time
+ * grid, the Richardson extrapolation, the curves and the bias target are the ones of the pricing of the option
+ * @param terms		The curves of the command line
+ */
+int RunAsync(HestonTerms const & terms) {
+	PricingRequest request;
+	request.contract = {"async", "call", S0, K, r, T, V0, rho, kappa, theta, xi, simulationNumber / 2, discretization};
+	request.tolerance = tolerance;
+	request.chunkSimulations = std::max(chunkSimulations / 2, 1);
+	request.seed = seed ? seed : ((uint64_t) std::random_device()() << 32) | std::random_device()();
+	request.mixing = mixing;
+	request.singlePrecision = singlePrecision;
+	request.model = modelParameters;
+	request.timeGrid = timeGrid;
+	request.richardson = richardson;
+	request.curves = true;
+	request.terms = terms;
+
+	if (biasTarget > 0.0) {
+		StepPlanner planner(S0, K, r, T, V0, rho, kappa, theta, xi);
+		planner.setTerms(terms);
+		planner.setModel(modelParameters);
+		planner.setTimeGrid(timeGrid);
+		planner.setMixingMode(mixing);
+		planner.setRichardson(richardson);
+		request.contract.discretization = planner.plan(biasTarget);
+	}
+	request.progress = [](PricingProgress const & progress) {
+		std::cout << "Chunk " << progress.chunks << ": " << progress.price << " +/- " << progress.halfWidth
+			<< " (" << 2 * progress.simulations << " simulations)" << std::endl;
+	};
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	PricingService service;
+	std::shared_ptr<PricingHandle> handle = service.submit(request);
+	PricingResult result = handle->getResult().get();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+	const char* status = (result.status == PRICING_CONVERGED) ? "converged" :
+		(result.status == PRICING_CANCELLED) ? "cancelled" : "completed";
+	std::cout << "Price: " << result.estimate.price << " +/- " << result.estimate.halfWidth << " (" << status
+		<< " after " << 2 * result.estimate.simulations << " simulations in " << elapsed.count() << " s, seed "
+		<< request.seed << ")" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Pricing of the payoffs of a basket file on correlated multi-asset Heston paths. The parameters of the
+ * command line are the defaults of the assets
+ */
+int RunBasket() {
+	BasketAsset defaults = {"", S0, V0, rho, kappa, theta, xi, 0.0, 1.0};
+	BasketEngine engine(defaults, r, T, simulationNumber / 2, discretization);
+	engine.setSeed(seed);
+	engine.setChunkSize(std::max(chunkSimulations / 2, 1));
+
+	if (!engine.load(basketFile))
+		return EXIT_FAILURE;
+	if (!engine.factorize()) {
+		std::cout << "The correlation matrix of " << basketFile << " is not positive definite" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	engine.run();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+	engine.write(stdout);
+	std::cerr << "Basket priced in " << elapsed.count() << " s" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Generation of the implied volatility surface of the model. The out of the money option of every point of the
+ * (K, T) grid is priced by the COS expansion of the characteristic function, or with --monte-carlo by Monte Carlo
+ * (the strikes of a maturity on the same paths, the maturities concurrently), then all the prices are inverted
+ * together and the surface is written as a dense matrix, one line per maturity
+ */
+int RunSurface() {
+	std::vector<double> strikeList = ParseList(strikes);
+	std::vector<double> maturityList = ParseList(maturities);
+
+	Job defaults = {"", "call", S0, K, r, T, V0, rho, kappa, theta, xi, simulationNumber / 2, discretization};
+	JobRunner runner(defaults, std::max(chunkSimulations / 2, 1));
+	runner.setMixingMode(mixing);
+	runner.setSinglePrecision(singlePrecision);
+	runner.setSeed(seed);
+	runner.setModel(modelParameters);
+	runner.setFourier(!monteCarlo);
+	runner.setTimeGrid(timeGrid);
+	runner.setRichardson(richardson);
+	runner.setBiasTarget(biasTarget);
+
+	for (size_t t = 0; t < maturityList.size(); t++) {
+		for (size_t k = 0; k < strikeList.size(); k++) {
+			Job job = defaults;
+			job.T = maturityList[t];
+			job.K = strikeList[k];
+			job.type = (job.K >= S0 * exp(r * job.T)) ? "call" : "put";
+			if (!runner.add(job)) {
+				std::cout << "Invalid point of the surface: K " << job.K << ", T " << job.T << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	runner.run(NULL);
+	std::chrono::steady_clock::time_point priced = std::chrono::steady_clock::now();
+
+	VolatilityBatch batch;
+	for (size_t t = 0; t < maturityList.size(); t++) {
+		double growth = exp(r * maturityList[t]);
+		for (size_t k = 0; k < strikeList.size(); k++) {
+			int index = t * strikeList.size() + k;
+			batch.add(runner.getPrice(index) * growth, S0 * growth, strikeList[k], maturityList[t],
+				strikeList[k] >= S0 * growth);
+		}
+	}
+	std::vector<double> volatilities;
+	ImpliedVolatility::invert(batch, volatilities);
+	std::chrono::steady_clock::time_point inverted = std::chrono::steady_clock::now();
+
+	// No path has ended in the money: the price carries no information on the volatility
+	for (size_t i = 0; i < batch.size(); i++)
+		if (batch.prices[i] == 0.0)
+			volatilities[i] = std::numeric_limits<double>::quiet_NaN();
+
+	FILE* output = fopen(surfaceFile.c_str(), "w");
+	if (output == NULL) {
+		std::cout << "Unable to write the volatility surface in " << surfaceFile << std::endl;
+		return EXIT_FAILURE;
+	}
+	fprintf(output, "T");
+	for (size_t k = 0; k < strikeList.size(); k++)
+		fprintf(output, ",%g", strikeList[k]);
+	fprintf(output, "\n");
+	for (size_t t = 0; t < maturityList.size(); t++) {
+		fprintf(output, "%g", maturityList[t]);
+		for (size_t k = 0; k < strikeList.size(); k++)
+			fprintf(output, ",%.8g", volatilities[t * strikeList.size() + k]);
+		fprintf(output, "\n");
+	}
+	fclose(output);
+
+	std::chrono::duration<double> pricing = priced - begin;
+	std::chrono::duration<double> inversion = inverted - priced;
+	std::cout << batch.size() << " points priced in " << pricing.count() << " s and inverted in "
+		<< inversion.count() * 1e6 << " us, surface written in " << surfaceFile << std::endl;
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Pricing with the PDE solver. The European options are checked against the COS prices, which have no
+ * discretization error, and the American ones give the early exercise premium. Without dividends and with a
+ * non negative rate a call is never exercised early, so its premium must be zero
+ */
+int RunPde() {
+	std::vector<double> grid = ParseList(pdeGrid);
+	PdeScheme scheme;
+	if (grid.size() != 3 || !HestonPde::parse(pdeScheme, scheme)) {
+		std::cout << "Invalid PDE grid or scheme" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	HestonPde solver(V0, rho, kappa, theta, xi);
+	solver.setGrid((int) grid[0], (int) grid[1], (int) grid[2]);
+	solver.setScheme(scheme);
+	CosPricer pricer(V0, rho, kappa, theta, xi);
+
+	EuropeanCall call(S0, K, r, T);
+	EuropeanPut put(S0, K, r, T);
+	Option* options[] = {&call, &put};
+	const char* names[] = {"call", "put"};
+
+	printf("%-6s %14s %14s %12s %14s %12s %10s\n", "option", "european", "cos", "error", "american", "premium",
+		"ms");
+	double premiums[2];
+	for (int k = 0; k < 2; k++) {
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		double european = solver.price(*options[k], false);
+		double american = solver.price(*options[k], true);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+		double reference = options[k]->fourierCalculator(pricer);
+		premiums[k] = american - european;
+		printf("%-6s %14.8f %14.8f %12.3e %14.8f %12.8f %10.3f\n", names[k], european, reference,
+			european - reference, american, premiums[k], elapsed.count() * 1e3);
+	}
+
+	if (r < 0.0)
+		return EXIT_SUCCESS;
+	bool passed = premiums[0] == 0.0;
+	printf("Early exercise premium of the call without dividends: %.3e (it must be 0)\n", premiums[0]);
+	printf("%s\n", passed ? "PASSED" : "FAILED");
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Measure of the inverse normal tiers: the time of a draw in double and single precision, and the errors
+ * against AS241 on a grid of probabilities (the largest absolute one, and the bias of the first two moments)
+ */
+int BenchmarkNormals() {
+	static const InverseNormalTier tiers[] = {INVERSE_NORMAL_AS241, INVERSE_NORMAL_TABLE,
+		INVERSE_NORMAL_RATIONAL, INVERSE_NORMAL_POLYNOMIAL};
+
+	printf("%-12s %10s %10s %12s %12s %12s\n", "tier", "ns/double", "ns/float", "max error", "mean bias",
+		"var bias");
+	for (size_t i = 0; i < sizeof(tiers) / sizeof(tiers[0]); i++) {
+		InverseNormalReport report = InverseNormal::measure(tiers[i]);
+		printf("%-12s %10.2f %10.2f %12.3g %12.3g %12.3g\n", InverseNormal::name(tiers[i]), report.nanoseconds,
+			report.singleNanoseconds, report.maxError, report.meanBias, report.varianceBias);
+	}
+	printf("Embedded table: largest difference from AS241 %.3g\n", InverseNormal::checkTable());
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Report of the start of the run: the time of every phase from the initialization of the program, and the time
+ * spent in it from the end of the previous one
+ */
+void ReportStartup() {
+	std::vector<StartupPhase> phases = StartupTimeline::getPhases();
+	double previous = 0.0;
+	for (size_t i = 0; i < phases.size(); i++) {
+		logger->Notice("Startup: %-14s %10.3f ms (+%.3f ms)", phases[i].name, 1000.0 * phases[i].seconds,
+			1000.0 * (phases[i].seconds - previous));
+		previous = phases[i].seconds;
+	}
+}
+
+/**
+ * Replay of a run journal. The inputs of the run are read from the journal, then every recorded chunk (or only
+ * the requested one) is simulated again on its own, from its substream, and its sum is compared bit for bit
+ * with the recorded one. When all the chunks are replayed, the final price is also reduced again from the
+ * recorded sums and compared with the recorded result
+ */
+int ReplayJournal() {
+	std::vector<JournalRecord> records;
+	bool truncated;
+	if (!RunJournal::read(replayFile, records, truncated)) {
+		std::cout << "Unable to read the journal " << replayFile << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (truncated)
+		std::cout << "The journal ends with an incomplete record (interrupted run), it is ignored" << std::endl;
+
+	JournalInputs inputs;
+	if (records.empty() || records[0].type != JOURNAL_INPUTS || !records[0].get(inputs)) {
+		std::cout << "The journal has no inputs record" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	HestonTerms terms;
+	TimeGrid grid;
+	bool curvesRead = false;
+	std::vector<JournalChunk> chunks;
+	JournalResult result;
+	bool resultRead = false;
+	for (size_t i = 1; i < records.size(); i++) {
+		JournalRecord const & record = records[i];
+		if (record.type == JOURNAL_CURVES) {
+			std::string text(record.payload.begin(), record.payload.end());
+			std::stringstream lines(text);
+			std::string curve[6];
+			for (int c = 0; c < 6; c++)
+				std::getline(lines, curve[c]);
+			curvesRead = terms.rate.parse(curve[0]) && terms.dividend.parse(curve[1]) &&
+				terms.kappa.parse(curve[2]) && terms.theta.parse(curve[3]) && terms.xi.parse(curve[4]);
+			// The journals written before the time grids have no grid line: their grid is uniform
+			if (!curve[5].empty())
+				curvesRead = curvesRead && grid.parse(curve[5]);
+		} else if (record.type == JOURNAL_CONFIGURE) {
+			JournalConfigure configure;
+			if (record.get(configure))
+				printf("%10.3f s  AWM %d: %d workers on %d CPUs (%d NUMA nodes)\n", configure.seconds,
+					configure.awm, configure.workers, configure.cpus, configure.nodes);
+		} else if (record.type == JOURNAL_CHUNK) {
+			JournalChunk chunk;
+			if (record.get(chunk))
+				chunks.push_back(chunk);
+		} else if (record.type == JOURNAL_RESULT) {
+			resultRead = record.get(result);
+		}
+	}
+	if (!curvesRead) {
+		std::cout << "The journal has no valid curves record" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	ModelParameters model;
+	model.type = (ModelType) inputs.model;
+	model.jumpIntensity = inputs.jumpIntensity;
+	model.jumpMean = inputs.jumpMean;
+	model.jumpVolatility = inputs.jumpVolatility;
+	model.V0 = inputs.V02;
+	model.rho = inputs.rho2;
+	model.kappa = inputs.kappa2;
+	model.theta = inputs.theta2;
+	model.xi = inputs.xi2;
+
+	std::cout << "Run of " << inputs.simulations << " simulations in chunks of " << inputs.chunkSimulations
+		<< ", " << inputs.discretization << " steps, seed " << (unsigned long long) inputs.seed << ", model "
+		<< ModelParameters::name(model.type) << (inputs.mixing ? ", mixing" : "")
+		<< (grid.isUniform() ? "" : ", time grid " + grid.format()) << (inputs.richardson ? ", Richardson" : "")
+		<< (inputs.singlePrecision ? ", single precision" : "") << ", inverse normal "
+		<< InverseNormal::name((InverseNormalTier) inputs.inverseNormal) << std::endl;
+
+	InverseNormal::setTier((InverseNormalTier) inputs.inverseNormal);
+	HestonWorker worker(inputs.S0, inputs.K, inputs.r, inputs.T, inputs.V0, inputs.rho, inputs.kappa,
+		inputs.theta, inputs.xi);
+	worker.setMixingMode(inputs.mixing != 0);
+	worker.setSinglePrecision(inputs.singlePrecision != 0);
+	worker.setTerms(terms);
+	worker.setModel(model);
+	worker.setTimeGrid(grid);
+	worker.setRefinement(inputs.richardson ? -1.0 : 0.0, inputs.richardson ? 2.0 : 0.0);
+
+	int chunksNumber = (inputs.simulations + inputs.chunkSimulations - 1) / inputs.chunkSimulations;
+	std::vector<double> chunkSums(chunksNumber, 0.0);
+	int simulations = 0;
+	int replayed = 0;
+	int mismatches = 0;
+
+	ChunkTask task;
+	for (size_t i = 0; i < chunks.size(); i++) {
+		JournalChunk const & chunk = chunks[i];
+		if (chunk.index < 0 || chunk.index >= chunksNumber) {
+			std::cout << "Chunk " << chunk.index << " is out of the run" << std::endl;
+			return EXIT_FAILURE;
+		}
+		chunkSums[chunk.index] = chunk.sum;
+		simulations += chunk.done;
+		if (replayChunk >= 0 && chunk.index != replayChunk)
+			continue;
+
+		int first = chunk.index * inputs.chunkSimulations;
+		task.reset(chunk.index, first, std::min(inputs.chunkSimulations, inputs.simulations - first), inputs.seed);
+		worker.start(&task, inputs.discretization);
+		worker.join();
+
+		double sum = task.sum.get();
+		bool match = task.done == chunk.done && memcmp(&sum, &chunk.sum, sizeof(sum)) == 0;
+		printf("%10.3f s  chunk %d (worker %d): recorded %.17g, replayed %.17g  %s\n", chunk.seconds, chunk.index,
+			chunk.worker, chunk.sum, sum, match ? "OK" : "MISMATCH");
+		replayed++;
+		if (!match)
+			mismatches++;
+	}
+
+	if (replayChunk >= 0 && replayed == 0) {
+		std::cout << "Chunk " << replayChunk << " is not in the journal" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// The price is reduced as in the application, from the recorded sums in the order of the chunks
+	if (replayChunk < 0 && resultRead && simulations > 0) {
+		double discount = exp(-terms.rate.integral(0.0, inputs.T));
+		double price = PairwiseSum::sum(&chunkSums[0], chunksNumber) / (double) (simulations * 2) * discount;
+		bool match = memcmp(&price, &result.price, sizeof(price)) == 0;
+		printf("%10.3f s  price: recorded %.17g, reduced %.17g (%d chunks)  %s\n", result.seconds, result.price,
+			price, result.chunks, match ? "OK" : "MISMATCH");
+		if (!match)
+			mismatches++;
+	} else if (!resultRead) {
+		std::cout << "The journal has no result record (interrupted run)" << std::endl;
+	}
+
+	std::cout << replayed << " chunks replayed, " << mismatches << " mismatches" << std::endl;
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Method used to get the flag of the mode selected by the command line that does not simulate the curves, the
+ * one the dispatch of main runs instead of the pricing of the option, or NULL if there is none
+ */
+const char* CurvelessMode() {
+	if (benchmarkNormals)
+		return "--benchmark-normals";
+	if (!replayFile.empty())
+		return "--replay";
+	if (comparePrecision)
+		return "--compare-precision";
+	if (validate)
+		return "--validate";
+	if (pde)
+		return "--pde";
+	if (checkAllocations)
+		return "--check-allocations";
+	if (!scenarioFile.empty())
+		return "--scenarios";
+	if (!repriceFile.empty())
+		return "--reprice";
+	if (!jobFile.empty())
+		return "--jobs";
+	if (!basketFile.empty())
+		return "--basket";
+	if (asyncPricing)
+		return NULL;
+	if (!surfaceFile.empty())
+		return "--surface";
+	return NULL;
+}
+
+/**
+ * Method used to get the flag of the mode selected by the command line that simulates only the Heston model, the
+ * one the dispatch of main runs instead of the pricing of the option, or NULL if there is none
+ */
+const char* HestonOnlyMode() {
+	if (benchmarkNormals || !replayFile.empty())
+		return NULL;
+	if (comparePrecision)
+		return "--compare-precision";
+	if (validate)
+		return NULL;
+	if (pde)
+		return "--pde";
+	if (checkAllocations)
+		return "--check-allocations";
+	if (!scenarioFile.empty())
+		return "--scenarios";
+	if (!repriceFile.empty() || !jobFile.empty())
+		return NULL;
+	if (!basketFile.empty())
+		return "--basket";
+	return NULL;
+}
+
 /**
  * The main method of our application, it is used only to start the computation once the parameters is given by the user
  */
@@ -199,9 +1143,137 @@ int main(int argc, char *argv[]) {
 		("discr,d", po::value<int>(&discretization)->
 			default_value(300),
 			"Discretization value")
-		("real,rv", po::value<double>(&correctValue)->
+		("real", po::value<double>(&correctValue)->
 			default_value(34.9998),
 			"The real value of the option to compute the error")
+		("mixing,m", po::bool_switch(&mixing),
+			"Simulate only the volatility and price the option analytically (conditional Monte Carlo)")
+		("single,f", po::bool_switch(&singlePrecision),
+			"Simulate the paths in single precision (float), accumulating the payoffs in double")
+		("compare-precision", po::bool_switch(&comparePrecision),
+			"Validate the single precision engine against the double one and exit")
+		("check-allocations", po::bool_switch(&checkAllocations),
+			"Check that the steady state of the workers does no heap allocation and exit")
+		("metrics-file", po::value<std::string>(&metricsFile),
+			"Export the workers metrics (Prometheus text, or JSON if the name ends with .json)")
+		("trace-markers", po::bool_switch(&traceMarkers),
+			"Emit ftrace markers for chunks and reconfigurations")
+		("seed", po::value<unsigned long long>(&seed)->
+			default_value(0),
+			"Seed of the simulation, the same seed gives the same price (0 for a random seed)")
+		("chunk", po::value<int>(&chunkSimulations)->
+			default_value(20000),
+			"Number of simulations of every chunk")
+		("scenarios", po::value<std::string>(&scenarioFile),
+			"Price the stress scenarios of the shock file with common random numbers and exit")
+		("scenario-output", po::value<std::string>(&scenarioOutput)->
+			default_value("scenarios.hfc"),
+			"The result file of the scenarios (columnar binary, or CSV if the name ends with .csv)")
+		("lanes", po::bool_switch(&scenarioLanes),
+			"Simulate the scenarios together, in lanes over the paths drawn once")
+		("path-store", po::value<std::string>(&pathStoreFile),
+			"Write all the simulated paths in a memory-mapped store")
+		("path-store-float", po::bool_switch(&pathStoreSingle),
+			"Write the stored paths in single precision")
+		("reprice", po::value<std::string>(&repriceFile),
+			"Price European calls and puts on the paths of a store and exit")
+		("strikes", po::value<std::string>(&strikes)->
+			default_value("100"),
+			"The comma separated strikes of the options priced on the stored paths or of the volatility surface")
+		("rate-curve", po::value<std::string>(&rateCurve),
+			"Piecewise-constant risk-free rate, as \"time:value,...\" (it replaces --risk)")
+		("dividend-curve", po::value<std::string>(&dividendCurve),
+			"Dividend yield, constant or piecewise-constant as \"time:value,...\"")
+		("kappa-curve", po::value<std::string>(&kappaCurve),
+			"Piecewise-constant mean reversion, as \"time:value,...\" (it replaces --kappa)")
+		("theta-curve", po::value<std::string>(&thetaCurve),
+			"Piecewise-constant long-term volatility, as \"time:value,...\" (it replaces --theta)")
+		("xi-curve", po::value<std::string>(&xiCurve),
+			"Piecewise-constant volatility of volatility, as \"time:value,...\" (it replaces --xi)")
+		("jobs", po::value<std::string>(&jobFile),
+			"Price the contracts of a job file (CSV or JSON lines) and exit")
+		("job-output", po::value<std::string>(&jobOutput)->
+			default_value("-"),
+			"The CSV file of the job results (- for the standard output)")
+		("basket", po::value<std::string>(&basketFile),
+			"Price the payoffs of a basket file on correlated multi-asset paths and exit")
+		("async", po::bool_switch(&asyncPricing),
+			"Price the option with the asynchronous pricing service and exit")
+		("tolerance", po::value<double>(&tolerance)->
+			default_value(0.0),
+			"Half width of the 95% confidence interval that completes the asynchronous pricing (0 for all the simulations)")
+		("surface", po::value<std::string>(&surfaceFile),
+			"Write the implied volatility surface of the model on the grid of --strikes and --maturities and exit")
+		("monte-carlo", po::bool_switch(&monteCarlo),
+			"Price the European contracts of --jobs and --surface by Monte Carlo instead of the COS method")
+		("maturities", po::value<std::string>(&maturities)->
+			default_value("0.5,1,2,5"),
+			"The comma separated maturities of the volatility surface")
+		("inverse-normal", po::value<std::string>(&inverseNormal)->
+			default_value("as241"),
+			"The inverse normal of the draws: as241 (full precision), table, rational or polynomial")
+		("benchmark-normals", po::bool_switch(&benchmarkNormals),
+			"Measure the cost and the bias of the inverse normal tiers and exit")
+		("journal", po::value<std::string>(&journalFile),
+			"Record the inputs, the reconfigurations, the chunks and the result of the run in a journal")
+		("replay", po::value<std::string>(&replayFile),
+			"Replay the chunks of a run journal, compare them bit for bit with the recorded ones and exit")
+		("replay-chunk", po::value<int>(&replayChunk)->
+			default_value(-1),
+			"The chunk replayed by --replay (-1 for all the chunks)")
+		("pde", po::bool_switch(&pde),
+			"Price the European and American calls and puts with the ADI solver of the Heston PDE and exit")
+		("pde-grid", po::value<std::string>(&pdeGrid)->
+			default_value("100,50,50"),
+			"The spot intervals, the variance intervals and the time steps of the PDE solver")
+		("pde-scheme", po::value<std::string>(&pdeScheme)->
+			default_value("craig-sneyd"),
+			"The ADI scheme of the PDE solver: craig-sneyd or hundsdorfer-verwer")
+		("validate", po::bool_switch(&validate),
+			"Check the prices against the analytic ones and the throughput against the baseline on a grid of cases, then exit")
+		("baseline", po::value<std::string>(&baselineFile),
+			"The file of the baseline throughputs of --validate, one \"host case paths-per-second\" per line")
+		("update-baseline", po::bool_switch(&updateBaseline),
+			"Write the throughputs measured by --validate in the baseline of this machine")
+		("time-grid", po::value<std::string>(&timeGridText)->
+			default_value("1"),
+			"The ratio between the first and the last step, optionally followed by the observation dates (\"4:0.25,0.5\")")
+		("richardson", po::bool_switch(&richardson),
+			"Extrapolate the price over the grid and its refinement, driven by the same Brownian increments")
+		("bias-target", po::value<double>(&biasTarget)->
+			default_value(0.0),
+			"Choose the steps of every contract with a pilot, to bring its discretization bias under this target (0 for --discr)")
+		("startup-report", po::bool_switch(&startupReport),
+			"Print the time of every phase of the start of the run, from the initialization of the program to the first price")
+		("fast-start", po::bool_switch(&fastStart),
+			"Start the first chunk at the setup, while the BarbequeRTRM assigns the resources")
+		("model", po::value<std::string>(&modelName)->
+			default_value("heston"),
+			"The model simulated: heston, bates (log-normal jumps) or double-heston (two variance factors)")
+		("jump-intensity", po::value<double>(&modelParameters.jumpIntensity)->
+			default_value(0.1),
+			"Expected number of jumps per year of the bates model")
+		("jump-mean", po::value<double>(&modelParameters.jumpMean)->
+			default_value(-0.05),
+			"Mean of the logarithm of a jump of the bates model")
+		("jump-vol", po::value<double>(&modelParameters.jumpVolatility)->
+			default_value(0.1),
+			"Standard deviation of the logarithm of a jump of the bates model")
+		("vol2", po::value<double>(&modelParameters.V0)->
+			default_value(0.04),
+			"Initial volatility of the second factor of the double-heston model")
+		("rho2", po::value<double>(&modelParameters.rho)->
+			default_value(-0.5),
+			"Correlation Coefficient of the second factor of the double-heston model")
+		("kappa2", po::value<double>(&modelParameters.kappa)->
+			default_value(0.5),
+			"Mean Reversion of the second factor of the double-heston model")
+		("theta2", po::value<double>(&modelParameters.theta)->
+			default_value(0.04),
+			"Long-Term volatility of the second factor of the double-heston model")
+		("xi2", po::value<double>(&modelParameters.xi)->
+			default_value(0.3),
+			"Volatility of volatility of the second factor of the double-heston model")
 
 		("spot,s", po::value<double>(&S0)->
 			default_value(100.0),
@@ -216,16 +1288,16 @@ int main(int argc, char *argv[]) {
 			default_value(5.0),
 			"Maturity Time [In Years]")
 
-		("vol,v", po::value<double>(&V0)->
+		("vol,V", po::value<double>(&V0)->
 			default_value(0.09),
 			"Volatility")
-		("rho,r", po::value<double>(&rho)->
+		("rho", po::value<double>(&rho)->
 			default_value(-0.30),
 			"Correlation Coefficient")
 		("kappa,k", po::value<double>(&kappa)->
 			default_value(2.0),
 			"Mean Reversion")
-		("theta,th", po::value<double>(&theta)->
+		("theta,t", po::value<double>(&theta)->
 			default_value(0.09),
 			"Long-Term volatility")
 		("xi,x", po::value<double>(&xi)->
@@ -236,8 +1308,94 @@ int main(int argc, char *argv[]) {
 	// Setup a logger
 	bu::Logger::SetConfigurationFile(conf_file);
 	logger = bu::Logger::GetLogger("hestonfive");
+	StartupTimeline::mark("logger");
 
 	ParseCommandLine(argc, argv);
+	StartupTimeline::mark("command line");
+
+	InverseNormalTier tier;
+	if (!InverseNormal::parse(inverseNormal, tier)) {
+		std::cout << "Unknown inverse normal " << inverseNormal << std::endl;
+		return EXIT_FAILURE;
+	}
+	InverseNormal::setTier(tier);
+
+	if (!ModelParameters::parse(modelName, modelParameters.type)) {
+		std::cout << "Unknown model " << modelName << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (!timeGrid.parse(timeGridText)) {
+		std::cout << "Invalid time grid " << timeGridText << ", the format is \"concentration:date,...\"" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	HestonTerms terms;
+	terms.rate = TermStructure(r);
+	terms.kappa = TermStructure(kappa);
+	terms.theta = TermStructure(theta);
+	terms.xi = TermStructure(xi);
+	if ((!rateCurve.empty() && !terms.rate.parse(rateCurve)) ||
+			(!dividendCurve.empty() && !terms.dividend.parse(dividendCurve)) ||
+			(!kappaCurve.empty() && !terms.kappa.parse(kappaCurve)) ||
+			(!thetaCurve.empty() && !terms.theta.parse(thetaCurve)) ||
+			(!xiCurve.empty() && !terms.xi.parse(xiCurve))) {
+		std::cout << "Invalid curve, the format is \"time:value,...\"" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// The curves are only simulated by the pricing of the option and by the pricing service: a mode that would
+	// ignore them fails instead
+	const char* mode = CurvelessMode();
+	bool curves = !rateCurve.empty() || !dividendCurve.empty() || !kappaCurve.empty() || !thetaCurve.empty() ||
+		!xiCurve.empty();
+	if (curves && mode != NULL) {
+		std::cout << "The curves are not supported by " << mode << ", only by the pricing of the option and by --async" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// The same for the models other than Heston, in the modes whose engines simulate only the Heston model
+	mode = HestonOnlyMode();
+	if (modelParameters.type != MODEL_HESTON && mode != NULL) {
+		std::cout << "The model " << modelName << " is not supported by " << mode << ", only the heston model" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (benchmarkNormals)
+		return BenchmarkNormals();
+
+	if (!replayFile.empty())
+		return ReplayJournal();
+
+	if (comparePrecision)
+		return ComparePrecision();
+
+	if (validate)
+		return Validate();
+
+	if (pde)
+		return RunPde();
+
+	if (checkAllocations)
+		return CheckAllocations();
+
+	if (!scenarioFile.empty())
+		return RunScenarios();
+
+	if (!repriceFile.empty())
+		return RepriceStore();
+
+	if (!jobFile.empty())
+		return RunJobs();
+
+	if (!basketFile.empty())
+		return RunBasket();
+
+	if (asyncPricing)
+		return RunAsync(terms);
+
+	if (!surfaceFile.empty())
+		return RunSurface();
 
 	// Welcome screen
 	logger->Info(".:: HestonFive (ver. %s) ::.", g_git_version);
@@ -252,21 +1410,55 @@ int main(int argc, char *argv[]) {
 		logger->Fatal("Unable to init RTLib (Did you start the BarbequeRTRM daemon?)");
 		return RTLIB_ERROR;
 	}
+	StartupTimeline::mark("rtlib");
 
 	assert(rtlib);
 
 	logger->Info("STEP 1. Registering EXC using [%s] recipe...",
 			recipe.c_str());
 
+	// The steps of the contract are the fewest that bring its discretization bias under the target
+	if (biasTarget > 0.0) {
+		StepPlanner planner(S0, K, r, T, V0, rho, kappa, theta, xi);
+		planner.setTerms(terms);
+		planner.setModel(modelParameters);
+		planner.setTimeGrid(timeGrid);
+		planner.setMixingMode(mixing);
+		planner.setRichardson(richardson);
+		discretization = planner.plan(biasTarget);
+		logger->Notice("Bias target %g: %d steps (bias constant %g)", biasTarget, discretization,
+			planner.getConstant());
+	}
+
 	HestonFive* app = new HestonFive("HestonFive", recipe, rtlib, S0, K, r, T, V0, rho, kappa, theta, xi, simulationNumber/2, discretization);
 	
 	app->setCorrectValue(correctValue);	
+	app->setMixingMode(mixing);
+	app->setSinglePrecision(singlePrecision);
+	app->setMetricsFile(metricsFile);
+	app->setSeed(seed);
+	app->setChunkSize(chunkSimulations / 2);
+	if (!pathStoreFile.empty())
+		app->setPathStore(pathStoreFile, pathStoreSingle);
+	app->setTerms(terms);
+	app->setModel(modelParameters);
+	app->setTimeGrid(timeGrid);
+	app->setRichardson(richardson);
+	app->setFastStart(fastStart);
+	if (!journalFile.empty())
+		app->setJournal(journalFile);
+
+	if (traceMarkers && !MetricsExporter::phasesEnabled())
+		logger->Warn("Trace markers requested, but the metrics are not compiled in");
+	else if (traceMarkers && !TraceMarker::enable())
+		logger->Warn("Unable to open the ftrace marker file");
 	
 	pexc = pBbqueEXC_t(app);
 	if (!pexc->isRegistered()) {
 		logger->Fatal("Registering failure.");
 		return RTLIB_ERROR;
 	}
+	StartupTimeline::mark("registered");
 
 
 	logger->Info("STEP 2. Starting EXC control thread...");
@@ -279,6 +1471,10 @@ int main(int argc, char *argv[]) {
 
 	logger->Info("STEP 4. Disabling EXC...");
 	pexc = NULL;
+	StartupTimeline::mark("done");
+
+	if (startupReport)
+		ReportStartup();
 
 	logger->Info("===== HestonFive DONE! =====");
 	return EXIT_SUCCESS;
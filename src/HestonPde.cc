@@ -0,0 +1,610 @@
+/**
+ *       @file  HestonPde.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The finite difference solver of the Heston PDE in the spot and the variance, for the options whose
+ *		payoff depends on the terminal spot, European or American. The grids are non-uniform (dense near the
+ *		strike and near zero variance), the space derivatives are second order central differences, and
+ *		the time is stepped by an ADI scheme (modified Craig-Sneyd or Hundsdorfer-Verwer): the mixed
+ *		derivative is explicit and every direction is implicit, so a step is a set of independent
+ *		tridiagonal solves along the grid lines, shared by a pool of threads
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "HestonPde.h"
+#include "CpuTopology.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/**
+ * The barrier met by the threads of the solver at the end of every stage of a time step
+ */
+class StageBarrier {
+
+public:
+
+	explicit StageBarrier(int count) : count(count), waiting(0), generation(0) {}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		unsigned long current = generation;
+		if (++waiting == count) {
+			waiting = 0;
+			generation++;
+			released.notify_all();
+			return;
+		}
+		released.wait(lock, [&] { return generation != current; });
+	}
+
+private:
+
+	std::mutex mutex;
+	std::condition_variable released;
+	int count;
+	int waiting;
+	unsigned long generation;
+};
+
+/**
+ * The weights of the first and of the second derivative on the three points x[-1], x[0], x[1] of a
+ * non-uniform grid, with hm = x[0] - x[-1] and hp = x[1] - x[0]
+ */
+inline void firstWeights(double hm, double hp, double* weights) {
+	weights[0] = -hp / (hm * (hm + hp));
+	weights[1] = (hp - hm) / (hm * hp);
+	weights[2] = hm / (hp * (hm + hp));
+}
+
+inline void secondWeights(double hm, double hp, double* weights) {
+	weights[0] = 2.0 / (hm * (hm + hp));
+	weights[1] = -2.0 / (hm * hp);
+	weights[2] = 2.0 / (hp * (hm + hp));
+}
+
+/**
+ * The weights of the quadratic interpolation in x on the nodes of a grid around the index center
+ */
+inline void interpolationWeights(std::vector<double> const & grid, int center, double x, double* weights) {
+	double a = grid[center - 1], b = grid[center], c = grid[center + 1];
+	weights[0] = (x - b) * (x - c) / ((a - b) * (a - c));
+	weights[1] = (x - a) * (x - c) / ((b - a) * (b - c));
+	weights[2] = (x - a) * (x - b) / ((c - a) * (c - b));
+}
+
+}
+
+const double HestonPde::MAX_VARIANCE = 5.0;
+
+/**
+ * The constructor of the HestonPde class
+ *
+ * @param V0		The initial volatility of the model
+ * @param rho		The Correlation Coefficient parameter of Heston model
+ * @param kappa		The mean reversion rate of the Heston Model
+ * @param theta		The long-term volatility value
+ * @param xi		The volatility of volatility (V0)
+ */
+HestonPde::HestonPde(double V0, double rho, double kappa, double theta, double xi) {
+	this->V0 = V0;
+	this->rho = rho;
+	this->kappa = kappa;
+	this->theta = theta;
+	this->xi = xi;
+	this->dividend = 0.0;
+	this->spots = DEFAULT_SPOTS;
+	this->variances = DEFAULT_VARIANCES;
+	this->steps = DEFAULT_STEPS;
+	this->threads = 0;
+	this->scheme = PDE_CRAIG_SNEYD;
+	this->width = 0;
+}
+
+/**
+ * Method used to set the dividend yield (zero by default)
+ * @param dividend	The dividend yield
+ */
+void HestonPde::setDividendYield(double dividend) {
+	this->dividend = dividend;
+}
+
+/**
+ * Method used to set the size of the grid (DEFAULT_SPOTS, DEFAULT_VARIANCES and DEFAULT_STEPS by default)
+ * @param spots		The intervals of the spot grid
+ * @param variances	The intervals of the variance grid
+ * @param steps		The time steps
+ */
+void HestonPde::setGrid(int spots, int variances, int steps) {
+	this->spots = std::max(spots, 4);
+	this->variances = std::max(variances, 4);
+	this->steps = std::max(steps, 1);
+}
+
+/**
+ * Method used to select the ADI scheme (modified Craig-Sneyd by default)
+ * @param scheme	The scheme
+ */
+void HestonPde::setScheme(PdeScheme scheme) {
+	this->scheme = scheme;
+}
+
+/**
+ * Method used to set the number of threads of the solver (0, the default, for the CPUs of the machine,
+ * limited so every thread has at least MIN_LINES lines of the grid)
+ * @param threads	The number of threads
+ */
+void HestonPde::setThreads(int threads) {
+	this->threads = threads;
+}
+
+/**
+ * Method used to read the name of a scheme ("craig-sneyd" or "hundsdorfer-verwer"), it returns false if
+ * the name is unknown
+ * @param name		The name of the scheme
+ * @param scheme	The scheme read
+ */
+bool HestonPde::parse(std::string const & name, PdeScheme & scheme) {
+	if (name == "craig-sneyd")
+		scheme = PDE_CRAIG_SNEYD;
+	else if (name == "hundsdorfer-verwer")
+		scheme = PDE_HUNDSDORFER_VERWER;
+	else
+		return false;
+	return true;
+}
+
+/**
+ * Method used to get the name of a scheme
+ * @param scheme	The scheme
+ */
+const char* HestonPde::name(PdeScheme scheme) {
+	return scheme == PDE_HUNDSDORFER_VERWER ? "hundsdorfer-verwer" : "craig-sneyd";
+}
+
+/**
+ * Method used to compute the price of an option with the payoff of its optionCalculator() at the maturity,
+ * for its spot, strike, rate and maturity. An American option is projected on its payoff after every
+ * time step, on the nodes where the early exercise can be optimal
+ * @param option	The option to price
+ * @param american	True for the early exercise
+ */
+double HestonPde::price(Option & option, bool american) {
+
+	double S0 = option.getSpotPrice();
+	double K = option.getStrikePrice();
+	double r = option.getRiskFreeRate();
+	double T = option.getMaturity();
+	double dt = T / steps;
+
+	build(S0, K, r, dt);
+
+	// The payoff, and the slope of the payoff at the largest spot, kept by the Neumann condition
+	payoff.resize(width);
+	for (int i = 0; i < width; i++)
+		payoff[i] = option.optionCalculator(s[i]);
+	double h = s[spots] - s[spots - 1];
+	double slope = (payoff[spots] - payoff[spots - 1]) / h;
+	spotBoundary.resize(variances + 1);
+	for (int j = 0; j <= variances; j++)
+		spotBoundary[j] = (v[j] * s[spots] * s[spots] / h + (r - dividend) * s[spots]) * slope;
+	if (american)
+		findExercise(option, r, dt);
+
+	int nodes = width * (variances + 1);
+	solution.resize(nodes);
+	predictor.resize(nodes);
+	stage.resize(nodes);
+	spotApplied.resize(nodes);
+	varianceApplied.resize(nodes);
+	varianceCorrection.resize(nodes);
+	for (int j = 0; j <= variances; j++)
+		std::copy(payoff.begin(), payoff.end(), solution.begin() + j * width);
+
+	CpuTopology topology;
+	int count = threads > 0 ? threads : std::max(topology.getCpusNumber(), 1);
+	count = std::max(std::min(count, std::min(variances + 1, width) / MIN_LINES), 1);
+
+	StageBarrier barrier(count);
+	std::vector<std::thread> pool;
+	for (int t = 0; t < count; t++)
+		pool.push_back(std::thread(&HestonPde::run, this, t, count, topology.getCpu(t), american, dt, &barrier));
+	for (int t = 0; t < count; t++)
+		pool[t].join();
+
+	return interpolate(S0, V0);
+}
+
+/**
+ * Method used to find the nodes of the spot grid where the early exercise can be optimal after every time
+ * step. The holding value of a convex payoff f is at least its discounted value on the forward,
+ * exp(-r tau) f(S exp((r - q) tau)) (Jensen), so the exercise can only be optimal where the payoff is above
+ * this bound: with no dividend and a non negative rate a call is never exercised, and its American price is
+ * the European one. A payoff that is not convex on the grid is exercised wherever it is positive
+ * @param option	The option to price
+ * @param r		The risk-free rate
+ * @param dt		The time step
+ */
+void HestonPde::findExercise(Option & option, double r, double dt) {
+
+	bool convex = true;
+	for (int i = 1; i < spots && convex; i++) {
+		double below = (payoff[i] - payoff[i - 1]) / (s[i] - s[i - 1]);
+		double above = (payoff[i + 1] - payoff[i]) / (s[i + 1] - s[i]);
+		convex = above >= below - 1e-12 * (1.0 + fabs(below));
+	}
+
+	exercisable.assign(steps * width, 0);
+	for (int step = 0; step < steps; step++) {
+		double tau = (step + 1) * dt;
+		double discount = exp(-r * tau);
+		double growth = exp((r - dividend) * tau);
+		for (int i = 0; i < width; i++) {
+			double bound = convex ? discount * option.optionCalculator(s[i] * growth) : 0.0;
+			exercisable[step * width + i] = payoff[i] > bound;
+		}
+	}
+}
+
+/**
+ * Method used to build the non-uniform grids around the strike and the operators for a rate. The spots are
+ * K + c sinh(x) on a uniform x grid from 0 to 8 max(S0, K), with c = K / 5, and the variances are
+ * d sinh(y) on a uniform y grid from 0 to MAX_VARIANCE, with d = MAX_VARIANCE / 500 (In 't Hout and
+ * Foulon). At zero spot the PDE has no spot term, at the largest spot the second derivative is the one of
+ * the Neumann condition; at zero variance only the drift kappa theta of the variance is left, and it is a
+ * forward difference, at the largest variance the first derivative is zero
+ * @param S0		The spot price
+ * @param K		The strike price
+ * @param r		The risk-free rate
+ * @param dt		The time step
+ */
+void HestonPde::build(double S0, double K, double r, double dt) {
+
+	int m = spots;
+	int n = variances;
+	width = m + 1;
+
+	double largest = 8.0 * std::max(S0, K);
+	double c = K / 5.0;
+	double low = asinh(-K / c);
+	double high = asinh((largest - K) / c);
+	s.resize(m + 1);
+	for (int i = 0; i <= m; i++)
+		s[i] = K + c * sinh(low + i * (high - low) / m);
+	s[0] = 0.0;
+
+	double d = MAX_VARIANCE / 500.0;
+	double top = asinh(MAX_VARIANCE / d);
+	v.resize(n + 1);
+	for (int j = 0; j <= n; j++)
+		v[j] = d * sinh(j * top / n);
+
+	spotWeights.assign(3 * (m + 1), 0.0);
+	varianceWeights.assign(3 * (n + 1), 0.0);
+	for (int i = 1; i < m; i++)
+		firstWeights(s[i] - s[i - 1], s[i + 1] - s[i], &spotWeights[3 * i]);
+	for (int j = 1; j < n; j++)
+		firstWeights(v[j] - v[j - 1], v[j + 1] - v[j], &varianceWeights[3 * j]);
+
+	int nodes = width * (n + 1);
+	for (int k = 0; k < 3; k++) {
+		spotOperator[k].assign(nodes, 0.0);
+		varianceOperator[k].assign(nodes, 0.0);
+	}
+	mixed.assign(nodes, 0.0);
+
+	double second[3];
+	for (int j = 0; j <= n; j++) {
+		for (int i = 0; i <= m; i++) {
+			int node = i + j * width;
+
+			// The spot direction, with half of the discounting
+			spotOperator[1][node] = -0.5 * r;
+			if (i > 0 && i < m) {
+				secondWeights(s[i] - s[i - 1], s[i + 1] - s[i], second);
+				for (int k = 0; k < 3; k++)
+					spotOperator[k][node] += 0.5 * v[j] * s[i] * s[i] * second[k] +
+						(r - dividend) * s[i] * spotWeights[3 * i + k];
+			} else if (i == m) {
+				double h = s[m] - s[m - 1];
+				spotOperator[0][node] += v[j] * s[m] * s[m] / (h * h);
+				spotOperator[1][node] -= v[j] * s[m] * s[m] / (h * h);
+			}
+
+			// The variance direction, with the other half of the discounting
+			varianceOperator[1][node] = -0.5 * r;
+			if (j > 0 && j < n) {
+				secondWeights(v[j] - v[j - 1], v[j + 1] - v[j], second);
+				for (int k = 0; k < 3; k++)
+					varianceOperator[k][node] += 0.5 * xi * xi * v[j] * second[k] +
+						kappa * (theta - v[j]) * varianceWeights[3 * j + k];
+			} else if (j == 0) {
+				double h = v[1] - v[0];
+				varianceOperator[1][node] -= kappa * theta / h;
+				varianceOperator[2][node] += kappa * theta / h;
+			} else {
+				double h = v[n] - v[n - 1];
+				varianceOperator[0][node] += xi * xi * v[n] / (h * h);
+				varianceOperator[1][node] -= xi * xi * v[n] / (h * h);
+			}
+
+			if (i > 0 && i < m && j > 0 && j < n)
+				mixed[node] = rho * xi * s[i] * v[j];
+		}
+	}
+
+	double weight = (scheme == PDE_HUNDSDORFER_VERWER ? 0.5 + sqrt(3.0) / 6.0 : 1.0 / 3.0) * dt;
+	factor(spotOperator, spotFactor, 1, m + 1, weight);
+	factor(varianceOperator, varianceFactor, width, n + 1, weight);
+}
+
+/**
+ * Method used to factor the tridiagonal system I - weight * A along a direction (the elimination of Thomas
+ * without pivoting: the systems are diagonally dominant for the steps of the solver)
+ * @param A		The operator
+ * @param factor	The factors
+ * @param stride	The distance of two consecutive nodes of a line
+ * @param length	The number of nodes of a line
+ * @param weight	The weight of the operator
+ */
+void HestonPde::factor(std::vector<double> const A[3], std::vector<double> factor[3], int stride, int length,
+	double weight) {
+
+	int nodes = (int) A[0].size();
+	for (int k = 0; k < 3; k++)
+		factor[k].assign(nodes, 0.0);
+
+	int lines = nodes / length;
+	int lineStride = stride == 1 ? length : 1;
+	for (int line = 0; line < lines; line++) {
+		int start = line * lineStride;
+		double pivot = 1.0 - weight * A[1][start];
+		factor[1][start] = 1.0 / pivot;
+		factor[2][start] = -weight * A[2][start];
+		for (int k = 1; k < length; k++) {
+			int node = start + k * stride;
+			double multiplier = -weight * A[0][node] * factor[1][node - stride];
+			pivot = 1.0 - weight * A[1][node] - multiplier * factor[2][node - stride];
+			factor[0][node] = multiplier;
+			factor[1][node] = 1.0 / pivot;
+			factor[2][node] = -weight * A[2][node];
+		}
+	}
+}
+
+/**
+ * The thread function: it steps the rows and the columns of the grid of the thread, and it meets the
+ * other threads at every stage. With theta the weight of the scheme, U the solution and A = A0 + A1 + A2
+ * (mixed, spot and variance operators, b the constant term of A1), a step is
+ *	Y0 = U + dt (A U + b)
+ *	Yk = Y(k-1) + theta dt Ak (Yk - U), k = 1, 2 (implicit)
+ *	Z0 = Y0 + dt (alpha A + beta A0) (Y2 - U)
+ *	Zk = Z(k-1) + theta dt Ak (Zk - W), k = 1, 2 (implicit)
+ * with alpha = 1/2 - theta, beta = theta and W = U for the modified Craig-Sneyd scheme, alpha = 1/2,
+ * beta = 0 and W = Y2 for the Hundsdorfer-Verwer scheme, and Z2 is the new solution. The spot systems and
+ * the explicit operators are applied on the rows of the thread, the variance systems on its columns
+ * @param index		The index of the thread
+ * @param count		The number of threads
+ * @param cpu		The CPU where the thread is pinned
+ * @param american	True for the early exercise
+ * @param dt		The time step
+ * @param barrier	The barrier of the stages
+ */
+void HestonPde::run(int index, int count, int cpu, bool american, double dt, void* barrier) {
+
+	CpuTopology::pinCurrentThread(cpu);
+	StageBarrier* stages = static_cast<StageBarrier*>(barrier);
+
+	int rows = variances + 1;
+	int firstRow = index * rows / count;
+	int lastRow = (index + 1) * rows / count;
+	int firstColumn = index * width / count;
+	int lastColumn = (index + 1) * width / count;
+
+	bool hundsdorfer = scheme == PDE_HUNDSDORFER_VERWER;
+	double weight = (hundsdorfer ? 0.5 + sqrt(3.0) / 6.0 : 1.0 / 3.0) * dt;
+	double alpha = hundsdorfer ? 0.5 : 0.5 - weight / dt;
+	double beta = hundsdorfer ? 0.0 : weight / dt;
+	double gamma = hundsdorfer ? 1.0 : 0.0;
+
+	std::vector<double> spotRow(width);
+	std::vector<double> mixedRow(width);
+
+	double* u = &solution[0];
+	double* y0 = &predictor[0];
+	double* y = &stage[0];
+
+	for (int step = 0; step < steps; step++) {
+
+		// The slope of a European option at the largest spot is the one of its payoff discounted with the
+		// dividend yield, an American one is exercised there and it keeps the slope of its payoff
+		double decay = american ? 1.0 : exp(-dividend * step * dt);
+
+		// Y0 and Y1 on the rows
+		for (int j = firstRow; j < lastRow; j++) {
+			int row = j * width;
+			apply<false>(u, NULL, j, &spotApplied[row], &varianceApplied[row], &mixedRow[0]);
+			for (int i = 0; i < width; i++) {
+				double explicitPart = mixedRow[i] + spotApplied[row + i] + varianceApplied[row + i];
+				y0[row + i] = u[row + i] + dt * explicitPart;
+			}
+			y0[row + spots] += dt * decay * spotBoundary[j];
+			for (int i = 0; i < width; i++)
+				y[row + i] = y0[row + i] - weight * spotApplied[row + i];
+			solveRow(y, j);
+		}
+		stages->wait();
+
+		// Y2 on the columns
+		for (int j = 0; j < rows; j++)
+			for (int i = firstColumn; i < lastColumn; i++)
+				y[i + j * width] -= weight * varianceApplied[i + j * width];
+		solveColumns(y, firstColumn, lastColumn);
+		stages->wait();
+
+		// Z0 and Z1 on the rows, the variance operator applied to Y2 - U is kept for Z2
+		for (int j = firstRow; j < lastRow; j++) {
+			int row = j * width;
+			apply<true>(y, u, j, &spotRow[0], &varianceCorrection[row], &mixedRow[0]);
+			for (int i = 0; i < width; i++) {
+				double difference = mixedRow[i] + spotRow[i] + varianceCorrection[row + i];
+				double z0 = y0[row + i] + dt * (alpha * difference + beta * mixedRow[i]);
+				y0[row + i] = z0 - weight * (spotApplied[row + i] + gamma * spotRow[i]);
+			}
+			solveRow(y0, j);
+		}
+		stages->wait();
+
+		// Z2 on the columns, it is the new solution
+		for (int j = 0; j < rows; j++) {
+			for (int i = firstColumn; i < lastColumn; i++) {
+				int node = i + j * width;
+				u[node] = y0[node] - weight * (varianceApplied[node] + gamma * varianceCorrection[node]);
+			}
+		}
+		solveColumns(u, firstColumn, lastColumn);
+		if (american) {
+			const unsigned char* exercise = &exercisable[step * width];
+			for (int j = 0; j < rows; j++)
+				for (int i = firstColumn; i < lastColumn; i++)
+					if (exercise[i])
+						u[i + j * width] = std::max(u[i + j * width], payoff[i]);
+		}
+		stages->wait();
+	}
+}
+
+/**
+ * Method used to apply the operators of the two directions and the mixed derivative on a row, to a grid
+ * or to the difference of two grids. The rows out of the grid are replaced by the row itself, since
+ * their coefficients are zero
+ * @param u		The grid
+ * @param w		The grid subtracted from u (only if DIFFERENCE)
+ * @param j		The row
+ * @param spotOut	The spot operator applied to the row (without the constant term)
+ * @param varianceOut	The variance operator applied to the row
+ * @param mixedOut	The mixed derivative applied to the row
+ */
+template <bool DIFFERENCE>
+void HestonPde::apply(const double* u, const double* w, int j, double* spotOut, double* varianceOut,
+	double* mixedOut) {
+
+	int m = spots;
+	int row = j * width;
+	int below = (j > 0 ? j - 1 : j) * width;
+	int above = (j < variances ? j + 1 : j) * width;
+
+	#define VALUE(node) (DIFFERENCE ? u[node] - w[node] : u[node])
+
+	const double* spotLower = &spotOperator[0][row];
+	const double* spotDiagonal = &spotOperator[1][row];
+	const double* spotUpper = &spotOperator[2][row];
+	const double* varianceLower = &varianceOperator[0][row];
+	const double* varianceDiagonal = &varianceOperator[1][row];
+	const double* varianceUpper = &varianceOperator[2][row];
+
+	for (int i = 0; i <= m; i++) {
+		double center = VALUE(row + i);
+		double left = i > 0 ? VALUE(row + i - 1) : center;
+		double right = i < m ? VALUE(row + i + 1) : center;
+		spotOut[i] = spotLower[i] * left + spotDiagonal[i] * center + spotUpper[i] * right;
+		varianceOut[i] = varianceLower[i] * VALUE(below + i) + varianceDiagonal[i] * center +
+			varianceUpper[i] * VALUE(above + i);
+		mixedOut[i] = 0.0;
+	}
+
+	if (j == 0 || j == variances)
+		return;
+
+	const double* vw = &varianceWeights[3 * j];
+	for (int i = 1; i < m; i++) {
+		const double* sw = &spotWeights[3 * i];
+		double lower = sw[0] * VALUE(below + i - 1) + sw[1] * VALUE(below + i) + sw[2] * VALUE(below + i + 1);
+		double middle = sw[0] * VALUE(row + i - 1) + sw[1] * VALUE(row + i) + sw[2] * VALUE(row + i + 1);
+		double upper = sw[0] * VALUE(above + i - 1) + sw[1] * VALUE(above + i) + sw[2] * VALUE(above + i + 1);
+		mixedOut[i] = mixed[row + i] * (vw[0] * lower + vw[1] * middle + vw[2] * upper);
+	}
+
+	#undef VALUE
+}
+
+/**
+ * Method used to solve the spot system of a row in place
+ * @param x		The grid, the right hand side on input and the solution on output
+ * @param j		The row
+ */
+void HestonPde::solveRow(double* x, int j) {
+	int row = j * width;
+	double* line = x + row;
+	const double* multiplier = &spotFactor[0][row];
+	const double* inverse = &spotFactor[1][row];
+	const double* upper = &spotFactor[2][row];
+
+	for (int i = 1; i < width; i++)
+		line[i] -= multiplier[i] * line[i - 1];
+	line[width - 1] *= inverse[width - 1];
+	for (int i = width - 2; i >= 0; i--)
+		line[i] = (line[i] - upper[i] * line[i + 1]) * inverse[i];
+}
+
+/**
+ * Method used to solve the variance systems of a block of columns in place, the columns are eliminated
+ * together so every step of the elimination runs over contiguous nodes
+ * @param x		The grid, the right hand side on input and the solution on output
+ * @param first		The first column
+ * @param last		The column after the last one
+ */
+void HestonPde::solveColumns(double* x, int first, int last) {
+	const double* multiplier = &varianceFactor[0][0];
+	const double* inverse = &varianceFactor[1][0];
+	const double* upper = &varianceFactor[2][0];
+
+	for (int j = 1; j <= variances; j++) {
+		int row = j * width;
+		for (int i = first; i < last; i++)
+			x[row + i] -= multiplier[row + i] * x[row - width + i];
+	}
+	int top = variances * width;
+	for (int i = first; i < last; i++)
+		x[top + i] *= inverse[top + i];
+	for (int j = variances - 1; j >= 0; j--) {
+		int row = j * width;
+		for (int i = first; i < last; i++)
+			x[row + i] = (x[row + i] - upper[row + i] * x[row + width + i]) * inverse[row + i];
+	}
+}
+
+/**
+ * Method used to interpolate the grid in a point, with the quadratic through the three nearest nodes of
+ * every direction
+ * @param S		The spot price
+ * @param V		The variance
+ */
+double HestonPde::interpolate(double S, double V) const {
+	int i = (int) (std::upper_bound(s.begin(), s.end(), S) - s.begin());
+	int j = (int) (std::upper_bound(v.begin(), v.end(), V) - v.begin());
+	i = std::min(std::max(i, 1), spots - 1);
+	j = std::min(std::max(j, 1), variances - 1);
+
+	double sw[3], vw[3];
+	interpolationWeights(s, i, S, sw);
+	interpolationWeights(v, j, V, vw);
+
+	double value = 0.0;
+	for (int l = 0; l < 3; l++)
+		for (int k = 0; k < 3; k++)
+			value += vw[l] * sw[k] * solution[(i - 1 + k) + (j - 1 + l) * width];
+	return value;
+}
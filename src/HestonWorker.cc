@@ -14,11 +14,15 @@
  * =====================================================================================
  */
 #include "HestonWorker.h"
+#include "CpuTopology.h"
+#include "InverseNormal.h"
 
 #include <cstdio>
 #include <bbque/utils/utility.h>
 
+#include <algorithm>
 #include <cmath>
+#include <chrono>
 
 /**
  * The constructor of the HestonWorker class
@@ -35,43 +39,79 @@
  */
 HestonWorker::HestonWorker(double S0, double K, double r, double T, double V0, double rho, double kappa, double theta, double xi){
 
-	option = new EuropeanCall(S0, K, r, T);	
+	// The local state is not allocated yet, so the contract does not clear any table
+	local = NULL;
+	setContract(S0, K, r, T, V0, rho, kappa, theta, xi);
 
-	this->V0 = V0;
-	this->rho = rho;
-	this->kappa = kappa;
-	this->theta = theta;
-	this->xi = xi;
+	this->mixing = false;
+	this->singlePrecision = false;
+	this->levels = 1;
+	this->weights[0] = 1.0;
+	this->weights[1] = 0.0;
 
-	//SetUp the Random Number Generator and the Normal extractor 
-	std::random_device device;
-	
-	generator.seed(device());
+	this->cpu = -1;
+	this->node = 0;
+	this->rebind = false;
+
+	// The local state (with its random generator, copied from the chunk at every start) is allocated by the
+	// worker thread at its first chunk, so an idle worker costs no allocation nor generator state
+	local = NULL;
+	localNode = -1;
+
+	progress = NULL;
+	completion = NULL;
+	common = NULL;
+	store = NULL;
+	results = NULL;
+	resultSignal = NULL;
+	payoffs = NULL;
+	task = NULL;
+	hasToWork = false;
+	running = false;
+	done_simulations = 0;
+	pending = false;
+	exiting = false;
+	started = false;
 
 }
 
 /**
- * Distructor of the HestonWorker, used to delete the created option
+ * Distructor of the HestonWorker, it ends the worker thread
  */
 HestonWorker::~HestonWorker() {
-	delete option;
+	{
+		std::lock_guard<std::mutex> lock(control);
+		exiting = true;
+	}
+	wake.notify_one();
+	if (worker.joinable())
+		worker.join();
+	deleteAligned(local);
 }
 
 /**
  * Method used to start a simulation
- * @param simulationToDo	The number of the simulations that a single worker has to do
+ * @param task			The chunk to simulate (a new one, or a stopped one to resume)
  * @param discretization	The value of discretization of the simulation
  */
-void HestonWorker::start(int simulationToDo, int discretization){
+void HestonWorker::start(ChunkTask* task, int discretization){
 	
-	//Set the number of simulations and the discretization level
-	this->todo_simulations = simulationToDo;
+	//Set the chunk and the discretization level
+	this->task = task;
 	this->discretization = discretization;
 	this->done_simulations = 0;
-	this->totalSum = 0;
-	//Start the Worker	
-	worker = std::thread(&HestonWorker::hestonSimulation, this);
+	this->hasToWork = true;
+	this->running = true;
+	this->started = true;
 
+	//Start the Worker, creating its thread the first time
+	{
+		std::lock_guard<std::mutex> lock(control);
+		pending = true;
+		if (!worker.joinable())
+			worker = std::thread(&HestonWorker::loop, this);
+	}
+	wake.notify_one();
 }
 
 /**
@@ -79,21 +119,350 @@ void HestonWorker::start(int simulationToDo, int discretization){
  */
 int HestonWorker::stop(){
 
-	//Wait the Worker ends and return the number of simulations done
-	this->hasToWork = false;
-	//Wait the Thread ends
-		
+	//The worker checks the flag before every simulation, and then it ends keeping the done simulations
+	this->hasToWork.store(false, std::memory_order_relaxed);
 
-	return done_simulations;
+	return getProgress().done;
 
 }
 
 /**
- * Method used to wait a computation of a worker
+ * Method used to wait for the end of the chunk of the worker
  */
 void HestonWorker::join(){
 
-	worker.join();
+	std::unique_lock<std::mutex> lock(control);
+	finished.wait(lock, [this] { return !running.load(std::memory_order_acquire); });
+	started = false;
+}
+
+/**
+ * Method used to know if the worker thread is still computing its chunk
+ */
+bool HestonWorker::isRunning(){
+	return running.load(std::memory_order_acquire);
+}
+
+/**
+ * Method used to know if the worker has been started and not joined yet
+ */
+bool HestonWorker::isStarted(){
+	return started;
+}
+
+/**
+ * Method used to set the signal notified by the worker when it completes (or stops) its chunk
+ * @param completion	The signal shared by all the workers
+ */
+void HestonWorker::setCompletionSignal(CompletionSignal* completion){
+	this->completion = completion;
+}
+
+/**
+ * Method used to select the precision of the simulation. In single precision the paths and the normal draws
+ * are computed with float values (half the memory and twice the SIMD width), while the payoffs are still
+ * accumulated in double precision
+ * @param singlePrecision	True to simulate the paths in single precision
+ */
+void HestonWorker::setSinglePrecision(bool singlePrecision){
+	this->singlePrecision = singlePrecision;
+}
+
+/**
+ * Method used to enable the conditional Monte Carlo (mixing formula) simulation. In this mode only the
+ * volatility path is simulated and the option is priced with its closed form conditional on that path.
+ * If the option has not a closed form, the full Heston simulation is used
+ * @param mixing	True to simulate only the volatility path
+ */
+void HestonWorker::setMixingMode(bool mixing){
+	this->mixing = mixing;
+}
+
+/**
+ * Method used to simulate the paths with a shared block of normals instead of drawing them (common random
+ * numbers). The simulation i of a chunk uses the path i of the block, so the chunk must not be longer
+ * than the block
+ * @param common	The block of normals, or NULL to draw the normals from the chunk substream
+ */
+void HestonWorker::setCommonNormals(const CommonNormals* common){
+	this->common = common;
+}
+
+/**
+ * Method used to change the option and the constant model of the worker. The curves, the dividend yield
+ * included, are the constant values of the contract. It must be called only when the worker is not running
+ * @param S0		The spot price of the option
+ * @param K		The strike price of the option
+ * @param r		The risk-free rate of the option
+ * @param T		The maturity time of the option (in years)
+ * @param V0		The initial volatility of the option
+ * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+ * @param kappa		The mean reversion rate of the Heston Model for the considered option
+ * @param theta		The long-term volatility value
+ * @param xi		The volatility of volatility (V0)
+ */
+void HestonWorker::setContract(double S0, double K, double r, double T, double V0, double rho, double kappa, double theta, double xi){
+
+	option.reset(new EuropeanCall(S0, K, r, T));
+
+	this->V0 = V0;
+	this->rho = rho;
+	this->terms.rate = TermStructure(r);
+	this->terms.dividend = TermStructure(0.0);
+	this->terms.kappa = TermStructure(kappa);
+	this->terms.theta = TermStructure(theta);
+	this->terms.xi = TermStructure(xi);
+	clearTables(0);
+}
+
+/**
+ * Method used to set the time-dependent inputs of the model: the risk-free rate, the dividend yield and
+ * the Heston parameters. They replace the constant values of the constructor, and they are integrated
+ * over the steps of the grid before the first simulation. It must be called only when the worker is not
+ * running
+ * @param terms		The curves of the model
+ */
+void HestonWorker::setTerms(HestonTerms const & terms){
+	this->terms = terms;
+	clearTables(0);
+}
+
+/**
+ * Method used to select the model of the simulation (Heston by default). The jumps of a Bates path are
+ * always drawn from the chunk substream, also with a shared block of normals. It must be called only when
+ * the worker is not running
+ * @param model		The model and its parameters
+ */
+void HestonWorker::setModel(ModelParameters const & model){
+	this->model = model;
+
+	// The second variance factor has constant parameters, its drift table is not used
+	secondTerms.kappa = TermStructure(model.kappa);
+	secondTerms.theta = TermStructure(model.theta);
+	secondTerms.xi = TermStructure(model.xi);
+	clearTables(1);
+}
+
+/**
+ * Method used to set the time grid of the discretization (uniform by default). The grid of a chunk has the
+ * number of steps given at its start. It must be called only when the worker is not running
+ * @param grid		The time grid
+ */
+void HestonWorker::setTimeGrid(TimeGrid const & grid){
+	this->timeGrid = grid;
+	clearTables(0);
+}
+
+/**
+ * Method used to simulate every path also on the refinement of its grid, where every step is split in
+ * two, with the same Brownian increments. The payoffs of a path on the two grids are accumulated with the
+ * given weights: (-1, 2) is the Richardson extrapolation and (-1, 1) the difference of the grids.
+ * A zero fine weight simulates only the grid. It must be called only when the worker is not running
+ * @param coarseWeight	The weight of the payoffs on the grid
+ * @param fineWeight	The weight of the payoffs on the refined grid
+ */
+void HestonWorker::setRefinement(double coarseWeight, double fineWeight){
+	this->levels = (fineWeight != 0.0) ? 2 : 1;
+	this->weights[0] = (fineWeight != 0.0) ? coarseWeight : 1.0;
+	this->weights[1] = fineWeight;
+	clearTables(0);
+}
+
+/**
+ * Method used to invalidate the lookup tables, they are built again before the next simulation
+ * @param firstFactor	The first variance factor to invalidate
+ */
+void HestonWorker::clearTables(int firstFactor){
+	if (!local)
+		return;
+	for (int level = 0; level < MAX_LEVELS; level++) {
+		for (int k = firstFactor; k < MAX_FACTORS; k++) {
+			local->tables[level][k].steps = 0;
+			local->singleTables[level][k].steps = 0;
+		}
+	}
+}
+
+/**
+ * Method used to price other options on the same paths of the option of the worker. The payoffs of the
+ * option k are accumulated in the sum k of the payoffSums (and their squares in the payoffSquares) of the
+ * chunk, which must have one sum for every option (see ChunkTask::setPayoffs)
+ * @param payoffs	The additional options, or NULL to price only the option of the worker
+ */
+void HestonWorker::setPayoffs(std::vector<Option*> const* payoffs){
+	this->payoffs = payoffs;
+}
+
+/**
+ * Method used to write the simulated paths in a store. The simulation i of a chunk writes the paths
+ * 2 * (first + i) and 2 * (first + i) + 1 (the antithetic one), where first is the first simulation of
+ * the chunk in the run. Only the Euler simulation writes the paths, since the conditional one does not
+ * simulate the spot price
+ * @param store		The store, or NULL to not write the paths
+ */
+void HestonWorker::setPathStore(PathStore* store){
+	this->store = store;
+}
+
+/**
+ * Method used to push the result of every completed chunk in a ring, consumed by the aggregator thread.
+ * A stopped chunk is not pushed: it is pushed by the worker that completes it
+ * @param results	The ring of this worker, or NULL to not push the results
+ * @param signal	The signal notified after every push
+ */
+void HestonWorker::setResultRing(ResultRing* results, CompletionSignal* signal){
+	this->results = results;
+	this->resultSignal = signal;
+}
+
+/**
+ * Method used to draw the block of normals of the paths of a chunk, in the precision and in the order
+ * used by the simulation of this worker. Drawing a block from a chunk substream and then simulating the
+ * chunk on the block gives the same result of simulating the chunk directly.
+ * It must be called only when the worker is not running
+ * @param task			The chunk that gives the number of paths and the random substream
+ * @param discretization	The value of discretization of the simulation
+ * @param block			The block to fill
+ */
+void HestonWorker::drawCommonNormals(ChunkTask* task, int discretization, CommonNormals& block){
+
+	// The Euler kernel uses two normals per step and variance factor, the conditional one only the variance normals.
+	// With the refinement the normals are the ones of the refined grid
+	bool conditional = mixing && option->hasConditionalCalculator();
+	int factors = model.type == MODEL_DOUBLE_HESTON ? 2 : 1;
+	int steps = discretization << (levels - 1);
+	block.paths = task->todo;
+	block.stride = conditional ? factors * steps : 2 * factors * steps;
+
+	size_t n = (size_t) block.paths * block.stride;
+	if (singlePrecision) {
+		block.normals.clear();
+		block.singleNormals.resize(n);
+		drawNormals<float>(task->generator, &block.singleNormals[0], n);
+	} else {
+		block.singleNormals.clear();
+		block.normals.resize(n);
+		drawNormals<double>(task->generator, &block.normals[0], n);
+	}
+	task->done = task->todo;
+}
+
+/**
+ * Method used to set the CPU where the worker has to run. The worker thread pins itself on the CPU when it
+ * starts, and it moves its state on the NUMA node of the CPU if the node is changed. A running worker
+ * pins itself on the new CPU at its next publication of the progress
+ * @param cpu	The CPU identifier (a negative value means no pinning)
+ * @param node	The NUMA node of the CPU
+ */
+void HestonWorker::setCpu(int cpu, int node){
+	if (this->cpu.load() == cpu)
+		return;
+
+	this->node = node;
+	this->cpu.store(cpu);
+	this->rebind.store(true);
+}
+
+/**
+ * Method used to set the slot where the worker publishes its progress while it is running
+ * @param progress	The cache-line aligned slot of this worker
+ */
+void HestonWorker::setProgressSlot(ProgressSlot* progress){
+	this->progress = progress;
+}
+
+/**
+ * Method used to read, without waiting, the last progress published by the worker
+ */
+WorkerProgress HestonWorker::getProgress(){
+	WorkerProgress none = {0, 0.0};
+	if (!progress)
+		return none;
+	return progress->read();
+}
+
+/**
+ * Method used to clear the published progress once the result of the worker has been collected.
+ * It must be called only when the worker is not running
+ */
+void HestonWorker::clearProgress(){
+	WorkerProgress none = {0, 0.0};
+	if (progress)
+		progress->publish(none);
+}
+
+/**
+ * Method used by the worker thread to pin itself on the assigned CPU and to move the local state on
+ * the NUMA node of the CPU. The local state is allocated here at the first chunk of the worker
+ */
+void HestonWorker::bindLocalState(){
+
+	rebind.store(false);
+	bool pinned = CpuTopology::pinCurrentThread(cpu.load());
+	if (!local) {
+		local = newAligned<LocalState>();
+		local->metrics = WorkerMetrics();
+		localNode = pinned ? node.load() : -1;
+		return;
+	}
+	if (!pinned || node.load() == localNode)
+		return;
+
+	// The copy is done by the pinned thread, so the new pages are touched first on the local node
+	LocalState* moved = newAligned<LocalState>(*local);
+	deleteAligned(local);
+	local = moved;
+	localNode = node.load();
+}
+
+/**
+ * The thread function: it waits for a chunk, it simulates it and then it waits for the next one
+ */
+void HestonWorker::loop(){
+	std::unique_lock<std::mutex> lock(control);
+	while (true) {
+		wake.wait(lock, [this] { return pending || exiting; });
+		if (!pending)
+			return;
+		pending = false;
+
+		lock.unlock();
+		run();
+		lock.lock();
+	}
+}
+
+/**
+ * Method used to simulate the current chunk and then to notify the completion
+ */
+void HestonWorker::run(){
+
+	METRICS_TRACE("hestonfive: chunk begin %d", task->index);
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+	hestonSimulation();
+
+	std::chrono::duration<double> busy = std::chrono::steady_clock::now() - begin;
+	local->metrics.busySeconds += busy.count();
+	local->metrics.paths += done_simulations;
+	local->metrics.chunks++;
+	METRICS_TRACE("hestonfive: chunk end %d", task->index);
+
+	// The result is handed to the aggregator before the worker is seen as not running
+	if (results && task->completed()) {
+		ChunkResult result = {task->index, task->done, task->sum.get(), local->metrics};
+		results->push(result);
+		resultSignal->notify();
+	}
+
+	// The completion is notified before join() can return, so the signal is never used after it
+	{
+		std::lock_guard<std::mutex> lock(control);
+		running.store(false, std::memory_order_release);
+		if (completion)
+			completion->notify();
+	}
+	finished.notify_all();
 }
 
 /**
@@ -101,124 +470,816 @@ void HestonWorker::join(){
  */
 void HestonWorker::hestonSimulation(){
 
-	double deltaT = (option->getMaturity() / ((double) discretization));
+	bindLocalState();
 
-    	double random_spot;
-    	double random_volatility;
-    	double correlated_random_spot;
-	
-	double antithetic_random_spot;
-	double antithetic_random_volatility;
-    	double antithetic_correlated_random_spot;
-	
-    	double correct_volatility;
-    	double volatility;
-    	double spot_price;
+	// The substream and the accumulator of the chunk are copied in the local state of the worker and
+	// copied back at the end, so a stopped chunk can be resumed by any worker
+	local->generator = task->generator;
+	PairwiseSum sum = task->sum;
+	int first = task->done;
+	int last;
+
+	bool conditional = mixing && option->hasConditionalCalculator();
+
+	// The single precision Euler simulation of the Heston model runs over lanes of paths, the other kernels
+	// (and the refinement and the path store, which need the spot of every step) simulate a path at a time
+	if (singlePrecision && !conditional && model.type == MODEL_HESTON && levels == 1 && !store)
+		last = laneSimulation(first, task->todo, sum);
+	else if (singlePrecision)
+		last = simulate<float>(first, task->todo, sum, conditional);
+	else
+		last = simulate<double>(first, task->todo, sum, conditional);
+
+	task->generator = local->generator;
+	task->sum = sum;
+	task->done = last;
+	done_simulations = last - first;
+	publish(last, sum.get());
+}
+
+/**
+ * Method used to get the buffer for the normal draws of a path in the requested precision
+ */
+template <>
+std::vector<double>& HestonWorker::normalsBuffer<double>(){
+	return local->normals;
+}
 
-    	double antithetic_correct_volatility;
-    	double antithetic_volatility;
-    	double antithetic_spot_price;
+template <>
+std::vector<float>& HestonWorker::normalsBuffer<float>(){
+	return local->singleNormals;
+}
+
+/**
+ * Method used to get the buffer for the jumps of a path in the requested precision
+ */
+template <>
+std::vector<double>& HestonWorker::jumpsBuffer<double>(){
+	return local->jumps;
+}
 
-    	double sum = 0;
+template <>
+std::vector<float>& HestonWorker::jumpsBuffer<float>(){
+	return local->singleJumps;
+}
+
+/**
+ * Method used to get the lookup tables of a variance factor in the requested precision, built for the
+ * current discretization. The curves are integrated only when the grid changes
+ * @param level		The grid (0 for the grid of the discretization, 1 for its refinement)
+ * @param factor	The variance factor (0 for the Heston one)
+ */
+template <>
+StepTables<double>& HestonWorker::stepTables<double>(int level, int factor){
+	StepTables<double>& tables = local->tables[level][factor];
+	if (tables.steps != (discretization << level))
+		buildTables<double>(tables, level, factor);
+	return tables;
+}
+
+template <>
+StepTables<float>& HestonWorker::stepTables<float>(int level, int factor){
+	StepTables<float>& tables = local->singleTables[level][factor];
+	if (tables.steps != (discretization << level))
+		buildTables<float>(tables, level, factor);
+	return tables;
+}
+
+/**
+ * Method used to integrate the inputs of a variance factor over the steps of a grid. With the refinement the
+ * grid is made of every other node of the refined grid, and it keeps the weights of the normals of the two
+ * halves of its steps: the coarse normal is the Brownian increment of the step over its standard deviation
+ * @param tables	The tables to build
+ * @param level		The grid (0 for the grid of the discretization, 1 for its refinement)
+ * @param factor	The variance factor (0 for the Heston one)
+ */
+template <typename Real>
+void HestonWorker::buildTables(StepTables<Real>& tables, int level, int factor){
+
+	std::vector<double> times;
+	std::vector<double> lengths;
+	timeGrid.build(option->getMaturity(), discretization << (levels - 1), times, lengths);
+
+	if (levels > 1 && level == 0) {
+		std::vector<double> coarseTimes;
+		std::vector<double> coarseLengths;
+		TimeGrid::coarsen(times, lengths, coarseTimes, coarseLengths);
+
+		tables.split.resize(2 * discretization);
+		for (int j = 0; j < discretization; j++) {
+			tables.split[2 * j] = (Real) sqrt(lengths[2 * j] / coarseLengths[j]);
+			tables.split[2 * j + 1] = (Real) sqrt(lengths[2 * j + 1] / coarseLengths[j]);
+		}
+		times.swap(coarseTimes);
+		lengths.swap(coarseLengths);
+	}
 
-	for (int i = 0; i < todo_simulations; i++) {
+	tables.build(factor == 0 ? terms : secondTerms, times, lengths);
+}
+
+/**
+ * Method used to compute the normals of the coarse grid from the ones of its refinement: the normal of a
+ * coarse step is the sum of the normals of its halves, weighted by the square roots of their lengths over the
+ * length of the step, so the two grids are driven by the same Brownian increments
+ * @param fine		The normals of the refined grid
+ * @param coarse	The normals of the coarse grid
+ * @param width		The number of normals of every step
+ * @param split		The weights of the normals of the two halves of every coarse step
+ */
+template <typename Real>
+void HestonWorker::coarsenNormals(const Real* fine, Real* coarse, int width, const Real* split){
+	for (int j = 0; j < discretization; j++) {
+		const Real* first = fine + 2 * j * width;
+		const Real* second = first + width;
+		for (int c = 0; c < width; c++)
+			coarse[j * width + c] = split[2 * j] * first[c] + split[2 * j + 1] * second[c];
+	}
+}
+
+/**
+ * Method used to simulate the current chunk with the kernel of the model. Every model has its own instance
+ * of the kernels, so the loops over the factors and the jumps are resolved at compile time
+ * @param first		The first simulation of the chunk to do
+ * @param last		The end of the chunk
+ * @param sum		The accumulator of the chunk
+ * @param conditional	True to use the conditional Monte Carlo simulation
+ */
+template <typename Real>
+int HestonWorker::simulate(int first, int last, PairwiseSum& sum, bool conditional){
+	switch (model.type) {
+	case MODEL_BATES:
+		if (conditional)
+			return mixingSimulation<Real, BatesPolicy>(first, last, sum);
+		return eulerSimulation<Real, BatesPolicy>(first, last, sum);
+	case MODEL_DOUBLE_HESTON:
+		if (conditional)
+			return mixingSimulation<Real, DoubleHestonPolicy>(first, last, sum);
+		return eulerSimulation<Real, DoubleHestonPolicy>(first, last, sum);
+	default:
+		if (conditional)
+			return mixingSimulation<Real, HestonPolicy>(first, last, sum);
+		return eulerSimulation<Real, HestonPolicy>(first, last, sum);
+	}
+}
+
+/**
+ * Method used to draw the jumps of a path and of its antithetic one, summed over every step. All the jumps
+ * of the path are drawn together: their number is Poisson with mean lambda * T (by inversion of one uniform),
+ * then the normals of all the sizes are drawn in bulk and every jump is added to the step of a uniform time.
+ * The antithetic path has the same jumps with the opposite normals
+ * @param generator	The random generator to use
+ * @param jumps		The buffer of the jumps, resized to 2 * steps plus the number of jumps
+ * @param steps		The number of steps of the grid
+ * @param times		The nodes of the grid, or NULL for a uniform grid
+ */
+template <typename Real>
+void HestonWorker::drawJumps(std::mt19937& generator, std::vector<Real>& jumps, int steps, const double* times){
+
+	double mean = model.jumpIntensity * option->getMaturity();
+	double probability = exp(-mean);
+	double cumulative = probability;
+	double u = mean > 0.0 ? uniform<double>(generator) : 0.0;
+	int count = 0;
+	while (u > cumulative && probability > 0.0) {
+		count++;
+		probability *= mean / count;
+		cumulative += probability;
+	}
+
+	jumps.resize(2 * steps + count);
+	std::fill(jumps.begin(), jumps.begin() + 2 * steps, (Real) 0);
+	if (count == 0)
+		return;
+
+	Real* sizes = &jumps[2 * steps];
+	drawNormals<Real>(generator, sizes, count);
+
+	const Real jumpMean = (Real) model.jumpMean;
+	const Real jumpVolatility = (Real) model.jumpVolatility;
+	for (int n = 0; n < count; n++) {
+		double u = uniform<double>(generator);
+		int step;
+		if (times)
+			step = (int) (std::upper_bound(times + 1, times + steps, u * option->getMaturity()) - (times + 1));
+		else
+			step = std::min((int) (u * steps), steps - 1);
+		jumps[step] += jumpMean + jumpVolatility * sizes[n];
+		jumps[steps + step] += jumpMean - jumpVolatility * sizes[n];
+	}
+}
+
+/**
+ * Method used to draw the normals of a block of paths in the requested precision: the uniforms are drawn first,
+ * then they are transformed together with the inverse normal tier of the run
+ * @param generator	The random generator to use
+ * @param normals	The buffer to fill
+ * @param n		The number of normals to draw
+ */
+template <typename Real>
+void HestonWorker::drawNormals(std::mt19937& generator, Real* normals, size_t n){
+	for (size_t k = 0; k < n; k++)
+		normals[k] = uniform<Real>(generator);
+	InverseNormal::transform(normals, n);
+}
+
+/**
+ * Method used to draw a uniform number in (0, 1) in the requested precision.
+ * The single precision uses 23 bits, so the value (k + 0.5) / 2^23 is exact and never rounded to 1
+ */
+template <>
+double HestonWorker::uniform<double>(std::mt19937& generator){
+	return (((double)generator()) + 0.5)*(1.0/4294967296.0);
+}
+
+template <>
+float HestonWorker::uniform<float>(std::mt19937& generator){
+	return (((float)(generator() >> 9)) + 0.5f)*(1.0f/8388608.0f);
+}
+
+/**
+ * The instances of drawNormals() used by the other engines
+ */
+template void HestonWorker::drawNormals<double>(std::mt19937& generator, double* normals, size_t n);
+template void HestonWorker::drawNormals<float>(std::mt19937& generator, float* normals, size_t n);
+
+/**
+ * Method used to do the Euler simulation of the spot price and of the variance factors of a model.
+ * Every factor k has its own spot driver, correlated with its variance normal:
+ *	v_k	+= kappa_k * (theta_k - v_k) * dt + xi_k * sqrt(v_k * dt) * Zv_k
+ *	log(S)	+= (r - q - lambda * m) * dt + sum_k (-0.5 * v_k * dt + sqrt(v_k * dt) * (rho_k * Zv_k + sqrt(1 - rho_k^2) * Zs_k)) + J
+ * where J are the jumps of the step and lambda * m their compensator (only for the models with jumps), and dt
+ * is the length of the step in the time grid. With the refinement every path is simulated on the refined grid
+ * and then on the grid, with the same Brownian increments, and its payoff is the weighted sum of the two.
+ * The state of the paths is kept in the Real precision, while the payoffs are always accumulated in double
+ * precision with a pairwise sum. It returns the index of the first simulation not done (it is less than
+ * last if the worker has been stopped)
+ * @param first		The first simulation of the chunk to do
+ * @param last		The end of the chunk
+ * @param sum		The accumulator of the chunk
+ */
+template <typename Real, typename Model>
+int HestonWorker::eulerSimulation(int first, int last, PairwiseSum& sum){
+
+	const int FACTORS = Model::FACTORS;
+	const int WIDTH = 2 * FACTORS;
+
+	std::mt19937& generator = local->generator;
+	WorkerMetrics& metrics = local->metrics;
+
+	// The normal draws of a whole path, allocated by the worker thread on its NUMA node. With the refinement
+	// they are drawn on the refined grid, and they are followed by the normals of the coarse grid
+	const int fineSteps = discretization << (levels - 1);
+	std::vector<Real>& normals = normalsBuffer<Real>();
+	normals.resize(WIDTH * (fineSteps + (levels > 1 ? discretization : 0)));
+	Real* coarse = normals.data() + WIDTH * fineSteps;
+	std::vector<Real>& jumps = jumpsBuffer<Real>();
+
+	const Real compensator = (Real) (Model::JUMPS ? model.jumpCompensator() : 0.0);
+	const double* jumpTimes = timeGrid.isUniform() ? NULL : &stepTables<Real>(levels - 1, 0).times[0];
+
+	// The inputs of every step are read from the tables, a constant model has constant tables
+	StepTables<Real>* tables[MAX_LEVELS][FACTORS];
+	Real rho[FACTORS];
+	Real rhoComplement[FACTORS];
+	Real initial[FACTORS];
+	for (int k = 0; k < FACTORS; k++) {
+		for (int level = 0; level < levels; level++)
+			tables[level][k] = &stepTables<Real>(level, k);
+		rho[k] = (Real) (k == 0 ? this->rho : model.rho);
+		rhoComplement[k] = std::sqrt(1 - rho[k] * rho[k]);
+		initial[k] = (Real) (k == 0 ? V0 : model.V0);
+	}
+	const Real* split = levels > 1 ? &tables[0][0]->split[0] : NULL;
+
+	const Real* deltaT;
+	const Real* drift;
+	const Real* reversion[FACTORS];
+	const Real* theta[FACTORS];
+	const Real* xi[FACTORS];
+
+    	Real random_spot;
+    	Real random_volatility;
+    	Real correlated_random_spot;
 	
-        	volatility = V0;
-        	spot_price = option->getSpotPrice();
+	Real antithetic_random_spot;
+	Real antithetic_random_volatility;
+    	Real antithetic_correlated_random_spot;
 	
-		antithetic_volatility = volatility;
-		antithetic_spot_price = spot_price;
+    	Real correct_volatility;
+    	Real volatility[FACTORS];
+    	Real spot_price;
+	Real increment;
 
-		for (int j = 0; j < discretization; j++) {
+    	Real antithetic_correct_volatility;
+    	Real antithetic_volatility[FACTORS];
+    	Real antithetic_spot_price;
+	Real antithetic_increment;
+
+	double terminal[MAX_LEVELS];
+	double antithetic_terminal[MAX_LEVELS];
+	double payoff;
+
+	int i;
+
+	for (i = first; i < last; i++) {
+
+		// Cancellation point: a stopped worker keeps the simulations already done
+		if (!hasToWork.load(std::memory_order_relaxed))
+			break;
+
+		METRICS_TIMER_START(timer);
+
+		// Draw all the normals of the path, in the same order used by the steps (or read the shared ones)
+		const Real* path;
+		if (common) {
+			path = common->path<Real>(i);
+		} else {
+			drawNormals<Real>(generator, &normals[0], WIDTH * fineSteps);
+			path = &normals[0];
+		}
+		if (Model::JUMPS)
+			drawJumps<Real>(generator, jumps, fineSteps, jumpTimes);
+		if (levels > 1)
+			coarsenNormals<Real>(path, coarse, WIDTH, split);
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_RNG);
+
+		uint64_t stored = 2 * ((uint64_t) task->first + i);
+
+		// The refined grid is simulated first, then its jumps are summed over the steps of the grid
+		for (int level = levels - 1; level >= 0; level--) {
+
+			const int steps = discretization << level;
+			const Real* normal = (level == levels - 1) ? path : coarse;
+			deltaT = &tables[level][0]->deltaT[0];
+			drift = &tables[level][0]->drift[0];
+			for (int k = 0; k < FACTORS; k++) {
+				reversion[k] = &tables[level][k]->reversion[0];
+				theta[k] = &tables[level][k]->theta[0];
+				xi[k] = &tables[level][k]->xi[0];
+			}
+			if (Model::JUMPS && level < levels - 1) {
+				for (int j = 0; j < steps; j++)
+					jumps[j] = jumps[2 * j] + jumps[2 * j + 1];
+				for (int j = 0; j < steps; j++)
+					jumps[steps + j] = jumps[2 * steps + 2 * j] + jumps[2 * steps + 2 * j + 1];
+			}
+
+        		spot_price = (Real) option->getSpotPrice();
+			antithetic_spot_price = spot_price;
+
+			for (int k = 0; k < FACTORS; k++) {
+				volatility[k] = initial[k];
+				antithetic_volatility[k] = initial[k];
+			}
+
+			for (int j = 0; j < steps; j++) {
+
+				increment = Model::JUMPS ? drift[j] - compensator * deltaT[j] : drift[j];
+				antithetic_increment = increment;
 
-			random_spot = normalCDFInverse((((double)generator())+ 0.5)*(1.0/4294967296.0));             				/**<Random Number with uniform distribution*/
-			random_volatility = normalCDFInverse((((double)generator()) + 0.5)*(1.0/4294967296.0));  					/**<Random Number with uniform distribution*/
+				for (int k = 0; k < FACTORS; k++) {
 
-			antithetic_random_spot = -random_spot;					/**<Antithetic Random Number with uniform distribution*/
-			antithetic_random_volatility = -random_volatility;			/**<Antithetic Random Number with uniform distribution*/ 		
-			correlated_random_spot = (rho * random_volatility) + (random_spot * sqrt(1 - rho * rho));       
-				/**<Correlation between the two Normal Distribution*/
-			antithetic_correlated_random_spot = (rho * antithetic_random_volatility) + (antithetic_random_spot * sqrt(1 - rho * rho));
-				/**<Correlation between the two Antithetic Normal Distribution*/
-		 	
-			correct_volatility = maxValue(volatility, 0.0);     	/**<Value for sqrt use, then it must be positive*/
-			antithetic_correct_volatility = maxValue(antithetic_volatility , 0.0);	
+					random_spot = normal[WIDTH * j + 2 * k];
+					random_volatility = normal[WIDTH * j + 2 * k + 1];
 
-			volatility = volatility +  kappa * deltaT * (theta - correct_volatility) + xi * sqrt(correct_volatility * deltaT) * random_volatility;
-			    /**<Calculating volatility value in time using Euler discretization*/
+					antithetic_random_spot = -random_spot;					/**<Antithetic Random Number with uniform distribution*/
+					antithetic_random_volatility = -random_volatility;			/**<Antithetic Random Number with uniform distribution*/ 		
+					correlated_random_spot = (rho[k] * random_volatility) + (random_spot * rhoComplement[k]);
+						/**<Correlation between the two Normal Distribution*/
+					antithetic_correlated_random_spot = (rho[k] * antithetic_random_volatility) + (antithetic_random_spot * rhoComplement[k]);
+						/**<Correlation between the two Antithetic Normal Distribution*/
 
-			spot_price = spot_price * exp( (option->getRiskFreeRate() - 0.5 * correct_volatility) * deltaT + sqrt(correct_volatility * deltaT) * correlated_random_spot);
-			    /**<Calculating spot price value in time using Euler discretization*/
+					correct_volatility = maxValue(volatility[k], (Real) 0);     	/**<Value for sqrt use, then it must be positive*/
+					antithetic_correct_volatility = maxValue(antithetic_volatility[k], (Real) 0);
 
+					volatility[k] = volatility[k] +  reversion[k][j] * (theta[k][j] - correct_volatility) + xi[k][j] * std::sqrt(correct_volatility * deltaT[j]) * random_volatility;
+					    /**<Calculating volatility value in time using Euler discretization*/
 
-			antithetic_volatility = antithetic_volatility +  kappa * deltaT * (theta - antithetic_correct_volatility) + xi * sqrt(antithetic_correct_volatility * deltaT) * antithetic_random_volatility;
-			    /**<Calculating antithetic volatility value in time using Euler discretization*/
+					increment = increment - (Real) 0.5 * correct_volatility * deltaT[j] + std::sqrt(correct_volatility * deltaT[j]) * correlated_random_spot;
+					    /**<Calculating the log spot increment of the factor using Euler discretization*/
 
-			antithetic_spot_price = antithetic_spot_price * exp( (option->getRiskFreeRate() - 0.5 * antithetic_correct_volatility) * deltaT + sqrt(antithetic_correct_volatility * deltaT) * antithetic_correlated_random_spot);
-			    /**<Calculating antithetic spot price value in time using Euler discretization*/
+					antithetic_volatility[k] = antithetic_volatility[k] +  reversion[k][j] * (theta[k][j] - antithetic_correct_volatility) + xi[k][j] * std::sqrt(antithetic_correct_volatility * deltaT[j]) * antithetic_random_volatility;
+					    /**<Calculating antithetic volatility value in time using Euler discretization*/
+
+					antithetic_increment = antithetic_increment - (Real) 0.5 * antithetic_correct_volatility * deltaT[j] + std::sqrt(antithetic_correct_volatility * deltaT[j]) * antithetic_correlated_random_spot;
+					    /**<Calculating the antithetic log spot increment of the factor using Euler discretization*/
+				}
+
+				if (Model::JUMPS) {
+					increment += jumps[j];
+					antithetic_increment += jumps[steps + j];
+				}
+
+				spot_price = spot_price * std::exp(increment);
+				antithetic_spot_price = antithetic_spot_price * std::exp(antithetic_increment);
+
+				if (store && level == 0) {
+					// The stored variance is the sum of the factors
+					Real variance = volatility[0];
+					Real antithetic_variance = antithetic_volatility[0];
+					for (int k = 1; k < FACTORS; k++) {
+						variance += volatility[k];
+						antithetic_variance += antithetic_volatility[k];
+					}
+					store->record(j, stored, spot_price, variance);
+					store->record(j, stored + 1, antithetic_spot_price, antithetic_variance);
+				}
 
 			}
+
+			terminal[level] = spot_price;
+			antithetic_terminal[level] = antithetic_spot_price;
+		}
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_KERNEL);
 	
-	    done_simulations++;		
-	    sum = sum + option->optionCalculator(spot_price) + option->optionCalculator(antithetic_spot_price);   
+		payoff = 0.0;
+		for (int level = 0; level < levels; level++)
+			payoff += weights[level] * (option->optionCalculator(terminal[level]) + option->optionCalculator(antithetic_terminal[level]));
+		sum.add(payoff);
+		task->squares.add(payoff * payoff);
 								/** This line aims to calculate the simulated option value using a Option function, 
 		                                                *   in this way we can personalize the option payoff.
 		                                                */
+		if (payoffs)
+			addPayoffs(terminal, antithetic_terminal);
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_PAYOFF);
+
+		if ((i + 1) % PUBLISH_PERIOD == 0) {
+			publish(i + 1, sum.get());
+			METRICS_TIMER_LAP(timer, metrics, PHASE_REDUCTION);
+		}
 	    }
 
-	    totalSum += sum;
+	    return i;
 
 }
 
 
 /**
- * Method used to calculate an approximation of the passed value
- * @param t		The number to approximate	
+ * Method used to do the single precision Euler simulation of the Heston model LANES paths at a time. The
+ * normals of every path are drawn (or read) in the order of eulerSimulation(), so a path consumes the same
+ * random numbers, and then they are stored by step and by lane: every step updates the LANES paths and their
+ * antithetic ones with the same inputs of the tables. The lanes carry the logarithm of the spot, so a step has
+ * no exponential and the loop over the lanes has only multiplications and square roots (vectorized, since the
+ * file is compiled without errno for the math functions). The cancellation is checked before every block
+ * @param first		The first simulation of the chunk to do
+ * @param last		The end of the chunk
+ * @param sum		The accumulator of the chunk
  */
-double HestonWorker::rationalApproximation(double t){
+int HestonWorker::laneSimulation(int first, int last, PairwiseSum& sum){
+
+	std::mt19937& generator = local->generator;
+	WorkerMetrics& metrics = local->metrics;
+
+	const int steps = discretization;
+	std::vector<float>& normals = normalsBuffer<float>();
+	normals.resize(2 * steps);
+	std::vector<float>& laneNormals = local->laneNormals;
+	laneNormals.resize(2 * steps * LANES);
+
+	StepTables<float>& tables = stepTables<float>(0, 0);
+	const float* deltaT = &tables.deltaT[0];
+	const float* drift = &tables.drift[0];
+	const float* reversion = &tables.reversion[0];
+	const float* theta = &tables.theta[0];
+	const float* xi = &tables.xi[0];
+	const float rho = (float) this->rho;
+	const float rhoComplement = std::sqrt(1 - rho * rho);
+	const float initial = (float) V0;
+	const float logSpot = (float) log(option->getSpotPrice());
+
+	float spot[LANES];		/**< The logarithm of the spot */
+	float volatility[LANES];
+	float antithetic_spot[LANES];
+	float antithetic_volatility[LANES];
+
+	double terminal[MAX_LEVELS];
+	double antithetic_terminal[MAX_LEVELS];
+	double payoff;
+
+	int i;
+
+	for (i = first; i < last; i += LANES) {
+
+		// Cancellation point: a stopped worker keeps the blocks already done
+		if (!hasToWork.load(std::memory_order_relaxed))
+			break;
+
+		METRICS_TIMER_START(timer);
+
+		// The lanes after the end of the chunk simulate zero normals, and their payoffs are not added
+		const int active = std::min(LANES, last - i);
+		for (int p = 0; p < LANES; p++) {
+			const float* path;
+			if (p >= active) {
+				std::fill(normals.begin(), normals.end(), 0.0f);
+				path = &normals[0];
+			} else if (common) {
+				path = common->path<float>(i + p);
+			} else {
+				drawNormals<float>(generator, &normals[0], 2 * steps);
+				path = &normals[0];
+			}
+			for (int n = 0; n < 2 * steps; n++)
+				laneNormals[n * LANES + p] = path[n];
+		}
 
-   // Abramowitz and Stegun formula 26.2.23.
-    // The absolute value of the error should be less than 4.5 e-4.
-    double c[] = {2.515517, 0.802853, 0.010328};
-    double d[] = {1.432788, 0.189269, 0.001308};
-    return t - ((c[2]*t + c[1])*t + c[0]) /
-                (((d[2]*t + d[1])*t + d[0])*t + 1.0);
+		METRICS_TIMER_LAP(timer, metrics, PHASE_RNG);
+
+		for (int p = 0; p < LANES; p++) {
+			spot[p] = logSpot;
+			volatility[p] = initial;
+			antithetic_spot[p] = logSpot;
+			antithetic_volatility[p] = initial;
+		}
+
+		for (int j = 0; j < steps; j++) {
+			const float* random_spot = &laneNormals[2 * j * LANES];
+			const float* random_volatility = random_spot + LANES;
+			const float dT = deltaT[j];
+			const float mu = drift[j];
+			const float k = reversion[j];
+			const float th = theta[j];
+			const float x = xi[j];
+
+			for (int p = 0; p < LANES; p++) {
+				float correlated = rho * random_volatility[p] + rhoComplement * random_spot[p];
+
+				float correct_volatility = std::max(volatility[p], 0.0f);
+				float diffusion = std::sqrt(correct_volatility * dT);
+				volatility[p] += k * (th - correct_volatility) + x * diffusion * random_volatility[p];
+				spot[p] += mu - 0.5f * correct_volatility * dT + diffusion * correlated;
+
+				correct_volatility = std::max(antithetic_volatility[p], 0.0f);
+				diffusion = std::sqrt(correct_volatility * dT);
+				antithetic_volatility[p] += k * (th - correct_volatility) - x * diffusion * random_volatility[p];
+				antithetic_spot[p] += mu - 0.5f * correct_volatility * dT - diffusion * correlated;
+			}
+		}
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_KERNEL);
+
+		for (int p = 0; p < active; p++) {
+			terminal[0] = exp((double) spot[p]);
+			antithetic_terminal[0] = exp((double) antithetic_spot[p]);
+			payoff = weights[0] * (option->optionCalculator(terminal[0]) + option->optionCalculator(antithetic_terminal[0]));
+			sum.add(payoff);
+			task->squares.add(payoff * payoff);
+			if (payoffs)
+				addPayoffs(terminal, antithetic_terminal);
+		}
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_PAYOFF);
+
+		if ((i + active) / PUBLISH_PERIOD != i / PUBLISH_PERIOD) {
+			publish(i + active, sum.get());
+			METRICS_TIMER_LAP(timer, metrics, PHASE_REDUCTION);
+		}
+	}
+
+	return std::min(i, last);
+}
+
+/**
+ * Method used to do a conditional Monte Carlo simulation: only the variance factors (and the jumps) are
+ * simulated, while the spot is integrated analytically (Willard mixing formula).
+ * Conditional on the variance paths and on the jumps, log(S_T) is normal and the option has a Black-Scholes
+ * price with
+ *	forward		= S0 * exp((r - q - lambda * m) * T + sum_k (rho_k * int(sqrt(V_k) dW_k) - 0.5 * rho_k^2 * int(V_k dt)) + J)
+ *	total variance	= sum_k (1 - rho_k^2) * int(V_k dt)
+ * With the refinement the variance paths are simulated on the refined grid and on the grid, with the same
+ * Brownian increments, and the conditional payoff is the weighted sum of the two.
+ * The variance paths are kept in the Real precision, while the integrals and the payoffs are accumulated in
+ * double precision
+ * @param first		The first simulation of the chunk to do
+ * @param last		The end of the chunk
+ * @param sum		The accumulator of the chunk
+ */
+template <typename Real, typename Model>
+int HestonWorker::mixingSimulation(int first, int last, PairwiseSum& sum){
+
+	const int FACTORS = Model::FACTORS;
+
+	std::mt19937& generator = local->generator;
+	WorkerMetrics& metrics = local->metrics;
+
+	const int fineSteps = discretization << (levels - 1);
+	std::vector<Real>& normals = normalsBuffer<Real>();
+	normals.resize(FACTORS * (fineSteps + (levels > 1 ? discretization : 0)));
+	Real* coarse = normals.data() + FACTORS * fineSteps;
+	std::vector<Real>& jumps = jumpsBuffer<Real>();
+
+	double drift = terms.rate.integral(0.0, option->getMaturity()) - terms.dividend.integral(0.0, option->getMaturity());
+	double compensator = Model::JUMPS ? model.jumpCompensator() * option->getMaturity() : 0.0;
+
+	StepTables<Real>* tables[MAX_LEVELS][FACTORS];
+	double rho[FACTORS];
+	Real initial[FACTORS];
+	for (int k = 0; k < FACTORS; k++) {
+		for (int level = 0; level < levels; level++)
+			tables[level][k] = &stepTables<Real>(level, k);
+		rho[k] = k == 0 ? this->rho : model.rho;
+		initial[k] = (Real) (k == 0 ? V0 : model.V0);
+	}
+	const Real* split = levels > 1 ? &tables[0][0]->split[0] : NULL;
+
+	const Real* deltaT;
+	const Real* reversion;
+	const Real* theta;
+	const Real* xi;
+
+	Real random_volatility;
+
+	Real correct_volatility;
+	Real volatility;
+	Real volatility_increment;
+	double integrated_variance[FACTORS];
+	double volatility_integral[FACTORS];
+
+	Real antithetic_correct_volatility;
+	Real antithetic_volatility;
+	Real antithetic_volatility_increment;
+	double antithetic_integrated_variance[FACTORS];
+	double antithetic_volatility_integral[FACTORS];
+
+	double exponent;
+	double variance[MAX_LEVELS];
+	double forward[MAX_LEVELS];
+	double antithetic_exponent;
+	double antithetic_variance[MAX_LEVELS];
+	double antithetic_forward[MAX_LEVELS];
+	double payoff;
+
+	int i;
+
+	for (i = first; i < last; i++) {
+
+		// Cancellation point: a stopped worker keeps the simulations already done
+		if (!hasToWork.load(std::memory_order_relaxed))
+			break;
+
+		METRICS_TIMER_START(timer);
+
+		// The only random numbers of each step are the variance ones, the jumps are summed over the path
+		const Real* path;
+		if (common) {
+			path = common->path<Real>(i);
+		} else {
+			drawNormals<Real>(generator, &normals[0], FACTORS * fineSteps);
+			path = &normals[0];
+		}
+		if (Model::JUMPS)
+			drawJumps<Real>(generator, jumps, 1, NULL);
+		if (levels > 1)
+			coarsenNormals<Real>(path, coarse, FACTORS, split);
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_RNG);
+
+		for (int level = 0; level < levels; level++) {
+
+			const int steps = discretization << level;
+			const Real* normal = (level == levels - 1) ? path : coarse;
+
+			for (int k = 0; k < FACTORS; k++) {
+
+				deltaT = &tables[level][k]->deltaT[0];
+				reversion = &tables[level][k]->reversion[0];
+				theta = &tables[level][k]->theta[0];
+				xi = &tables[level][k]->xi[0];
+
+				volatility = initial[k];
+				antithetic_volatility = initial[k];
+
+				integrated_variance[k] = 0.0;
+				volatility_integral[k] = 0.0;
+				antithetic_integrated_variance[k] = 0.0;
+				antithetic_volatility_integral[k] = 0.0;
+
+				for (int j = 0; j < steps; j++) {
+
+					random_volatility = normal[FACTORS * j + k];
+
+					correct_volatility = maxValue(volatility, (Real) 0);
+					antithetic_correct_volatility = maxValue(antithetic_volatility, (Real) 0);
+
+					volatility_increment = std::sqrt(correct_volatility * deltaT[j]) * random_volatility;
+					antithetic_volatility_increment = -std::sqrt(antithetic_correct_volatility * deltaT[j]) * random_volatility;
+
+					integrated_variance[k] += correct_volatility * deltaT[j];
+					volatility_integral[k] += volatility_increment;
+
+					antithetic_integrated_variance[k] += antithetic_correct_volatility * deltaT[j];
+					antithetic_volatility_integral[k] += antithetic_volatility_increment;
+
+					volatility = volatility + reversion[j] * (theta[j] - correct_volatility) + xi[j] * volatility_increment;
+					antithetic_volatility = antithetic_volatility + reversion[j] * (theta[j] - antithetic_correct_volatility) + xi[j] * antithetic_volatility_increment;
+				}
+			}
+
+			exponent = drift - compensator;
+			antithetic_exponent = exponent;
+			variance[level] = 0.0;
+			antithetic_variance[level] = 0.0;
+			for (int k = 0; k < FACTORS; k++) {
+				exponent = exponent + rho[k] * volatility_integral[k] - 0.5 * rho[k] * rho[k] * integrated_variance[k];
+				antithetic_exponent = antithetic_exponent + rho[k] * antithetic_volatility_integral[k] - 0.5 * rho[k] * rho[k] * antithetic_integrated_variance[k];
+				variance[level] += (1 - rho[k] * rho[k]) * integrated_variance[k];
+				antithetic_variance[level] += (1 - rho[k] * rho[k]) * antithetic_integrated_variance[k];
+			}
+			if (Model::JUMPS) {
+				exponent += jumps[0];
+				antithetic_exponent += jumps[1];
+			}
+
+			forward[level] = option->getSpotPrice() * exp(exponent);
+			antithetic_forward[level] = option->getSpotPrice() * exp(antithetic_exponent);
+		}
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_KERNEL);
+
+		payoff = 0.0;
+		for (int level = 0; level < levels; level++)
+			payoff += weights[level] * (option->conditionalCalculator(forward[level], variance[level])
+				+ option->conditionalCalculator(antithetic_forward[level], antithetic_variance[level]));
+		sum.add(payoff);
+		task->squares.add(payoff * payoff);
+		if (payoffs)
+			addConditionalPayoffs(forward, variance, antithetic_forward, antithetic_variance);
+
+		METRICS_TIMER_LAP(timer, metrics, PHASE_PAYOFF);
+
+		if ((i + 1) % PUBLISH_PERIOD == 0) {
+			publish(i + 1, sum.get());
+			METRICS_TIMER_LAP(timer, metrics, PHASE_REDUCTION);
+		}
+	}
+
+	return i;
+}
+
+/**
+ * Method used to add the payoffs of the additional options for the terminal spots of a simulation, weighted
+ * over the grids
+ * @param spot		The terminal spot price on every grid
+ * @param antithetic	The terminal spot price of the antithetic path on every grid
+ */
+void HestonWorker::addPayoffs(const double* spot, const double* antithetic){
+	for (size_t k = 0; k < payoffs->size(); k++) {
+		double payoff = 0.0;
+		for (int level = 0; level < levels; level++)
+			payoff += weights[level] * ((*payoffs)[k]->optionCalculator(spot[level])
+				+ (*payoffs)[k]->optionCalculator(antithetic[level]));
+		task->payoffSums[k].add(payoff);
+		task->payoffSquares[k].add(payoff * payoff);
+	}
 }
 
 /**
- * Method used to calculate the inverse of the standard normal function
- * @param p		A value between 0 and 1 (exclused) that represents a value of a standard normal distribution
+ * Method used to add the conditional payoffs of the additional options for a simulation, weighted over
+ * the grids
+ * @param forward		The forward conditional on the volatility path on every grid
+ * @param variance		The total variance conditional on the volatility path on every grid
+ * @param antithetic_forward	The forward conditional on the antithetic volatility path on every grid
+ * @param antithetic_variance	The total variance conditional on the antithetic volatility path on every grid
  */
-double HestonWorker::normalCDFInverse(double p){
+void HestonWorker::addConditionalPayoffs(const double* forward, const double* variance,
+		const double* antithetic_forward, const double* antithetic_variance){
+	for (size_t k = 0; k < payoffs->size(); k++) {
+		double payoff = 0.0;
+		for (int level = 0; level < levels; level++)
+			payoff += weights[level] * ((*payoffs)[k]->conditionalCalculator(forward[level], variance[level])
+				+ (*payoffs)[k]->conditionalCalculator(antithetic_forward[level], antithetic_variance[level]));
+		task->payoffSums[k].add(payoff);
+		task->payoffSquares[k].add(payoff * payoff);
+	}
+}
 
-    if (p <= 0.0 || p >= 1.0)
-    {
-/*
-        stringstream os;
-        os << "Invalid input argument (" << p
-        << "); must be larger than 0 but less than 1.";
-        throw invalid_argument( os.str() );
-*/
-	return -1;
-    }
- 
-    if (p < 0.5)
-    {
-        // F^-1(p) = - G^-1(p)
-        return -rationalApproximation( sqrt(-2.0*log(p)) );
-    }
-    else
-    {
-        // F^-1(p) = G^-1(1-p)
-        return rationalApproximation( sqrt(-2.0*log(1-p)) );
-    }
+/**
+ * Method used by the worker thread to publish its progress. It is also the point where the worker
+ * moves on a new CPU assigned while it is running
+ * @param done		The simulations done in the current chunk
+ * @param sum		The sum of the payoffs of the done simulations
+ */
+void HestonWorker::publish(int done, double sum){
+	if (progress) {
+		WorkerProgress current = {done, sum};
+		progress->publish(current);
+	}
+	if (rebind.load(std::memory_order_relaxed)) {
+		rebind.store(false);
+		CpuTopology::pinCurrentThread(cpu.load());
+	}
 }
 
 /**
- * Method used to get the calculated value stored in the worker
+ * Method used to get the chunk of the last simulation: after join() it contains the done simulations and
+ * their sum
  */
-double HestonWorker::getCalculus(){
-	return totalSum;
+ChunkTask* HestonWorker::getTask(){
+	return task;
 }
 
 /**
@@ -228,6 +1289,16 @@ int HestonWorker::getSimulationsDone(){
 	return done_simulations;
 }
 
+/**
+ * Method used to get the metrics of the worker, accumulated over all its chunks.
+ * It must be called only when the worker is not running
+ */
+WorkerMetrics HestonWorker::getMetrics(){
+	if (!local)
+		return WorkerMetrics();
+	return local->metrics;
+}
+
 /**
  * Method used to get the max given to values
  * @param x	The first parameter to check
@@ -240,5 +1311,14 @@ double HestonWorker::maxValue(double x, double y) {
 		return y;
 }
 
-
-
+/**
+ * Method used to get the max given to values, in single precision
+ * @param x	The first parameter to check
+ * @param y	The second parameter to check
+ */
+float HestonWorker::maxValue(float x, float y) {
+	if(x > y)
+		return x;
+	else
+		return y;
+}
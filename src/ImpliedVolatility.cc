@@ -0,0 +1,216 @@
+/**
+ *       @file  ImpliedVolatility.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The inversion of the Black-Scholes formula. The prices of a batch are inverted together, in arrays of
+ *		structures of the same field: every point is normalized (log-moneyness and out of the money price),
+ *		it starts from a rational initial guess and it is refined by the same fixed number of Householder
+ *		steps, so the loops over the points have no data dependent exit and almost no branch
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "ImpliedVolatility.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double SQRT_TWO_PI = 2.506628274631000502;
+const double ONE_OVER_SQRT_TWO = 0.707106781186547524;
+
+/**
+ * The cumulative distribution function of a standard normal
+ */
+inline double normalCDF(double z) {
+	return 0.5 * erfc(-z * ONE_OVER_SQRT_TWO);
+}
+
+/**
+ * The normalized out of the money call b(x, s) = exp(x/2) N(x/s + s/2) - exp(-x/2) N(x/s - s/2), with x <= 0
+ */
+inline double normalizedCall(double x, double s) {
+	double h = x / s;
+	double t = 0.5 * s;
+	return exp(0.5 * x) * normalCDF(h + t) - exp(-0.5 * x) * normalCDF(h - t);
+}
+
+}
+
+/**
+ * Method used to compute the undiscounted Black-Scholes price of an option
+ * @param forward	The forward of the underlying at the maturity
+ * @param strike	The strike price of the option
+ * @param volatility	The volatility of the underlying
+ * @param maturity	The maturity time (in years) of the option
+ * @param call		True for a call, false for a put
+ */
+double ImpliedVolatility::blackPrice(double forward, double strike, double volatility, double maturity, bool call) {
+	double theta = call ? 1.0 : -1.0;
+	double s = volatility * sqrt(maturity);
+	if (s <= 0.0)
+		return std::max(theta * (forward - strike), 0.0);
+
+	double d1 = log(forward / strike) / s + 0.5 * s;
+	double d2 = d1 - s;
+	return theta * (forward * normalCDF(theta * d1) - strike * normalCDF(theta * d2));
+}
+
+/**
+ * Method used to invert a single price
+ * @param price		The undiscounted price of the option
+ * @param forward	The forward of the underlying at the maturity
+ * @param strike	The strike price of the option
+ * @param maturity	The maturity time (in years) of the option
+ * @param call		True for a call, false for a put
+ */
+double ImpliedVolatility::invert(double price, double forward, double strike, double maturity, bool call) {
+	VolatilityBatch batch;
+	batch.add(price, forward, strike, maturity, call);
+	std::vector<double> volatilities;
+	invert(batch, volatilities);
+	return volatilities[0];
+}
+
+/**
+ * Method used to invert all the prices of a batch. The points are normalized, inverted and converted back in
+ * blocks of BLOCK points, so the arrays of a block stay in the L1 cache between the steps
+ * @param batch		The prices to invert
+ * @param volatilities	The implied volatilities, resized to the size of the batch
+ */
+void ImpliedVolatility::invert(VolatilityBatch const & batch, std::vector<double> & volatilities) {
+
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	size_t n = batch.size();
+	volatilities.resize(n);
+
+	double x[BLOCK];
+	double beta[BLOCK];
+	double s[BLOCK];
+	bool valid[BLOCK];
+	bool intrinsic[BLOCK];
+
+	for (size_t first = 0; first < n; first += BLOCK) {
+		int count = (int) std::min((size_t) BLOCK, n - first);
+
+		// Normalization: the price over sqrt(F*K), without the intrinsic value, is the out of the money
+		// call with log-moneyness -|ln(F/K)| (put-call parity and symmetry of the normalized price)
+		for (int i = 0; i < count; i++) {
+			size_t k = first + i;
+			double forward = batch.forwards[k];
+			double strike = batch.strikes[k];
+			double logMoneyness = log(forward / strike);
+			double theta = batch.calls[k] ? 1.0 : -1.0;
+			double value = std::max(theta * (exp(0.5 * logMoneyness) - exp(-0.5 * logMoneyness)), 0.0);
+
+			double price = batch.prices[k] / sqrt(forward * strike);
+			double rounding = 4.0 * DBL_EPSILON * price;
+
+			x[i] = -fabs(logMoneyness);
+			beta[i] = price - value;
+			valid[i] = forward > 0.0 && strike > 0.0 && batch.maturities[k] > 0.0 &&
+				beta[i] >= -rounding && beta[i] < exp(0.5 * x[i]);
+
+			// An invalid point, or a price equal to the intrinsic value up to the rounding (zero volatility),
+			// is inverted on a harmless price and replaced at the end
+			intrinsic[i] = valid[i] && beta[i] <= rounding;
+			if (!valid[i] || intrinsic[i]) {
+				x[i] = 0.0;
+				beta[i] = 0.5;
+			}
+		}
+
+		invertNormalized(x, beta, s, count);
+
+		for (int i = 0; i < count; i++) {
+			size_t k = first + i;
+			double volatility = s[i] / sqrt(batch.maturities[k]);
+			volatilities[k] = !valid[i] ? NaN : (intrinsic[i] ? 0.0 : volatility);
+		}
+	}
+}
+
+/**
+ * Method used to invert a block of normalized prices. The normalized call is convex in s below the inflection
+ * point s_c = sqrt(2|x|) and concave above it: the points below b(x, s_c) are solved on ln(b) - ln(beta),
+ * which is almost linear in the deep out of the money wing, and the others on b - beta. The initial guess is
+ * rational in the price (Corrado-Miller, which is accurate near the money, or below s_c the leading term of
+ * the asymptotic expansion of ln(b) when it is larger), and it is refined by STEPS third order Householder
+ * steps kept in the bracket of its region
+ * @param x		The log-moneyness of the points
+ * @param beta		The normalized prices of the points
+ * @param s		The total standard deviations sigma*sqrt(T) of the points
+ * @param n		The number of points (at most BLOCK)
+ */
+void ImpliedVolatility::invertNormalized(double const * x, double const * beta, double* s, int n) {
+
+	double lower[BLOCK];
+	double upper[BLOCK];
+	double logarithmic[BLOCK];
+	double logBeta[BLOCK];
+
+	for (int i = 0; i < n; i++) {
+		double inflection = sqrt(-2.0 * x[i]);
+		double low = beta[i] < normalizedCall(x[i], std::max(inflection, DBL_MIN)) ? 1.0 : 0.0;
+
+		// Corrado-Miller on the normalized forward exp(x/2) and strike exp(-x/2)
+		double forward = exp(0.5 * x[i]);
+		double strike = exp(-0.5 * x[i]);
+		double center = beta[i] - 0.5 * (forward - strike);
+		double root = sqrt(std::max(center * center - (forward - strike) * (forward - strike) / M_PI, 0.0));
+		double high = SQRT_TWO_PI / (forward + strike) * (center + root);
+
+		// The asymptotic wing ln(b) ~ -x^2 / (2 s^2)
+		double wing = -x[i] / sqrt(std::max(-2.0 * log(beta[i]), DBL_MIN));
+
+		lower[i] = low * 0.0 + (1.0 - low) * inflection;
+		upper[i] = low * inflection + (1.0 - low) * DBL_MAX;
+		s[i] = low * std::min(std::max(wing, high), inflection) + (1.0 - low) * std::max(high, inflection);
+		s[i] = std::max(s[i], DBL_MIN);
+		logarithmic[i] = low;
+		logBeta[i] = log(beta[i]);
+	}
+
+	for (int step = 0; step < STEPS; step++) {
+		for (int i = 0; i < n; i++) {
+			double current = s[i];
+			double b = std::max(normalizedCall(x[i], current), DBL_MIN);
+
+			// The derivatives of b in s: b' = v, b'' = v g, b''' = v (g^2 + g')
+			double v = exp(-0.5 * (x[i] * x[i] / (current * current) + 0.25 * current * current)) / SQRT_TWO_PI;
+			double g = x[i] * x[i] / (current * current * current) - 0.25 * current;
+			double dg = -3.0 * x[i] * x[i] / (current * current * current * current) - 0.25;
+			v = std::max(v, DBL_MIN);
+
+			// The objective of the region and the ratios of its derivatives
+			double l = v / b;
+			double f = logarithmic[i] * (log(b) - logBeta[i]) + (1.0 - logarithmic[i]) * (b - beta[i]);
+			double d1 = logarithmic[i] * l + (1.0 - logarithmic[i]) * v;
+			double d2 = logarithmic[i] * (l * g - l * l) + (1.0 - logarithmic[i]) * v * g;
+			double d3 = logarithmic[i] * (l * (g * g + dg) - 3.0 * l * l * g + 2.0 * l * l * l) +
+				(1.0 - logarithmic[i]) * v * (g * g + dg);
+
+			double nu = f / d1;
+			double gamma = d2 / d1;
+			double delta = d3 / d1;
+			double householder = nu * (1.0 - 0.5 * gamma * nu) / (1.0 - gamma * nu + delta * nu * nu / 6.0);
+			double newton = nu;
+
+			// The Householder step is replaced by the Newton one when it is not finite, and the new point
+			// never leaves the bracket (it moves at most halfway to the lower bound, which can be zero)
+			double next = current - (std::isfinite(householder) ? householder : newton);
+			next = std::max(next, 0.5 * (current + lower[i]));
+			next = std::min(next, upper[i]);
+			s[i] = std::isfinite(next) ? next : current;
+		}
+	}
+}
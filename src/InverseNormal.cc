@@ -0,0 +1,364 @@
+/**
+ *       @file  InverseNormal.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The inverse of the standard normal distribution, used to turn the uniform draws in normal ones. The
+ *		accuracy tier is selected once for the whole run, and the uniforms of a path are transformed together
+ *		by a loop specialized for the tier, so the choice costs nothing per draw
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "InverseNormal.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+InverseNormalTier InverseNormal::tier = INVERSE_NORMAL_AS241;
+
+/**
+ * Method used to select the tier of the whole run. It must be called before the workers are started
+ * @param tier		The tier to use
+ */
+void InverseNormal::setTier(InverseNormalTier tier) {
+	InverseNormal::tier = tier;
+}
+
+/**
+ * Method used to get the tier of the run
+ */
+InverseNormalTier InverseNormal::getTier() {
+	return tier;
+}
+
+/**
+ * Method used to read the name of a tier, it returns false if the name is unknown
+ * @param name		The name of the tier
+ * @param tier		The tier read
+ */
+bool InverseNormal::parse(std::string const & name, InverseNormalTier & tier) {
+	static const InverseNormalTier tiers[] = {INVERSE_NORMAL_AS241, INVERSE_NORMAL_TABLE,
+		INVERSE_NORMAL_RATIONAL, INVERSE_NORMAL_POLYNOMIAL};
+	for (size_t i = 0; i < sizeof(tiers) / sizeof(tiers[0]); i++) {
+		if (name == InverseNormal::name(tiers[i])) {
+			tier = tiers[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Method used to get the name of a tier
+ * @param tier		The tier
+ */
+const char* InverseNormal::name(InverseNormalTier tier) {
+	switch (tier) {
+	case INVERSE_NORMAL_TABLE:
+		return "table";
+	case INVERSE_NORMAL_RATIONAL:
+		return "rational";
+	case INVERSE_NORMAL_POLYNOMIAL:
+		return "polynomial";
+	default:
+		return "as241";
+	}
+}
+
+/**
+ * Method used to compute the inverse normal of a probability with AS241 (Wichura, 1988): a rational
+ * approximation of degree 7 in the center and two in the tails, with a relative error of about 1e-16
+ * @param p		The probability
+ */
+double InverseNormal::as241(double p) {
+
+	double q = p - 0.5;
+	if (fabs(q) <= 0.425) {
+		double r = 0.180625 - q * q;
+		return q * (((((((2509.0809287301226727 * r + 33430.575583588128105) * r +
+			67265.770927008700853) * r + 45921.953931549871457) * r + 13731.693765509461125) * r +
+			1971.5909503065514427) * r + 133.14166789178437745) * r + 3.387132872796366608) /
+			(((((((5226.495278852545561 * r + 28729.085735721942674) * r + 39307.89580009271061) * r +
+			21213.794301586595867) * r + 5394.1960214247511077) * r + 687.1870074920579083) * r +
+			42.313330701600911252) * r + 1.0);
+	}
+
+	if (!(p > 0.0 && p < 1.0))
+		return (p == 0.0) ? -std::numeric_limits<double>::infinity() :
+			(p == 1.0) ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+
+	double r = sqrt(-log(q < 0.0 ? p : 1.0 - p));
+	double x;
+	if (r <= 5.0) {
+		r -= 1.6;
+		x = (((((((7.7454501427834140764e-4 * r + 0.0227238449892691845833) * r + 0.24178072517745061177) * r +
+			1.27045825245236838258) * r + 3.64784832476320460504) * r + 5.7694972214606914055) * r +
+			4.6303378461565452959) * r + 1.42343711074968357734) /
+			(((((((1.05075007164441684324e-9 * r + 5.475938084995344946e-4) * r + 0.0151986665636164571966) * r +
+			0.14810397642748007459) * r + 0.68976733498510000455) * r + 1.6763848301838038494) * r +
+			2.05319162663775882187) * r + 1.0);
+	} else {
+		r -= 5.0;
+		x = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r + 0.0012426609473880784386) * r +
+			0.026532189526576123093) * r + 0.29656057182850489123) * r + 1.7848265399172913358) * r +
+			5.4637849111641143699) * r + 6.6579046435011037772) /
+			(((((((2.04426310338993978564e-15 * r + 1.4215117583164458887e-7) * r + 1.8463183175100546818e-5) * r +
+			7.868691311456132591e-4) * r + 0.0148753612908506148525) * r + 0.13692988092273580531) * r +
+			0.59983220655588793769) * r + 1.0);
+	}
+	return (q < 0.0) ? -x : x;
+}
+
+/**
+ * Method used to build the table of the inverse normal with AS241. The nodes of the octave o cover the tail
+ * probabilities [2^-(o+1), 2^-o) with CELLS equal cells, so the cells shrink with the probability and the error
+ * of the linear interpolation is about the same in the center and in the tails. It is the source of the table
+ * embedded in the program (InverseNormalTable.cc, with all the digits of its doubles)
+ */
+std::vector<double> InverseNormal::buildTable() {
+	std::vector<double> nodes(OCTAVES * (CELLS + 1));
+	for (int o = 0; o < OCTAVES; o++)
+		for (int c = 0; c <= CELLS; c++)
+			nodes[o * (CELLS + 1) + c] = as241(ldexp(1.0 + (double) c / CELLS, -(o + 1)));
+	return nodes;
+}
+
+/**
+ * Method used to compute the inverse normal with the table. The octave and the cell are the exponent and the
+ * first bits of the mantissa of the tail probability, the rest of the mantissa is the interpolation weight
+ * @param nodes		The table
+ * @param p		The probability
+ */
+inline double InverseNormal::interpolate(const double* nodes, double p) {
+	double tail = std::max(std::min(p, 1.0 - p), 1.0 / 1099511627776.0);
+
+	uint64_t bits;
+	memcpy(&bits, &tail, sizeof(bits));
+	int octave = 1022 - (int) ((bits >> 52) & 0x7ff);
+	uint64_t mantissa = bits & ((((uint64_t) 1) << 52) - 1);
+	int cell = (int) (mantissa >> 46);
+	double weight = (double) (mantissa & ((((uint64_t) 1) << 46) - 1)) * (1.0 / 70368744177664.0);
+
+	const double* node = nodes + octave * (CELLS + 1) + cell;
+	double x = node[0] + weight * (node[1] - node[0]);
+	return (p < 0.5) ? x : -x;
+}
+
+/**
+ * Method used to compute the inverse normal with the Abramowitz and Stegun formula 26.2.23. The absolute
+ * error is less than 4.5e-4
+ * @param p		The probability
+ */
+double InverseNormal::rational(double p) {
+	double t = sqrt(-2.0 * log(p < 0.5 ? p : 1.0 - p));
+	double x = t - ((0.010328 * t + 0.802853) * t + 2.515517) / (((0.001308 * t + 0.189269) * t + 1.432788) * t + 1.0);
+	return (p < 0.5) ? -x : x;
+}
+
+float InverseNormal::rational(float p) {
+	float t = std::sqrt(-2.0f * std::log(p < 0.5f ? p : 1.0f - p));
+	float x = t - ((0.010328f * t + 0.802853f) * t + 2.515517f) / (((0.001308f * t + 0.189269f) * t + 1.432788f) * t + 1.0f);
+	return (p < 0.5f) ? -x : x;
+}
+
+/**
+ * Method used to compute the inverse normal of a block of BLOCK probabilities in place with the polynomial of
+ * Giles ("Approximating the erfinv function", 2010): the inverse normal is sqrt(2) erfinv(2p - 1), and below
+ * w = -log(4p(1 - p)) = 5 (the probabilities in [0.0017, 0.9983]) erfinv(x) / x is a polynomial of degree 8 in w,
+ * with the relative error of the single precision. The logarithm is the one of Cephes in single precision, with
+ * the exponent and the mantissa read from the bits of its argument, so the first loop has a fixed number of
+ * iterations and no branch nor call, and it is vectorized by the default flags. The tails are computed by AS241
+ * in the second loop, they are about 0.34% of the draws
+ * @param values	The probabilities to transform
+ */
+template <typename Real>
+void InverseNormal::polynomialBlock(Real* values) {
+	const float CENTER = 0.006737947f;	// exp(-5)
+	float tails[BLOCK];
+	float normals[BLOCK];
+
+	for (int i = 0; i < BLOCK; i++) {
+		Real p = values[i];
+		float x = (float) (p + p - (Real) 1.0);
+		float t = (float) ((Real) 4.0 * p * ((Real) 1.0 - p));
+
+		// t = 2^k m with m in [sqrt(0.5), sqrt(2)), computed on the bits of t
+		uint32_t bits;
+		memcpy(&bits, &t, sizeof(bits));
+		int32_t k = (int32_t) (bits - 0x3f3504f3u) >> 23;
+		uint32_t mantissa = bits - ((uint32_t) k << 23);
+		float m;
+		memcpy(&m, &mantissa, sizeof(m));
+
+		float f = m - 1.0f;
+		float z = f * f;
+		float logarithm = ((((((((7.0376836292e-2f * f - 1.1514610310e-1f) * f + 1.1676998740e-1f) * f -
+			1.2420140846e-1f) * f + 1.4249322787e-1f) * f - 1.6668057665e-1f) * f + 2.0000714765e-1f) * f -
+			2.4999993993e-1f) * f + 3.3333331174e-1f) * f * z - 0.5f * z + f +
+			(float) k * -2.12194440e-4f + (float) k * 0.693359375f;
+
+		float w = -logarithm - 2.5f;
+		float erfinv = ((((((((2.81022636e-08f * w + 3.43273939e-07f) * w - 3.5233877e-06f) * w -
+			4.39150654e-06f) * w + 0.00021858087f) * w - 0.00125372503f) * w - 0.00417768164f) * w +
+			0.246640727f) * w + 1.50140941f) * x;
+
+		tails[i] = t;
+		normals[i] = 1.41421356f * erfinv;
+	}
+
+	// Out of the center (or with p not in (0, 1)) the polynomial does not hold
+	for (int i = 0; i < BLOCK; i++)
+		values[i] = (tails[i] > CENTER) ? (Real) normals[i] : (Real) as241(values[i]);
+}
+
+/**
+ * Method used to compute the inverse normal of a buffer of probabilities in place with the polynomial tier. The
+ * last values, less than a block, are transformed in a block padded with 0.5
+ * @param values	The probabilities to transform
+ * @param n		The number of values
+ */
+template <typename Real>
+void InverseNormal::polynomial(Real* values, size_t n) {
+	size_t blocks = n - n % BLOCK;
+	for (size_t i = 0; i < blocks; i += BLOCK)
+		polynomialBlock(values + i);
+
+	if (blocks < n) {
+		Real rest[BLOCK];
+		std::fill(rest, rest + BLOCK, (Real) 0.5);
+		std::copy(values + blocks, values + n, rest);
+		polynomialBlock(rest);
+		std::copy(rest, rest + (n - blocks), values + blocks);
+	}
+}
+
+/**
+ * Method used to transform in place a buffer of uniforms in (0, 1) in normals, with the tier of the run
+ * @param values	The uniforms to transform
+ * @param n		The number of values
+ */
+template <typename Real>
+void InverseNormal::transform(Real* values, size_t n) {
+	transform(tier, values, n);
+}
+
+/**
+ * Method used to transform in place a buffer of uniforms in (0, 1) in normals, with a given tier. The tier is
+ * checked once, and every loop has a single kind of body
+ * @param tier		The tier to use
+ * @param values	The uniforms to transform
+ * @param n		The number of values
+ */
+template <typename Real>
+void InverseNormal::transform(InverseNormalTier tier, Real* values, size_t n) {
+	switch (tier) {
+	case INVERSE_NORMAL_TABLE: {
+		const double* nodes = TABLE;
+		for (size_t i = 0; i < n; i++)
+			values[i] = (Real) interpolate(nodes, values[i]);
+		break;
+	}
+	case INVERSE_NORMAL_RATIONAL:
+		for (size_t i = 0; i < n; i++)
+			values[i] = rational(values[i]);
+		break;
+	case INVERSE_NORMAL_POLYNOMIAL:
+		polynomial(values, n);
+		break;
+	default:
+		for (size_t i = 0; i < n; i++)
+			values[i] = (Real) as241(values[i]);
+		break;
+	}
+}
+
+template void InverseNormal::transform<double>(double* values, size_t n);
+template void InverseNormal::transform<float>(float* values, size_t n);
+template void InverseNormal::transform<double>(InverseNormalTier tier, double* values, size_t n);
+template void InverseNormal::transform<float>(InverseNormalTier tier, float* values, size_t n);
+
+/**
+ * Method used to measure the cost and the accuracy of a tier. The accuracy is measured on the midpoints of
+ * a uniform grid of probabilities (the exact quadrature of the moments against AS241, without Monte Carlo
+ * noise) and on the tail probabilities 2^-k, the cost on uniforms of the 32 bits generator
+ * @param tier		The tier to measure
+ */
+InverseNormalReport InverseNormal::measure(InverseNormalTier tier) {
+
+	InverseNormalReport report = InverseNormalReport();
+
+	const size_t GRID = 1 << 20;
+	std::vector<double> grid(GRID + 2 * 32);
+	for (size_t i = 0; i < GRID; i++)
+		grid[i] = (i + 0.5) / GRID;
+	for (int k = 1; k <= 32; k++) {
+		grid[GRID + 2 * (k - 1)] = ldexp(1.0, -k);
+		grid[GRID + 2 * (k - 1) + 1] = 1.0 - ldexp(1.0, -k);
+	}
+
+	std::vector<double> normals(grid);
+	transform(tier, &normals[0], normals.size());
+	for (size_t i = 0; i < grid.size(); i++) {
+		double exact = as241(grid[i]);
+		report.maxError = std::max(report.maxError, fabs(normals[i] - exact));
+		if (i < GRID) {
+			report.meanBias += (normals[i] - exact) / GRID;
+			report.varianceBias += (normals[i] * normals[i] - exact * exact) / GRID;
+		}
+	}
+
+	const size_t DRAWS = 1 << 16;
+	const int REPEATS = 64;
+	std::mt19937 generator(1);
+	std::vector<double> uniforms(DRAWS);
+	std::vector<float> singleUniforms(DRAWS);
+	for (size_t i = 0; i < DRAWS; i++) {
+		uniforms[i] = (generator() + 0.5) * (1.0 / 4294967296.0);
+		singleUniforms[i] = ((float) (generator() >> 9) + 0.5f) * (1.0f / 8388608.0f);
+	}
+
+	std::vector<double> values(DRAWS);
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (int r = 0; r < REPEATS; r++) {
+		std::copy(uniforms.begin(), uniforms.end(), values.begin());
+		transform(tier, &values[0], DRAWS);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+	report.nanoseconds = elapsed.count() * 1e9 / ((double) DRAWS * REPEATS);
+
+	std::vector<float> singleValues(DRAWS);
+	begin = std::chrono::steady_clock::now();
+	for (int r = 0; r < REPEATS; r++) {
+		std::copy(singleUniforms.begin(), singleUniforms.end(), singleValues.begin());
+		transform(tier, &singleValues[0], DRAWS);
+	}
+	elapsed = std::chrono::steady_clock::now() - begin;
+	report.singleNanoseconds = elapsed.count() * 1e9 / ((double) DRAWS * REPEATS);
+
+	return report;
+}
+
+/**
+ * Method used to compare the table embedded in the program with the one built by AS241, it returns the largest
+ * absolute difference of their nodes (0 unless the embedded table is out of date)
+ */
+double InverseNormal::checkTable() {
+	std::vector<double> nodes = buildTable();
+	double difference = 0.0;
+	for (size_t i = 0; i < nodes.size(); i++)
+		if (nodes[i] != TABLE[i])
+			difference = std::max(difference, fabs(nodes[i] - TABLE[i]));
+	return difference;
+}
@@ -0,0 +1,743 @@
+/**
+ *       @file  InverseNormalTable.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The table of the inverse normal of the table tier, embedded in the program so it is not built at the
+ *		first draw. The node c of the octave o is the AS241 inverse normal of 2^-(o+1) * (1 + c / CELLS),
+ *		printed with all the digits of the doubles; --benchmark-normals compares it with AS241
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "InverseNormal.h"
+
+#include <cmath>
+
+const double InverseNormal::TABLE[OCTAVES * (CELLS + 1)] = {
+	// Octave 0: the tail probabilities in [2^-1, 2^-0]
+	0, 0.019584285230126924, 0.039176085503097639, 0.058782936068943061,
+	0.078412412733112197, 0.098072152488661052, 0.1177698745790953, 0.13751340214433588,
+	0.15731068461017067, 0.17716982099173981, 0.1970990842943123, 0.21710694721012974,
+	0.23720210932878771, 0.25739352610093824, 0.27769043982157676, 0.29810241293048695,
+	0.31863936396437514, 0.33931160653881731, 0.36012989178956939, 0.38110545476355645,
+	0.40225006532172525, 0.42357608420119952, 0.44509652498551633, 0.46682512285258959,
+	0.48877641111466941, 0.51096580673824743, 0.53340970624128048, 0.55612559361869129,
+	0.57913216225555597, 0.60244945316442367, 0.62609901234642129, 0.65010407064799525,
+	0.67448975019608171, 0.6992833023832199, 0.7245143834923653, 0.75021537546794037,
+	0.7764217611479276, 0.80317256559791772, 0.83051087820539915, 0.85848447414183204,
+	0.88714655901887585, 0.91655666753311249, 0.94678175630104555, 0.97789754394054196,
+	1.0099901692495821, 1.043158263318454, 1.0775155670402803, 1.1131942771609284,
+	1.1503493803760079, 1.1891643501993368, 1.229858759216589, 1.2726986411905357,
+	1.3180108973035367, 1.3662038163720984, 1.4177971379962673, 1.4734675779471014,
+	1.5341205443525459, 1.6010086648860757, 1.6759397227734436, 1.7616704103630663,
+	1.8627318674216511, 1.9874278859298957, 2.1538746940614555, 2.4175590162365048,
+	HUGE_VAL,
+	// Octave 1: the tail probabilities in [2^-2, 2^-1]
+	-0.67448975019608171, -0.66224768248841415, -0.65010407064799525, -0.63805558092251691,
+	-0.62609901234642129, -0.61423128906024538, -0.60244945316442367, -0.59075065806281879,
+	-0.57913216225555597, -0.56759132354456943, -0.55612559361869129, -0.54473251298817593,
+	-0.53340970624128048, -0.52215487759800139, -0.51096580673824743, -0.49984034488373508,
+	-0.48877641111466941, -0.47777198890388595, -0.46682512285258959, -0.45593391561313862,
+	-0.44509652498551633, -0.43431116117520963, -0.42357608420119952, -0.41288960144365422,
+	-0.40225006532172525, -0.39165587109259137, -0.38110545476355645, -0.37059729110962913,
+	-0.36012989178956939, -0.34970180355389513, -0.33931160653881731, -0.32895791264049101,
+	-0.31863936396437514, -0.3083546313448372, -0.29810241293048695, -0.28788143283101181,
+	-0.27769043982157676, -0.26752820610109712, -0.25739352610093824, -0.24728521534080497,
+	-0.23720210932878771, -0.22714306250271529, -0.21710694721012974, -0.20709265272436034,
+	-0.1970990842943123, -0.18712516222572081, -0.17716982099173981, -0.16723200837085012,
+	-0.15731068461017067, -0.1474048216123548, -0.13751340214433588, -0.12763541906627032,
+	-0.1177698745790953, -0.10791577948918657, -0.098072152488661052, -0.08823801944992446,
+	-0.078412412733112197, -0.06859437050511813, -0.058782936068943061, -0.04897715720213193,
+	-0.039176085503097639, -0.029378775744157044, -0.019584285230126924, -0.0097916731613453493,
+	0,
+	// Octave 2: the tail probabilities in [2^-3, 2^-2]
+	-1.1503493803760079, -1.140912709342313, -1.1315765583861881, -1.1223380117021662,
+	-1.1131942771609284, -1.1041426792922295, -1.0951806527613885, -1.0863057362981008,
+	-1.0775155670402803, -1.0688078752591983, -1.0601804794353553, -1.0516312816573357,
+	-1.043158263318454, -1.0347594810882446, -1.0264330631379108, -1.0181772056006682,
+	-1.0099901692495821, -1.0018702763769824, -0.99381590786088292, -0.98582550040506112,
+	-0.97789754394054196, -0.97003057917724067, -0.96222319529542066, -0.95447402776744261,
+	-0.94678175630104555, -0.93914510289606212, -0.9315628300071146, -0.92403373880538786,
+	-0.91655666753311249, -0.90913048994484691, -0.90175411383009996, -0.89442647961222388,
+	-0.88714655901887585, -0.87991335381968094, -0.8727258946270402, -0.86558323975630835,
+	-0.85848447414183204, -0.85142870830557127, -0.84441507737525723, -0.83744274014924525,
+	-0.83051087820539915, -0.82361869505153307, -0.81676541531509084, -0.80995028396989233,
+	-0.80317256559791772, -0.79643154368423297, -0.78972651994326581, -0.78305681367477409,
+	-0.7764217611479276, -0.76982071501204097, -0.76325304373257041, -0.7567181310510781,
+	-0.75021537546794037, -0.74374418974665413, -0.73730400043865429, -0.73089424742762854,
+	-0.7245143834923653, -0.71816387388723057, -0.71184219593941911, -0.70554883866217555,
+	-0.6992833023832199, -0.69304509838766348, -0.68683374857473067, -0.68064878512764648,
+	-0.67448975019608171,
+	// Octave 3: the tail probabilities in [2^-4, 2^-3]
+	-1.5341205443525459, -1.5262278696483851, -1.518429141152591, -1.5107216853604957,
+	-1.5031029431292737, -1.4955704631741842, -1.4881218960233806, -1.4807549883928981,
+	-1.4734675779471014, -1.4662575884132323, -1.459123025021593, -1.4520619702455724,
+	-1.4450725798180741, -1.4381530790030161, -1.4313017591024757, -1.4245169741817669,
+	-1.4177971379962673, -1.4111407211052056, -1.404546248158874, -1.3980122953468568,
+	-1.3915374879959006, -1.3851204983069758, -1.3787600432219229, -1.3724548824108431,
+	-1.3662038163720984, -1.360005684637406, -1.3538593640751064, -1.3477637672852028,
+	-1.3417178410802537, -1.3357205650466528, -1.3297709501812092, -1.3238680375983447,
+	-1.3180108973035367, -1.312198627028959, -1.3064303511275646, -1.3007052195221012,
+	-1.2950224067058145, -1.2893811107917978, -1.2837805526081671, -1.278219974836422,
+	-1.2726986411905357, -1.2672158356344725, -1.2617708616359866, -1.2563630414546958,
+	-1.2509917154625454, -1.2456562414949097, -1.2403559942306723, -1.2350903645997473,
+	-1.229858759216589, -1.2246605998383222, -1.2194953228462238, -1.2143623787493456,
+	-1.2092612317091549, -1.2041913590841244, -1.1991522509932739, -1.1941434098977182,
+	-1.1891643501993368, -1.1842145978557279, -1.1792936900106505, -1.1744011746392202,
+	-1.1695366102071427, -1.1646995653433327, -1.1598896185252787, -1.1551063577765683,
+	-1.1503493803760079,
+	// Octave 4: the tail probabilities in [2^-5, 2^-4]
+	-1.8627318674216511, -1.855838630462425, -1.8490324651688852, -1.8423108917410795,
+	-1.8356715369125431, -1.8291121278755453, -1.8226304866355292, -1.8162245247587545,
+	-1.8098922384806082, -1.8036317041451755, -1.7974410739494198, -1.7913185719677938,
+	-1.7852624904353231, -1.7792711862691835, -1.7733430778105803, -1.7674766417703405,
+	-1.7616704103630663, -1.7559229686160089, -1.7502329518399753, -1.7445990432506862,
+	-1.7390199717299037, -1.7334945097165786, -1.7280214712190125, -1.7225997099397707,
+	-1.7172281175057413, -1.7119056217962993, -1.7066311853631178, -1.7014038039356292,
+	-1.6962225050066093, -1.6910863464927695, -1.6859944154656101, -1.6809458269481492,
+	-1.6759397227734436, -1.6709752705011283, -1.6660516623884485, -1.6611681144125261,
+	-1.6563238653408072, -1.6515181758468742, -1.6467503276689652, -1.6420196228087494,
+	-1.6373253827680638, -1.6326669478214553, -1.628043676322533, -1.623454944042249,
+	-1.6189001435373589, -1.6143786835474163, -1.609889988418763, -1.6054334975540683,
+	-1.6010086648860757, -1.5966149583742704, -1.5922518595232891, -1.5879188629219396,
+	-1.5836154758017882, -1.5793412176143109, -1.5750956196256842, -1.5708782245283335,
+	-1.566688586068413, -1.5625262686884305, -1.5583908471842915, -1.5542819063760551,
+	-1.5501990407917605, -1.5461418543636911, -1.5421099601364985, -1.538102979986631,
+	-1.5341205443525459,
+	// Octave 5: the tail probabilities in [2^-6, 2^-5]
+	-2.1538746940614555, -2.1476913718808062, -2.1415890891473199, -2.1355655276512322,
+	-2.1296184691198121, -2.1237457895053828, -2.1179454536776157, -2.112215510486144,
+	-2.1065540881628135, -2.1009593900358503, -2.0954296905307892, -2.089963331435404,
+	-2.0845587184079095, -2.0792143177096158, -2.0739286531448999, -2.0687003031928377,
+	-2.0635278983162442, -2.0584101184350629, -2.0533456905521748, -2.0483333865206821,
+	-2.0433720209426482, -2.0384604491900817, -2.0335975655396918, -2.0287823014136466,
+	-2.0240136237191582, -2.0192905332802793, -2.0146120633558198, -2.0099772782377525,
+	-2.0053852719249021, -2.0008351668670965, -1.9963261127753258, -1.9918572854937753,
+	-1.9874278859298957, -1.9830371390389572, -1.978684292859775, -1.9743686175985373,
+	-1.970089404757873, -1.9658459663084968, -1.9616376339009494, -1.9574637581151211,
+	-1.9533237077453942, -1.9492168691193903, -1.9451426454484446, -1.941100456208031,
+	-1.9370897365465019, -1.9331099367205984, -1.9291605215562737, -1.9252409699334898,
+	-1.921350774293703, -1.9174894401688571, -1.9136564857307494, -1.9098514413597352,
+	-1.9060738492317593, -1.9023232629228031, -1.898599247029864, -1.8949013768076326,
+	-1.8912292378201079, -1.8875824256064067, -1.8839605453600741, -1.8803632116212556,
+	-1.8767900479810995, -1.873240686797822, -1.8697147689238782, -1.8662119434437185,
+	-1.8627318674216511,
+	// Octave 6: the tail probabilities in [2^-7, 2^-6]
+	-2.4175590162365048, -2.4119113239584102, -2.4063395309122169, -2.4008414556563058,
+	-2.395415011067751, -2.3900581989406167, -2.384769104967146, -2.379545894069639,
+	-2.374386806053931, -2.3692901515581872, -2.3642543082731859, -2.3592777174124842,
+	-2.3543588804128563, -2.3494963558471444, -2.3446887565333054, -2.3399347468247949,
+	-2.3352330400688128, -2.3305823962200267, -2.3259816195984691, -2.3214295567812497,
+	-2.3169250946185964, -2.3124671583654961, -2.3080547099209183, -2.3036867461672617,
+	-2.2993622974032286, -2.2950804258638771, -2.2908402243220745, -2.2866408147660193,
+	-2.2824813471479244, -2.2783609981992661, -2.2742789703084298, -2.2702344904567928,
+	-2.2662268092096522, -2.2622551997586164, -2.2583189570123348, -2.2544173967326544,
+	-2.2505498547135128, -2.2467156860000337, -2.2429142641454791, -2.2391449805038852,
+	-2.235407243556323, -2.2317004782688818, -2.2280241254806072, -2.2243776413197054,
+	-2.2207604966464736, -2.2171721765214962, -2.2136121796977291, -2.2100800181352001,
+	-2.2065752165371291, -2.2030973119063262, -2.1996458531208209, -2.1962204005277264,
+	-2.1928205255543962, -2.1894458103360073, -2.1860958473587284, -2.1827702391177053,
+	-2.1794685977891168, -2.1761905449156278, -2.172935711104568, -2.1697037357382305,
+	-2.1664942666957172, -2.1633069600857495, -2.1601414799899827, -2.1569974982162683,
+	-2.1538746940614555,
+	// Octave 7: the tail probabilities in [2^-8, 2^-7]
+	-2.6600674686174592, -2.6548414045465218, -2.6496868581788413, -2.6446017651945688,
+	-2.6395841507534064, -2.6346321243612572, -2.6297438751011892, -2.6249176671980776,
+	-2.6201518358892009, -2.6154447835757622, -2.6107949762326621, -2.6062009400559183,
+	-2.601661258329095, -2.5971745684917216, -2.5927395593942566, -2.5883549687254845,
+	-2.5840195805994783, -2.5797322232903688, -2.5754917671041615, -2.5712971223777394,
+	-2.5671472375960245, -2.5630410976189908, -2.5589777220109129, -2.5549561634648437,
+	-2.550975506315853, -2.5470348651370829, -2.5431333834131373, -2.5392702322857295,
+	-2.5354446093668943, -2.5316557376154587, -2.5279028642727339, -2.5241852598537164,
+	-2.5205022171903591, -2.5168530505237086, -2.5132370946419273, -2.5096537040614497,
+	-2.5061022522487009, -2.5025821308799676, -2.499092749137215, -2.4956335330377555,
+	-2.492203924795835, -2.4888033822143205, -2.4854313781048032, -2.482087399734533,
+	-2.4787709482987026, -2.4754815384166893, -2.4722186976509843, -2.468981966047548,
+	-2.4657708956964952, -2.4625850503120086, -2.4594240048304936, -2.4562873450260208,
+	-2.4531746671421688, -2.4500855775394497, -2.4470196923574874, -2.443976637191275,
+	-2.4409560467807534, -2.437957564713086, -2.4349808431370117, -2.4320255424886721,
+	-2.4290913312283835, -2.4261778855878169, -2.4232848893271086, -2.4204120335014165,
+	-2.4175590162365048,
+	// Octave 8: the tail probabilities in [2^-9, 2^-8]
+	-2.8856349124267573, -2.8807513248130152, -2.8759354898000522, -2.8711854444748077,
+	-2.8664993111913288, -2.861875292671884, -2.8573116674561327, -2.8528067856690722,
+	-2.8483590650812167, -2.8439669874371298, -2.8396290950305638, -2.8353439875066035,
+	-2.831110318872911, -2.8269267947038537, -2.822792169522744, -2.8187052443487075,
+	-2.8146648643958692, -2.8106699169136458, -2.8067193291578376, -2.8028120664831309,
+	-2.7989471305483491, -2.7951235576265501, -2.7913404170126768, -2.7875968095220696,
+	-2.783891866073676, -2.7802247463522676, -2.7765946375444335, -2.7730007531434979,
+	-2.7694423318188979, -2.7659186363458867, -2.7624289525917223, -2.7589725885547973,
+	-2.7555488734534204, -2.7521571568611982, -2.7487968078861624, -2.7454672143910397,
+	-2.742167782252166, -2.738897934654803, -2.7356571114227011, -2.7324447683799402,
+	-2.7292603767431829, -2.7261034225426344, -2.7229734060700714, -2.7198698413524394,
+	-2.7167922556496196, -2.7137401889750188, -2.7107131936377664, -2.7077108338053462,
+	-2.7047326850855797, -2.7017783341269377, -2.6988473782362261, -2.6959394250127389,
+	-2.6930540919980408, -2.6901910063405694, -2.6873498044743256, -2.6845301318109343,
+	-2.6817316424444178, -2.6789539988680486, -2.6761968717027016, -2.6734599394361398,
+	-2.6707428881727178, -2.6680454113929901, -2.6653672097227759, -2.662707990711223,
+	-2.6600674686174592,
+	// Octave 9: the tail probabilities in [2^-10, 2^-9]
+	-3.0972690781987842, -3.0926704854185449, -3.0881363778168534, -3.083664881180658,
+	-3.0792542028612875, -3.0749026270823565, -3.070608510581375, -3.0663702785569105,
+	-3.0621864208959075, -3.0580554886581974, -3.0539760907973967, -3.0499468910993168,
+	-3.0459666053207943, -3.04203399851334, -3.0381478825174462, -3.0343071136146236,
+	-3.0305105903253953, -3.0267572513424374, -3.023046073589049, -3.0193760703938932,
+	-3.015746289773753, -3.0121558128166965, -3.0086037521586735, -3.0050892505471229,
+	-3.0016114794856974, -2.9981696379546219, -2.9947629512017162, -2.9913906695993919,
+	-2.9880520675633768, -2.9847464425291652, -2.9814731139825779, -2.9782314225409685,
+	-2.9750207290819701, -2.9718404139168384, -2.9686898760056724, -2.965568532211992,
+	-2.9624758165943184, -2.9594111797325713, -2.9563740880872476, -2.9533640233894771,
+	-2.9503804820601833, -2.9474229746567029, -2.9444910253453025, -2.9415841713981616,
+	-2.9387019627134645, -2.9358439613573344, -2.933009741126432, -2.9301988871300932,
+	-2.9274109953909826, -2.9246456724632712, -2.9219025350674306, -2.9191812097407746,
+	-2.9164813325029413, -2.913802548535561, -2.9111445118753707, -2.9085068851201386,
+	-2.9058893391467122, -2.9032915528406478, -2.9007132128368087, -2.8981540132704233,
+	-2.8956136555381016, -2.8930918480683205, -2.8905883061009461, -2.8881027514753517,
+	-2.8856349124267573,
+	// Octave 10: the tail probabilities in [2^-11, 2^-10]
+	-3.2971933456919635, -3.2928365117357599, -3.2885412996904462, -3.2843059136504738,
+	-3.2801286359913369, -3.2760078228614193, -3.2719418999947103, -3.2679293588173381,
+	-3.2639687528234687, -3.2600586941984506, -3.2561978506692388, -3.2523849425639089,
+	-3.2486187400638147, -3.2448980606334081, -3.2412217666140712, -3.2375887629695677,
+	-3.233997995171729, -3.2304484472160442, -3.2269391397576688, -3.2234691283591665,
+	-3.2200375018420209, -3.2166433807346353, -3.2132859158100837, -3.2099642867074683,
+	-3.2066777006311709, -3.2034253911227961, -3.2002066169009602, -3.1970206607644602,
+	-3.1938668285547296, -3.1907444481737404, -3.1876528686538474, -3.1845914592762967,
+	-3.1815596087353688, -3.1785567243453481, -3.1755822312877018, -3.1726355718960519,
+	-3.1697162049766656, -3.1668236051623757, -3.1639572622979744, -3.1611166808552396,
+	-3.1583013793759109, -3.1555108899410094, -3.1527447576650269, -3.1500025402135932,
+	-3.1472838073433209, -3.1445881404626097, -3.1419151322122949, -3.139264386065026,
+	-3.1366355159424364, -3.1340281458491055, -3.1314419095224855, -3.1288764500979203,
+	-3.126331419788011, -3.1238064795755838, -3.1213012989195636, -3.1188155554731312,
+	-3.116348934813518, -3.1139011301829047, -3.1114718422398342, -3.1090607788206781,
+	-3.106667654710634, -3.1042921914238168, -3.1019341169920085, -3.0995931657616644,
+	-3.0972690781987842,
+	// Octave 11: the tail probabilities in [2^-12, 2^-11]
+	-3.4871041041144313, -3.4829555782128683, -3.478866142371277, -3.4748340703948331,
+	-3.4708577114353498, -3.4669354856479635, -3.4630658801571768, -3.4592474453061595,
+	-3.4554787911657265, -3.4517585842816767, -3.4480855446411787, -3.4444584428407201,
+	-3.4408760974397294, -3.437337372485417, -3.4338411751957008, -3.4303864537882154,
+	-3.4269721954444887, -3.4235974243992793, -3.4202612001459483, -3.4169626157494779,
+	-3.4137007962594899, -3.4104748972161971, -3.4072841032428443, -3.4041276267186626,
+	-3.4010047065268929, -3.3979146068727992, -3.3948566161670497, -3.3918300459701367,
+	-3.3888342299938983, -3.3858685231564425, -3.3829323006870906, -3.380024957278188,
+	-3.3771459062808535, -3.3742945789419769, -3.371470423679932, -3.3686729053966644,
+	-3.3659015048239964, -3.3631557179021154, -3.3604350551883422, -3.3577390412944546,
+	-3.3550672143508979, -3.3524191254963611, -3.3497943383912969, -3.3471924287540316,
+	-3.3446129839182239, -3.3420556024105075, -3.3395198935472137, -3.3370054770491362,
+	-3.3345119826734124, -3.3320390498615624, -3.3295863274028918, -3.327153473112423,
+	-3.3247401535226246, -3.3223460435882277, -3.3199708264034764, -3.3176141929311633,
+	-3.3152758417429071, -3.3129554787700637, -3.310652817064804, -3.3083675765708116,
+	-3.3060994839031919, -3.303848272137103, -3.3016136806047234, -3.2993954547001696,
+	-3.2971933456919635,
+	// Octave 12: the tail probabilities in [2^-13, 2^-12]
+	-3.6683292851213229, -3.6643625813109644, -3.6604527104051776, -3.6565980087311205,
+	-3.6527968853215613, -3.6490478177202639, -3.6453493480863477, -3.6417000795723724,
+	-3.6380986729533205, -3.634543843485921, -3.6310343579795994, -3.6275690320621723,
+	-3.6241467276249297, -3.6207663504331076, -3.6174268478891034, -3.6141272069367827,
+	-3.6108664520963578, -3.6076436436201602, -3.6044578757604926, -3.6013082751414345,
+	-3.5981939992272403, -3.5951142348804845, -3.5920681970037163, -3.5890551272588942,
+	-3.5860742928592764, -3.5831249854289102, -3.5802065199252433, -3.577318233620657,
+	-3.5744594851391329, -3.5716296535444871, -3.5688281374768831, -3.5660543543345891,
+	-3.5633077394981632, -3.5605877455944452, -3.5578938417979153, -3.5552255131671822,
+	-3.552582260014483, -3.5499635973062409, -3.5473690540928651, -3.5447981729660984,
+	-3.5422505095423102, -3.5397256319702808, -3.5372231204620745, -3.53474256684573,
+	-3.5322835741385372, -3.5298457561397996, -3.5274287370419919, -3.5250321510593565,
+	-3.5226556420729702, -3.5202988632914418, -3.5179614769264047, -3.5156431538820385,
+	-3.5133435734578975, -3.5110624230643701, -3.5087993979501153, -3.506554200940895,
+	-3.5043265421892191, -3.5021161389342783, -3.499922715271655, -3.4977460019323328,
+	-3.4955857360705802, -3.4934416610602472, -3.4913135262991095, -3.489201087020867,
+	-3.4871041041144313,
+	// Octave 13: the tail probabilities in [2^-14, 2^-13]
+	-3.8419306855019095, -3.838124423094512, -3.834372966529906, -3.8306747085849859,
+	-3.8270281123502548, -3.8234317071701951, -3.8198840848731637, -3.8163838962663164,
+	-3.8129298478735043, -3.8095206988961738, -3.8061552583791718, -3.8028323825651102,
+	-3.7995509724223711, -3.796309971333264, -3.7931083629300071, -3.7899451690673134,
+	-3.786819447921371, -3.7837302922058234, -3.780676827496237, -3.7776582106552064,
+	-3.7746736283509121, -3.7717222956625593, -3.7688034547666298, -3.765916373698396,
+	-3.7630603451835651, -3.7602346855353277, -3.7574387336124828, -3.7546718498345917,
+	-3.7519334152504586, -3.7492228306565174, -3.7465395157619223, -3.7438829083974214,
+	-3.7412524637652647, -3.738647653727627, -3.7360679661311846, -3.7335129041656678,
+	-3.7309819857543474, -3.7284747429745617, -3.7259907215065433, -3.7235294801088705,
+	-3.7210905901190228, -3.7186736349776277, -3.7162782097750342, -3.7139039208189808,
+	-3.7115503852221869, -3.7092172305087736, -3.7069040942384808, -3.7046106236477461,
+	-3.7023364753067143, -3.7000813147913529, -3.6978448163698863, -3.6956266627027752,
+	-3.6934265445555856, -3.6912441605240529, -3.6890792167707294, -3.6869314267726585,
+	-3.6848005110794908, -3.6826861970815488, -3.6805882187873493, -3.6785063166101115,
+	-3.6764402371628448, -3.6743897330615654, -3.6723545627362957, -3.6703344902494566,
+	-3.6683292851213229,
+	// Octave 14: the tail probabilities in [2^-15, 2^-14]
+	-4.008772594168585, -4.0051092283954794, -4.0014988360605397, -3.9979398612133488,
+	-3.9944308160383892, -3.9909702769186057, -3.9875568807798341, -3.9841893216923454,
+	-3.9808663477081039, -3.9775867579143158, -3.9743493996857691, -3.9711531661200459,
+	-3.9679969936411634, -3.9648798597585535, -3.9618007809693978, -3.958758810793463,
+	-3.9557530379304944, -3.9527825845310853, -3.949846604572758, -3.9469442823336061,
+	-3.9440748309565898, -3.9412374910980486, -3.9384315296545847, -3.9356562385629181,
+	-3.9329109336677237, -3.9301949536529071, -3.927507659032063, -3.9248484311942415,
+	-3.9222166715014053, -3.919611800434263, -3.9170332567833843, -3.9144804968827485,
+	-3.9119529938830686, -3.9094502370624573, -3.9069717311721268, -3.9045169958150212,
+	-3.9020855648553985, -3.8996769858575449, -3.8972908195518761, -3.8949266393268869,
+	-3.8925840307454043, -3.8902625910838005, -3.8879619288928509, -3.8856816635790308,
+	-3.8834214250051047, -3.881180853108984, -3.8789595975398163, -3.8767573173104033,
+	-3.8745736804650757, -3.8724083637621898, -3.8702610523704899, -3.8681314395786233,
+	-3.8660192265171078, -3.8639241218921319, -3.8618458417305832, -3.8597841091357381,
+	-3.8577386540530876, -3.8557092130457917, -3.8536955290792889, -3.851697351314622,
+	-3.8497144349100627, -3.8477465408306233, -3.8457934356650965, -3.8438548914502602,
+	-3.8419306855019095,
+	// Octave 15: the tail probabilities in [2^-16, 2^-15]
+	-4.1695693233491031, -4.1660342530398218, -4.1625504899615766, -4.1591165249851212,
+	-4.155730915121552, -4.1523922796988471, -4.1490992968113325, -4.1458507000189808,
+	-4.1426452752757585, -4.139481858068117, -4.1363593307466404, -4.1332766200353657,
+	-4.130232694704751, -4.1272265633955305, -4.1242572725818736, -4.1213239046632255,
+	-4.1184255761752446, -4.1155614361109372, -4.1127306643440082, -4.1099324701469744,
+	-4.1071660907973353, -4.1044307902655284, -4.1017258579790274, -4.0990506076572855,
+	-4.0964043762127282, -4.0937865227133434, -4.0911964274027444, -4.0886334907739563,
+	-4.0860971326933857, -4.0835867915717854, -4.0811019235791628, -4.0786420019009224,
+	-4.0762065160326166, -4.0737949711109485, -4.0714068872787958, -4.0690417990822212,
+	-4.066699254897518, -4.0643788163865411, -4.0620800579786343, -4.0598025663776465,
+	-4.0575459400925453, -4.0553097889903125, -4.053093733869872, -4.0508974060558129,
+	-4.0487204470109175, -4.0465625079663292, -4.0444232495685295, -4.0423023415421078,
+	-4.0401994623675677, -4.0381142989733032, -4.0360465464410504, -4.0339959077240932,
+	-4.0319620933775617, -4.0299448213002069, -4.027943816487082, -4.025958810792563,
+	-4.0239895427032097, -4.0220357571199692, -4.0200972051492618, -4.0181736439025331,
+	-4.0162648363038516, -4.0143705509051539, -4.0124905617088205, -4.0106246479971643,
+	-4.008772594168585,
+	// Octave 16: the tail probabilities in [2^-17, 2^-16]
+	-4.3249190408260443, -4.321499965144306, -4.3181306735853067, -4.3148096999834022,
+	-4.3115356424789271, -4.3083071597988036, -4.3051229678027312, -4.3019818362725513,
+	-4.2988825859244333, -4.2958240856256147, -4.2928052497990636, -4.2898250360010222,
+	-4.2868824426577845, -4.2839765069492994, -4.2811063028282801, -4.2782709391645426,
+	-4.2754695580051862, -4.2727013329420007, -4.2699654675783112, -4.2672611940880065,
+	-4.2645877718602199, -4.261944486223598, -4.2593306472445978, -4.256745588594729,
+	-4.2541886664820261, -4.25165925864244, -4.2491567633871359, -4.2466805987020155,
+	-4.2442302013961006, -4.2418050262955669, -4.239404545480566, -4.2370282475620966,
+	-4.2346756369964753, -4.2323462334350186, -4.2300395711068477, -4.227755198232761,
+	-4.2254926764683498, -4.2232515803745798, -4.2210314969142786, -4.21883202497298,
+	-4.2166527749027356, -4.2144933680875827, -4.2123534365294608, -4.2102326224533959,
+	-4.2081305779309197, -4.2060469645207013, -4.2039814529254667, -4.2019337226643065,
+	-4.1999034617595834, -4.1978903664376297, -4.1958941408425297, -4.1939144967623117,
+	-4.1919511533668903, -4.1900038369571675, -4.1880722807247306, -4.1861562245216142,
+	-4.1842554146396012, -4.1823696035986311, -4.1804985499438345, -4.1786420180507902,
+	-4.176799777938597, -4.1749716050904055, -4.1731572802810373, -4.17135658941136,
+	-4.1695693233491031,
+	// Octave 17: the tail probabilities in [2^-18, 2^-17]
+	-4.4753284246542036, -4.4720148691530479, -4.4687496988289332, -4.4655314871131324,
+	-4.4623588700488206, -4.4592305426679193, -4.4561452556267582, -4.4531018120786854,
+	-4.4500990647638163, -4.4471359132980925, -4.4442113016454448, -4.441324215758411,
+	-4.4384736813738934, -4.4356587619519834, -4.4328785567467746, -4.4301321989992246,
+	-4.4274188542428359, -4.424737718713823, -4.4220880178581288, -4.4194690049282626,
+	-4.4168799596635644, -4.4143201870479905, -4.4117890161400357, -4.4092857989697798,
+	-4.4068099094985183, -4.4043607426367517, -4.4019377133166175, -4.3995402556152179,
+	-4.3971678219254908, -4.3948198821715865, -4.3924959230658791, -4.3901954474050164,
+	-4.3879179734025593, -4.3856630340559262, -4.3834301765455921, -4.3812189616645396,
+	-4.3790289632761814, -4.3768597677990497, -4.3747109737166872, -4.3725821911112597,
+	-4.3704730412195527, -4.368383156010033, -4.3663121777798253, -4.364259758770455,
+	-4.3622255608013463, -4.3602092549200728, -4.3582105210684601, -4.3562290477636969,
+	-4.3542645317936266, -4.3523166779254829, -4.3503851986273698, -4.3484698138018043,
+	-4.3465702505307098, -4.3446862428312718, -4.3428175314221109, -4.3409638634992449,
+	-4.3391249925213442, -4.3373006780038503, -4.3354906853214894, -4.3336947855187846,
+	-4.3319127551282026, -4.3301443759955198, -4.3283894351121059, -4.3266477244538031,
+	-4.3249190408260443,
+	// Octave 18: the tail probabilities in [2^-19, 2^-18]
+	-4.6212310014992477, -4.6180139622004654, -4.6148440176255443, -4.6117197778452432,
+	-4.6086399139717606, -4.6056031546249132, -4.6026082826508397, -4.5996541320718709,
+	-4.5967395852482635, -4.5938635702343547, -4.5910250583133809, -4.5882230616965973,
+	-4.5854566313737797, -4.5827248551032351, -4.5800268555306358, -4.5773617884268392,
+	-4.5747288410357969, -4.572127230524373, -4.5695562025266172, -4.5670150297756615,
+	-4.5645030108169875, -4.5620194687972848, -4.5595637503236857, -4.5571352243884613,
+	-4.5547332813547436, -4.5523573319991701, -4.5500068066076276, -4.5476811541206237,
+	-4.5453798413250146, -4.5431023520891527, -4.5408481866386232, -4.5386168608700466,
+	-4.536407905700564, -4.5342208664507773, -4.5320553022591268, -4.5299107855257894,
+	-4.5277869013843182, -4.5256832471993791, -4.5235994320890764, -4.5215350764703999,
+	-4.5194898116264808, -4.5174632792944154, -4.5154551312724687, -4.5134650290456069,
+	-4.5114926434283209, -4.5095376542237799, -4.5075997498984561, -4.5056786272713607,
+	-4.5037739912171126, -4.501885554382123, -4.5000130369131774, -4.4981561661978047,
+	-4.4963146766157891, -4.4944883093012828, -4.4926768119149569, -4.4908799384257243,
+	-4.4890974489014859, -4.4873291093085452, -4.4855746913191883, -4.4838339721270701,
+	-4.4821067342700234, -4.480392765459932, -4.4786918584193325, -4.4770038107244243,
+	-4.4753284246542036,
+	// Octave 19: the tail probabilities in [2^-20, 2^-19]
+	-4.7630010342678135, -4.7598727058360693, -4.7567902770867372, -4.7537523921166152,
+	-4.7507577546030344, -4.7478051243532251, -4.7448933141003691, -4.7420211865254149,
+	-4.7391876514858282, -4.7363916634342473, -4.7336322190116018, -4.730908354800726,
+	-4.7282191452277971, -4.7255637006000244, -4.7229411652691429, -4.7203507159111089,
+	-4.7177915599133007, -4.7152629338612284, -4.712764102117486, -4.7102943554862797,
+	-4.7078530099573754, -4.7054394055238991, -4.7030529050688266, -4.7006928933153969,
+	-4.6983587758371224, -4.6960499781233533, -4.6937659446967137, -4.6915061382789682,
+	-4.6892700390021593, -4.6870571436621304, -4.684866965011679, -4.6826990310908725,
+	-4.6805528845921867, -4.6784280822583355, -4.676324194310749, -4.6742408039069048,
+	-4.6721775066247107, -4.6701339099723977, -4.6681096329223823, -4.6661043054677123,
+	-4.6641175681998055, -4.6621490719062511, -4.6601984771875458, -4.6582654540917101,
+	-4.6563496817657688, -4.6544508481232016, -4.6525686495264598, -4.6507027904837752,
+	-4.6488529833594443, -4.6470189480969273, -4.6452004119540433, -4.64339710924967,
+	-4.6416087811213114, -4.6398351752930287, -4.638076045853146, -4.6363311530413025,
+	-4.6346002630443364, -4.6328831478005865, -4.6311795848121875, -4.6294893569649824,
+	-4.627812252355672, -4.626148064125859, -4.6244965903026527, -4.6228576336455482,
+	-4.6212310014992477,
+	// Octave 20: the tail probabilities in [2^-21, 2^-20]
+	-4.9009642079631943, -4.8979177729744787, -4.8949161270305872, -4.8919579459322211,
+	-4.8890419636972924, -4.8861669691880314, -4.8833318029792689, -4.8805353544474634,
+	-4.8777765590620623, -4.8750543958624997, -4.8723678851057981, -4.8697160860710484,
+	-4.8670980950084175, -4.8645130432213719, -4.8619600952718507, -4.8594384472990741,
+	-4.8569473254434135, -4.8544859843675496, -4.8520537058678102, -4.8496497975691204,
+	-4.8472735916976255, -4.8449244439254926, -4.8426017322828239, -4.8403048561320876,
+	-4.8380332352007827, -4.8357863086684052, -4.8335635343041101, -4.8313643876516998,
+	-4.8291883612588951, -4.8270349639479724, -4.8249037201251861, -4.8227941691264702,
+	-4.8207058645972101, -4.8186383739039149, -4.8165912775758963, -4.8145641687750889,
+	-4.8125566527923542, -4.810568346568675, -4.8085988782397999, -4.8066478867029412,
+	-4.8047150212042862, -4.8027999409461017, -4.8009023147123706, -4.7990218205118413,
+	-4.7971581452376322, -4.7953109843423753, -4.7934800415281167, -4.7916650284501605,
+	-4.7898656644341031, -4.7880816762053584, -4.7863127976305337, -4.7845587694700127,
+	-4.7828193391411871, -4.7810942604917885, -4.7793832935827893, -4.777686204480414,
+	-4.7760027650568029, -4.7743327527988804, -4.7726759506250431, -4.7710321467092758,
+	-4.7694011343123623, -4.7677827116198026, -4.766176681586165, -4.7645828517855353,
+	-4.7630010342678135,
+	// Octave 21: the tail probabilities in [2^-22, 2^-21]
+	-5.0354059694639286, -5.032435432833827, -5.0295086496818691, -5.026624325438946,
+	-5.0237812224772034, -5.0209781568099761, -5.018213995027744, -5.0154876514501145,
+	-5.0127980854758265, -5.0101442991144118, -5.0075253346847939, -5.0049402726674446,
+	-5.0023882296979174, -4.9998683566907633, -4.9973798370837628, -4.9949218851933352,
+	-4.9924937446727435, -4.9900946870655245, -4.9877240104471063, -4.9853810381482839,
+	-4.9830651175546574, -4.980775618976705, -4.978511934585514, -4.9762734774096762,
+	-4.9740596803891597, -4.9718699954822965, -4.9697038928223876, -4.9675608599205887,
+	-4.9654404009121142, -4.9633420358429321, -4.9612652999943787, -4.9592097432432833,
+	-4.9571749294553911, -4.9551604359100319, -4.9531658527541031, -4.951190782483617,
+	-4.9492348394511172, -4.9472976493974761, -4.9453788490065964, -4.9434780854817202,
+	-4.9415950161420668, -4.9397293080386522, -4.9378806375882141, -4.9360486902242124,
+	-4.9342331600639602, -4.9324337495910031, -4.9306501693519076, -4.9288821376666982,
+	-4.9271293803521834, -4.9253916304575061, -4.923668628011284, -4.9219601197797038,
+	-4.9202658590350365, -4.9185856053340293, -4.9169191243056565, -4.9152661874477728,
+	-4.9136265719322285, -4.9120000604180305, -4.9103864408721085, -4.9087855063973898,
+	-4.907197055067777, -4.9056208897697031, -4.9040568180499751, -4.9025046519695783,
+	-4.9009642079631943,
+	// Octave 22: the tail probabilities in [2^-23, 2^-22]
+	-5.1665781197287535, -5.1636781770444591, -5.1608210193747155, -5.158005379920116,
+	-5.1552300476251096, -5.1524938639463409, -5.1497957198521602, -5.1471345530337524,
+	-5.1445093453101975, -5.1419191202114751, -5.139362940724963, -5.1368399071923285,
+	-5.1343491553449052, -5.131889854466742, -5.1294612056755069, -5.1270624403122422,
+	-5.1246928184318419, -5.122351627386724, -5.1200381804969215, -5.1177518158002906,
+	-5.1154918948771515, -5.1132578017440604, -5.1110489418118945, -5.1088647409038508,
+	-5.1067046443291852, -5.1045681160090242, -5.1024546376507134, -5.1003637079675102,
+	-5.0982948419406879, -5.0962475701212808, -5.0942214379689501, -5.0922160052256507,
+	-5.0902308453218543, -5.0882655448134111, -5.0863197028470841, -5.0843929306530731,
+	-5.0824848510628735, -5.0805950980510159, -5.0787233162991994, -5.0768691607816114,
+	-5.0750322963701251, -5.0732123974582901, -5.0714091476030472, -5.0696222391831531,
+	-5.0678513730733927, -5.0660962583337428, -5.0643566119126122, -5.0626321583634546,
+	-5.0609226295740024, -5.0592277645074661, -5.0575473089550727, -5.0558810152993345,
+	-5.0542286422875158, -5.0525899548147581, -5.0509647237163877, -5.0493527255689132,
+	-5.0477537424993324, -5.0461675620022763, -5.0445939767646424, -5.0430327844973544,
+	-5.041483787773875, -5.0399467938751705, -5.0384216146408223, -5.0369080663259886,
+	-5.0354059694639286,
+	// Octave 23: the tail probabilities in [2^-24, 2^-23]
+	-5.2947040848545974, -5.2918700165193249, -5.289077824991983, -5.2863262695664917,
+	-5.2836141641541641, -5.2809403741164314, -5.2783038133242188, -5.2757034414247332,
+	-5.2731382612983815, -5.2706073166900742, -5.2681096900008519, -5.2656445002268697,
+	-5.2632109010341415, -5.2608080789584619, -5.2584352517207762, -5.2560916666493034,
+	-5.2537765992003465, -5.2514893515704619, -5.2492292513933041, -5.2469956505150313,
+	-5.2447879238426207, -5.2426054682599537, -5.2404477016069624, -5.2383140617174098,
+	-5.2362040055113965, -5.2341170081388402, -5.232052562170515, -5.2300101768335789,
+	-5.2279893772885977, -5.2259897039454728, -5.2240107118157155, -5.2220519698988115,
+	-5.2201130606005393, -5.2181935791812526, -5.2162931332322877, -5.2144113421788241,
+	-5.2125478368075617, -5.2107022588177792, -5.2088742603943849, -5.2070635038016544,
+	-5.2052696609965192, -5.2034924132602294, -5.2017314508473733, -5.199986472651295,
+	-5.1982571858849793, -5.1965433057765571, -5.1948445552786398, -5.1931606647907245,
+	-5.191491371893993, -5.1898364210977999, -5.1881955635973096, -5.1865685570416025,
+	-5.1849551653118127, -5.1833551583087072, -5.1817683117492441, -5.1801944069717001,
+	-5.1786332307488649, -5.1770845751089771, -5.1755482371639552, -5.1740240189446309,
+	-5.1725117272425871, -5.1710111734583277, -5.1695221734554586, -5.1680445474206005,
+	-5.1665781197287535,
+	// Octave 24: the tail probabilities in [2^-25, 2^-24]
+	-5.4199831749168688, -5.4172107601976291, -5.4144793684192569, -5.4117877834524943,
+	-5.4091348427232893, -5.4065194341062996, -5.4039404930407446, -5.4013969998497213,
+	-5.3988879772460328, -5.3964124880091084, -5.3939696328191555, -5.3915585482358717,
+	-5.3891784048103597, -5.3868284053197728, -5.3845077831152564, -5.3822158005745733,
+	-5.3799517476515231, -5.3777149405149816, -5.3755047202710262, -5.373320451762039,
+	-5.3711615224374007, -5.3690273412905976, -5.3669173378582027, -5.3648309612763772,
+	-5.3627676793910108, -5.3607269779178743, -5.3587083596494329, -5.3567113437052427,
+	-5.3547354648230989, -5.3527802726882934, -5.350845331298542, -5.3489302183623391,
+	-5.3470345247286426, -5.3451578538459392, -5.3432998212489169, -5.3414600540710424,
+	-5.339638190581498, -5.3378338797450455, -5.3360467808034331, -5.334276562877136,
+	-5.3325229045861997, -5.3307854936891754, -5.3290640267390135, -5.3273582087550722,
+	-5.3256677529102783, -5.3239923802326237, -5.3223318193202349, -5.3206858060692408,
+	-5.3190540834137954, -5.3174364010775816, -5.315832515336214, -5.3142421887899456,
+	-5.3126651901461663, -5.3111012940111966, -5.3095502806908597, -5.3080119359994642,
+	-5.3064860510767096, -5.3049724222121455, -5.3034708506768302, -5.3019811425618029,
+	-5.3005031086230838, -5.299036564132841, -5.297581328736479, -5.2961372263153041,
+	-5.2947040848545974,
+	// Octave 25: the tail probabilities in [2^-26, 2^-25]
+	-5.5425940578029396, -5.5398795044040368, -5.5372051692754303, -5.5345698594877106,
+	-5.5319724346629693, -5.5294118039257611, -5.5268869230723618, -5.5243967919397674,
+	-5.5219404519577644, -5.5195169838689644, -5.5171255056031701, -5.514765170293666,
+	-5.5124351644242378, -5.510134706096677, -5.5078630434094862, -5.505619452939345,
+	-5.5034032383175813, -5.5012137288946139, -5.4990502784859254, -5.4969122641936279,
+	-5.4947990852982498, -5.4927101622157499, -5.4906449355152267, -5.4886028649930978,
+	-5.486583428799932, -5.4845861226163404, -5.4826104588746727, -5.4806559660235123,
+	-5.4787221878321244, -5.4768086827323375, -5.4749150231954014, -5.4730407951416913,
+	-5.4711855973811048, -5.4693490410823475, -5.4675307492692635, -5.4657303563426209,
+	-5.4639475076257886, -5.4621818589328965, -5.4604330761581794, -5.4587008348852191,
+	-5.4569848200149895, -5.4552847254115839, -5.4536002535646668, -5.4519311152676764,
+	-5.4502770293109055, -5.4486377221886819, -5.4470129278198236, -5.4454023872806854,
+	-5.4438058485501077, -5.4422230662656599, -5.4406538014905363, -5.4390978214906047,
+	-5.437554899521035, -5.4360248146220522, -5.4345073514233206, -5.4330022999565619,
+	-5.4315094554759327, -5.4300286182858581, -5.4285595935758826, -5.4271021912622421,
+	-5.4256562258358105, -5.4242215162161154, -5.4227978856111534, -5.4213851613826947,
+	-5.4199831749168688,
+	// Octave 26: the tail probabilities in [2^-27, 2^-26]
+	-5.6626976174594388, -5.6600375033357189, -5.6574168475151181, -5.6548344790134957,
+	-5.6522892784478458, -5.6497801750417365, -5.6473061438451628, -5.6448662031506007,
+	-5.6424594120888898, -5.6400848683901179, -5.6377417062960875, -5.6354290946121885,
+	-5.6331462348876729, -5.6308923597142941, -5.6286667311341372, -5.6264686391484098,
+	-5.6242974003195316, -5.6221523564596261, -5.6200328733990945, -5.6179383398294336,
+	-5.6158681662150203, -5.6138217837689561, -5.6117986434885196, -5.609798215246081,
+	-5.6078199869317347, -5.6058634636440967, -5.6039281669261065, -5.6020136340428399,
+	-5.6001194172985675, -5.5982450833905792, -5.5963902127973508, -5.5945543991989686,
+	-5.5927372489276879, -5.590938380446878, -5.5891574238565109, -5.587394020423635,
+	-5.5856478221363526, -5.5839184912798219, -5.5822057000331, -5.5805091300855159,
+	-5.5788284722714776, -5.5771634262226968, -5.5755137000367947, -5.5738790099613675,
+	-5.5722590800927163, -5.5706536420883408, -5.5690624348925439, -5.5674852044743419,
+	-5.5659217035771089, -5.5643716914792662, -5.5628349337654628, -5.5613112021077065,
+	-5.5598002740559194, -5.5583019328374235, -5.5568159671649466, -5.5553421710526427,
+	-5.5538803436398103, -5.5524302890218706, -5.5509918160882652, -5.5495647383669384,
+	-5.5481488738750917, -5.5467440449758847, -5.5453500782408272, -5.5439668043175878,
+	-5.5425940578029396,
+	// Octave 27: the tail probabilities in [2^-28, 2^-27]
+	-5.7804393244789338, -5.7778305493926458, -5.7752605134015411, -5.7727280663199636,
+	-5.7702321086618964, -5.7677715886980936, -5.7653454997239431, -5.7629528775201981,
+	-5.7605927979904443, -5.7582643749607536, -5.7559667581282863, -5.7536991311469636,
+	-5.751460709839284, -5.7492507405244995, -5.747068498454099, -5.7449132863465202,
+	-5.7427844330135391, -5.7406812920715904, -5.7386032407317842, -5.7365496786628869,
+	-5.7345200269220555, -5.7325137269485777, -5.7305302396161393, -5.7285690443396255,
+	-5.7266296382327289, -5.724711535312891, -5.722814265750487, -5.7209373751592665,
+	-5.719080423925381, -5.717242986572515, -5.7154246511608102, -5.7136250187174218,
+	-5.7118437026967497, -5.7100803284685098, -5.7083345328319242, -5.7066059635544564,
+	-5.7048942789336037, -5.7031991473803965, -5.7015202470233124, -5.6998572653314081,
+	-5.6982098987555805, -5.6965778523869099, -5.6949608396311016, -5.6933585818981527,
+	-5.6917708083063667, -5.6901972553999718, -5.6886376668795231, -5.6870917933444876,
+	-5.6855593920472947, -5.6840402266582641, -5.6825340670408462, -5.681040689036621,
+	-5.6795598742595699, -5.6780914098991175, -5.6766350885315271, -5.6751907079392039,
+	-5.6737580709375424, -5.6723369852088918, -5.6709272631433363, -5.669528721685964,
+	-5.6681411821902383, -5.6667644702772781, -5.665398415700686, -5.6640428522167028,
+	-5.6626976174594388,
+	// Octave 28: the tail probabilities in [2^-29, 2^-28]
+	-5.8959512167395705, -5.8933909616435072, -5.8908687637160719, -5.8883834925187211,
+	-5.8859340674559011, -5.8835194548813323, -5.881138665411533, -5.8787907514290181,
+	-5.8764748047592983, -5.8741899545073819, -5.8719353650407635, -5.8697102341071936,
+	-5.8675137910764859, -5.8653452952967777, -5.8632040345563103, -5.8610893236427382,
+	-5.8590005029926582, -5.8569369374246047, -5.8548980149494501, -5.8528831456525365,
+	-5.8508917606424573, -5.8489233110617613, -5.8469772671552196, -5.8450531173917177,
+	-5.8431503676360883, -5.8412685403675253, -5.8394071739414368, -5.837565821891908,
+	-5.835744052272112, -5.8339414470301776, -5.8321576014183076, -5.8303921234330014,
+	-5.828644633284437, -5.8269147628932556, -5.8252021554129803, -5.8235064647766013,
+	-5.8218273552658291, -5.8201645011016687, -5.8185175860550817, -5.8168863030765383,
+	-5.815270353943383, -5.8136694489240064, -5.8120833064578381, -5.8105116528503151,
+	-5.8089542219819403, -5.807410755030725, -5.8058810002072025, -5.8043647125014042,
+	-5.8028616534411226, -5.8013715908608638, -5.7998942986809228, -5.7984295566960782,
+	-5.7969771503733778, -5.7955368706585553, -5.79410851379067, -5.7926918811245081,
+	-5.7912867789603739, -5.7898930183809449, -5.7885104150947706, -5.787138789286149,
+	-5.7857779654710404, -5.7844277723587618, -5.7830880427191262, -5.7817586132548566,
+	-5.7804393244789338,
+	// Octave 29: the tail probabilities in [2^-30, 2^-29]
+	-6.0093535655307422, -6.006839258289931, -6.0043623604929897, -6.001921760481852,
+	-5.9995163956260891, -5.9971452494759925, -5.9948073491195926, -5.9925017627262811,
+	-5.9902275972614829, -5.9879839963582171, -5.9857701383328434, -5.9835852343333746,
+	-5.9814285266098741, -5.9792992868974286, -5.9771968149029444, -5.9751204368879343,
+	-5.9730695043400166, -5.9710433927265818, -5.9690415003245807, -5.9670632471208842,
+	-5.9651080737782589, -5.9631754406621997, -5.9612648269244373, -5.9593757296391976,
+	-5.9575076629885713, -5.9556601574937318, -5.9538327592888729, -5.9520250294351102,
+	-5.950236543271691, -5.9484668898021233, -5.9467156711129787, -5.9449825018232962,
+	-5.9432670085627164, -5.9415688294764939, -5.9398876137558041, -5.9382230211917806,
+	-5.9365747217518425, -5.9349423951770346, -5.9333257305990834, -5.931724426176074,
+	-5.9301381887456168, -5.9285667334945815, -5.9270097836443414, -5.9254670701507983,
+	-5.9239383314182534, -5.9224233130264157, -5.9209217674698182, -5.9194334539089795,
+	-5.9179581379326462, -5.9164955913305883, -5.91504559187634, -5.9136079231193754,
+	-5.912182374186262, -5.9107687395902797, -5.9093668190491435, -5.9079764173103433,
+	-5.9065973439837753, -5.9052294133812895, -5.9038724443627988, -5.9025262601886519,
+	-5.9011906883779472, -5.8998655605725068, -5.8985507124062648, -5.8972459833797597,
+	-5.8959512167395705,
+	// Octave 30: the tail probabilities in [2^-31, 2^-30]
+	-6.1207562859719404, -6.118285572258519, -6.1158516517283426, -6.1134534306127417,
+	-6.1110898633934356, -6.1087599500002794, -6.1064627332097219, -6.1041972962270297,
+	-6.1019627604368303, -6.0997582833081578, -6.0975830564414055, -6.0954363037457808,
+	-6.0933172797369588, -6.0912252679455117, -6.089159579427597, -6.0871195513700824,
+	-6.0851045457830315, -6.0831139482730485, -6.0811471668915651, -6.0792036310526019,
+	-6.0772827905150777, -6.0753841144250709, -6.073507090413842, -6.0716512237477689,
+	-6.0698160365266478, -6.0680010669270894, -6.0662058684880096, -6.0644300094353953,
+	-6.0626730720438511, -6.0609346520324587, -6.0592143579928415, -6.0575118108473394,
+	-6.0558266433354166, -6.0541584995265945, -6.0525070343582197, -6.0508719131966195,
+	-6.0492528114201845, -6.0476494140231409, -6.0460614152387144, -6.0444885181806178,
+	-6.0429304345017769, -6.0413868840693219, -6.0398575946548991, -6.0383423016394566,
+	-6.0368407477317154, -6.0353526826995596, -6.0338778631136032, -6.0324160521023487,
+	-6.0309670191182505, -6.0295305397141528, -6.0281063953295, -6.0266943730858573,
+	-6.0252942655912811, -6.0239058707529605, -6.0225289915978895, -6.0211634361010047,
+	-6.0198090170205258, -6.0184655517400625, -6.0171328621172195, -6.0158107743383367,
+	-6.0144991187790833, -6.0131977298706403, -6.0119064459711655, -6.0106251092423459,
+	-6.0093535655307422,
+	// Octave 31: the tail probabilities in [2^-32, 2^-31]
+	-6.2302601379890419, -6.2278308564295353, -6.2254377808140422, -6.2230798344398037,
+	-6.2207559881124865, -6.218465257386546, -6.2162067000032994, -6.2139794135099802,
+	-6.2117825330445768, -6.2096152292728348, -6.2074767064650027, -6.2053662007011434,
+	-6.2032829781947791, -6.2012263337256677, -6.1991955891732715, -6.1971900921432352,
+	-6.1952092146798918, -6.1932523520584173, -6.1913189216507494, -6.1894083618599867,
+	-6.1875201311182924, -6.1856537069438744, -6.1838085850528604, -6.1819842785223091,
+	-6.1801803170008363, -6.1783962459636586, -6.176631626009069, -6.1748860321936405,
+	-6.1731590534035634, -6.1714502917598599, -6.1697593620552533, -6.1680858912207013,
+	-6.1664295178197488, -6.1647898915689741, -6.1631666728829018, -6.1615595324419461,
+	-6.1599681507819444, -6.1583922179040496, -6.1568314329037426, -6.1552855036178755,
+	-6.1537541462886667, -6.152237085243744, -6.1507340525912575, -6.1492447879292502,
+	-6.1477690380684962, -6.1463065567680486, -6.14485710448281, -6.1434204481224812,
+	-6.1419963608212846, -6.1405846217178404, -6.1391850157447401, -6.1377973334272395,
+	-6.1364213706906519, -6.1350569286759518, -6.1337038135631987, -6.1323618364023877,
+	-6.131030812951332, -6.1297105635202564, -6.1284009128227419, -6.1271016898327524,
+	-6.1258127276473981, -6.1245338633552064, -6.1232649379096022, -6.1220057960073895,
+	-6.1207562859719404,
+	// Octave 32: the tail probabilities in [2^-33, 2^-32]
+	-6.3379577545537886, -6.3355679153951652, -6.3332137217755369, -6.3308941132952743,
+	-6.3286080763539037, -6.3263546414312266, -6.324132880563301, -6.3219419049966934,
+	-6.3197808630061338, -6.3176489378620433, -6.3155453459358259, -6.3134693349317565,
+	-6.3114201822355183, -6.3093971933702537, -6.307399700551791, -6.3054270613355685,
+	-6.303478657348272, -6.3015538930979487, -6.2996521948568391, -6.2977730096116149,
+	-6.2959158040762464, -6.2940800637630137, -6.2922652921076558, -6.2904710096448637,
+	-6.2886967532306954, -6.2869420753087395, -6.2852065432171242, -6.283489738533639,
+	-6.2817912564565104, -6.2801107052184886, -6.2784477055321588, -6.2768018900644815,
+	-6.2751729029387064, -6.2735603992620117, -6.2719640446772553, -6.2703835149373957,
+	-6.2688184955011854, -6.2672686811489342, -6.2657337756170879, -6.2642134912505707,
+	-6.2627075486718633, -6.2612156764658264, -6.2597376108794274, -6.258273095535472,
+	-6.2568218811596221, -6.255383725319942, -6.2539583921782604, -6.2525456522527643,
+	-6.2511452821911773, -6.249757064553993, -6.2483807876071884, -6.2470162451239961,
+	-6.2456632361951767, -6.244321565047426, -6.2429910408694669, -6.2416714776454532,
+	-6.2403626939953147, -6.2390645130216971, -6.2377767621631746, -6.236499273053421,
+	-6.2352318813860803, -6.2339744267850117, -6.2327267526797092, -6.2314887061856004,
+	-6.2302601379890419,
+	// Octave 33: the tail probabilities in [2^-34, 2^-33]
+	-6.4439345265385635, -6.4415822932442488, -6.4392651699533445, -6.4369821118612203,
+	-6.4347321202835053, -6.4325142399762782, -6.4303275566482911, -6.4281711946489741,
+	-6.4260443148174691, -6.4239461124794381, -6.4218758155796243, -6.4198326829392309,
+	-6.4178160026282844, -6.415825090443934, -6.4138592884865746, -6.4119179638262649,
+	-6.4100005072527395, -6.4081063321027019, -6.4062348731588177, -6.4043855856151621,
+	-6.4025579441043678, -6.4007514417821003, -6.3989655894648916, -6.3971999148175751,
+	-6.3954539615870027, -6.3937272888788588, -6.3920194704747226, -6.3903300941867043,
+	-6.388658761247231, -6.3870050857316558, -6.3853686940116408, -6.3837492242373184,
+	-6.382146325846505, -6.3805596590991831, -6.3789888946358086, -6.3774337130579237,
+	-6.3758938045297615, -6.374368868399598, -6.3728586128396874, -6.3713627545036715,
+	-6.3698810182004841, -6.3684131365838059, -6.3669588498561493, -6.3655179054868185,
+	-6.3640900579428843, -6.3626750684325639, -6.3612727046602213, -6.3598827405924423,
+	-6.3585049562345235, -6.3571391374169055, -6.3557850755909211, -6.3544425676334555,
+	-6.3531114156600212, -6.3517914268458435, -6.350482413254487, -6.3491841916737117,
+	-6.3478965834581738, -6.3466194143786083, -6.3453525144771969, -6.3440957179288304,
+	-6.3428488629079451, -6.3416117914606955, -6.3403843493821972, -6.3391663860986034,
+	-6.3379577545537886,
+	// Octave 34: the tail probabilities in [2^-35, 2^-34]
+	-6.5482693678317299, -6.5459530411315141, -6.5436713119980849, -6.5414231505630429,
+	-6.5392075724276504, -6.5370236360204625, -6.5348704401443403, -6.5327471216967679,
+	-6.5306528535489967, -6.5285868425709026, -6.5265483277897083, -6.5245365786717828,
+	-6.52255089351784, -6.5205905979625864, -6.5186550435708286, -6.5167436065226454,
+	-6.5148556863809324, -6.5129907049352269, -6.5111481051161562, -6.50932734997546,
+	-6.5075279217268411, -6.5057493208433383, -6.5039910652073072, -6.5022526893093175,
+	-6.500533743492686, -6.4988337932404967, -6.4971524185022966, -6.4954892130578772,
+	-6.4938437839156489, -6.4922157507434495, -6.4906047453296347, -6.4890104110725932,
+	-6.4874324024968741, -6.485870384794306, -6.484324033388539, -6.4827930335215953,
+	-6.4812770798611448, -6.4797758761272295, -6.4782891347372846, -6.4768165764684413,
+	-6.4753579301360542, -6.4739129322875586, -6.472481326910783, -6.4710628651558961,
+	-6.4696573050702408, -6.4682644113453334, -6.4668839550753674, -6.4655157135266297,
+	-6.4641594699171661, -6.4628150132062538, -6.4614821378930589, -6.4601606438241079,
+	-6.4588503360090064, -6.4575510244440775, -6.4562625239434519, -6.4549846539772613,
+	-6.4537172385165809, -6.4524601058847777, -6.4512130886149404, -6.4499760233131243,
+	-6.4487487505271055, -6.4475311146203689, -6.4463229636511121, -6.4451241492560225,
+	-6.4439345265385635,
+	// Octave 35: the tail probabilities in [2^-36, 2^-35]
+	-6.6510353798930089, -6.6487533838994022, -6.6465054945348827, -6.6442906962532025,
+	-6.6421080183536043, -6.6399565323743568, -6.6378353496731606, -6.6357436191784824,
+	-6.6336805252976108, -6.6316452859684123, -6.62963715084316, -6.6276553995937899,
+	-6.6256993403289801, -6.6237683081143253, -6.6218616635875938, -6.6199787916618869,
+	-6.6181191003100492, -6.6162820194243031, -6.6144669997455692, -6.6126735118574604,
+	-6.610901045240257, -6.6091491073806967, -6.6074172229335693, -6.6057049329316557,
+	-6.6040117940405887, -6.6023373778556884, -6.6006812702379181, -6.5990430706863963,
+	-6.5974223917450674, -6.595818858441314, -6.594232107754487, -6.5926617881124479,
+	-6.5911075589143611, -6.5895690900781414, -6.5880460616109824, -6.5865381632016424,
+	-6.58504509383312, -6.5835665614145205, -6.582102282431018, -6.5806519816107789,
+	-6.5792153916079616, -6.5777922527008084, -6.5763823125039709, -6.5749853256943247,
+	-6.5736010537494618, -6.5722292646982003, -6.5708697328824464, -6.5695222387297685,
+	-6.5681865685361558, -6.5668625142583839, -6.5655498733154953, -6.5642484483989012,
+	-6.5629580472907012, -6.5616784826897412, -6.5604095720450619, -6.5591511373963387,
+	-6.5579030052209832, -6.5566650062875489, -6.5554369755151596, -6.5542187518386505,
+	-6.5530101780791297, -6.5518111008197542, -6.5506213702864073, -6.5494408402330784,
+	-6.5482693678317299,
+	// Octave 36: the tail probabilities in [2^-37, 2^-36]
+	-6.752300431407015, -6.7500513014807817, -6.7478358072948152, -6.7456529470515614,
+	-6.7435017631994381, -6.7413813398609248, -6.7392908004450032, -6.7372293054283308,
+	-6.7351960502910355, -6.7331902635943344, -6.7312112051884911, -6.7292581645405871,
+	-6.727330459172653, -6.7254274332015056, -6.7235484559724545, -6.7216929207797307,
+	-6.7198602436670729, -6.7180498623025704, -6.7162612349222641, -6.7144938393375471,
+	-6.7127471720017944, -6.7110207471319976, -6.7093140958816058, -6.7076267655609794,
+	-6.7059583189022502, -6.7043083333655469, -6.7026764004838366, -6.7010621252438423,
+	-6.6994651255006543, -6.6978850314238763, -6.6963214849732688, -6.6947741394020461,
+	-6.6932426587860796, -6.6917267175773993, -6.6902260001805143, -6.6887402005501553,
+	-6.6872690218091622, -6.6858121758853075, -6.6843693831659401, -6.6829403721694218,
+	-6.6815248792323789, -6.6801226482118405, -6.6787334302014765, -6.6773569832610766,
+	-6.6759930721585734, -6.6746414681239274, -6.6733019486141814, -6.6719742970891236,
+	-6.6706583027969666, -6.6693537605695212, -6.6680604706263429, -6.6667782383874306,
+	-6.665506874293972, -6.6642461936367674, -6.6629960163919275, -6.6617561670634728,
+	-6.6605264745325048, -6.6593067719125987, -6.6580968964111227, -6.6568966891962189,
+	-6.655705995269126, -6.6545246633416184, -6.6533525457183122, -6.6521894981835983,
+	-6.6510353798930089,
+	// Octave 37: the tail probabilities in [2^-38, 2^-37]
+	-6.8521276658960666, -6.849910037999539, -6.8477255936857864, -6.8455733443694387,
+	-6.8434523451347058, -6.8413616921966662, -6.8393005205445423, -6.8372680017515606,
+	-6.8352633419374307, -6.83328577987084, -6.8313345852006089, -6.8294090568051073,
+	-6.8275085212506381, -6.8256323313502003, -6.8237798648149095, -6.8219505229910364,
+	-6.8201437296761656, -6.8183589300086487, -6.8165955894249386, -6.8148531926798928,
+	-6.8131312429255368, -6.8114292608441342, -6.8097467838317982, -6.8080833652291002,
+	-6.806438573595492, -6.8048119920245904, -6.8032032174975656, -6.8016118602721232,
+	-6.8000375433047573, -6.7984799017041366, -6.7969385822135928, -6.7954132427209073,
+	-6.7939035517936652, -6.7924091882386088, -6.7909298406834884, -6.789465207180073,
+	-6.7880149948270434, -6.7865789194115713, -6.7851567050684887, -6.7837480839560298,
+	-6.7823527959471823, -6.7809705883357392, -6.7796012155562488, -6.7782444389170564,
+	-6.7769000263457162, -6.7755677521460909, -6.7742473967665155, -6.7729387465783955,
+	-6.771641593664711, -6.7703557356178745, -6.7690809753464762, -6.7678171208904239,
+	-6.7665639852440567, -6.7653213861868382, -6.7640891461212096, -6.7628670919172658,
+	-6.7616550547639136, -6.7604528700261666, -6.7592603771083191, -6.7580774193226434,
+	-6.7569038437634283, -6.7557395011860262, -6.7545842458907126, -6.7534379356111165,
+	-6.752300431407015,
+	// Octave 38: the tail probabilities in [2^-39, 2^-38]
+	-6.9505759479167493, -6.9483885492383726, -6.9462338995164581, -6.9441110228750542,
+	-6.9420189865530588, -6.9399568983974804, -6.9379239045364107, -6.9359191872164772,
+	-6.9339419627910255, -6.9319914798465581, -6.9300670174562136, -6.9281678835500387,
+	-6.9262934133928438, -6.9244429681611894, -6.9226159336118744, -6.9208117188349378,
+	-6.9190297550848214, -6.9172694946838824, -6.9155304099929422, -6.9138119924440105,
+	-6.9121137516307307, -6.9104352144524617, -6.9087759243082267, -6.9071354403371217,
+	-6.9055133367019437, -6.9039092019131783, -6.9023226381906042, -6.9007532608600641,
+	-6.8992006977830593, -6.8976645888170918, -6.8961445853047501, -6.8946403495897464,
+	-6.8931515545581812, -6.8916778832035224, -6.8902190282137905, -6.8887746915796315,
+	-6.8873445842220313, -6.8859284256384585, -6.8845259435664037, -6.8831368736632532,
+	-6.8817609592015954, -6.8803979507790203, -6.8790476060416639, -6.8777096894206613,
+	-6.876383971880812, -6.875070230680806, -6.8737682491443381, -6.8724778164415579,
+	-6.8711987273802784, -6.8699307822064313, -6.8686737864132796, -6.8674275505589435,
+	-6.8661918900917813, -6.8649666251832473, -6.863751580567838, -6.862546585389758,
+	-6.8613514730559917, -6.8601660810954437, -6.8589902510238465, -6.8578238282141815,
+	-6.856666661772306, -6.8555186044175755, -6.8543795123681965, -6.8532492452310896,
+	-6.8521276658960666,
+	// Octave 39: the tail probabilities in [2^-40, 2^-39]
+	-7.0477002566644087, -7.0455418973342381, -7.0434158687696033, -7.0413212073320466,
+	-7.039256991963593, -7.0372223417108186, -7.0352164134264239, -7.0332383996332979,
+	-7.0312875265374482, -7.0293630521775299, -7.0274642646998027, -7.025590480748531,
+	-7.0237410439625823, -7.0219153235699769, -7.0201127130728098, -7.0183326290156547,
+	-7.0165745098311572, -7.0148378147571107, -7.0131220228197257, -7.0114266318783169,
+	-7.0097511577270177, -7.0080951332494417, -7.0064581076226364, -7.0048396455668813,
+	-7.0032393266382131, -7.0016567445607913, -7.000091506596422, -6.9985432329488111,
+	-6.9970115562002562, -6.995496120778677, -6.9939965824530548, -6.9925126078554882,
+	-6.9910438740281595, -6.9895900679937242, -6.9881508863476345, -6.9867260348711024,
+	-6.9853152281634259, -6.983918189292563, -6.9825346494628553, -6.9811643476988916,
+	-6.9798070305446158, -6.9784624517767533, -6.9771303721317866, -6.9758105590457253,
+	-6.9745027864058908, -6.9732068343141389, -6.971922488860848, -6.9706495419090819,
+	-6.9693877908884287, -6.9681370385979351, -6.9668970930177228, -6.9656677671287834,
+	-6.9644488787405541, -6.9632402503258648, -6.9620417088628956, -6.9608530856837598,
+	-6.959674216329419, -6.958504940410581, -6.9573451014743233, -6.9561945468761159,
+	-6.9550531276570293, -6.953920698425839, -6.9527971172458276, -6.9516822455260314,
+	-6.9505759479167493
+};
@@ -0,0 +1,511 @@
+/**
+ *       @file  JobRunner.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The runner of a batch of pricing jobs read from a job file. The jobs with the same model, maturity and
+ *		simulation grid are grouped and priced together on the same paths, the chunks of all the groups are
+ *		simulated concurrently by a pool of workers pinned on the assigned CPUs, and the prices of a group
+ *		are written as soon as all its chunks are done
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "JobRunner.h"
+#include "HestonWorker.h"
+#include "EuropeanCall.h"
+#include "EuropeanPut.h"
+#include "CpuTopology.h"
+#include "CompletionSignal.h"
+#include "StepPlanner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+/**
+ * The constructor of the JobRunner class, the parameters are the defaults of the fields missing in the
+ * job file
+ *
+ * @param defaults	The default job
+ * @param chunkSimulations	The simulations of every chunk
+ */
+JobRunner::JobRunner(Job const & defaults, int chunkSimulations) {
+	this->defaults = defaults;
+	this->chunkSimulations = chunkSimulations;
+	this->mixing = false;
+	this->singlePrecision = false;
+	this->seed = 0;
+	this->fourier = true;
+	this->richardson = false;
+	this->biasTarget = 0.0;
+}
+
+/**
+ * Distructor of the JobRunner, used to delete the options of the groups
+ */
+JobRunner::~JobRunner() {
+	for (size_t g = 0; g < groups.size(); g++)
+		for (size_t k = 0; k < groups[g].options.size(); k++)
+			delete groups[g].options[k];
+}
+
+/**
+ * Method used to enable the conditional Monte Carlo (mixing formula) simulation of the jobs
+ * @param mixing	True to simulate only the volatility path
+ */
+void JobRunner::setMixingMode(bool mixing) {
+	this->mixing = mixing;
+}
+
+/**
+ * Method used to simulate the jobs in single precision
+ * @param singlePrecision	True to simulate the paths in single precision
+ */
+void JobRunner::setSinglePrecision(bool singlePrecision) {
+	this->singlePrecision = singlePrecision;
+}
+
+/**
+ * Method used to set the seed of the simulation (0 for a random seed)
+ * @param seed		The seed of the simulation
+ */
+void JobRunner::setSeed(uint64_t seed) {
+	this->seed = seed;
+}
+
+/**
+ * Method used to price the groups of European jobs with the COS method instead of the simulation
+ * (enabled by default)
+ * @param fourier	True to price the European jobs with the COS method
+ */
+void JobRunner::setFourier(bool fourier) {
+	this->fourier = fourier;
+}
+
+/**
+ * Method used to select the model of all the jobs (Heston by default)
+ * @param model		The model and its parameters
+ */
+void JobRunner::setModel(ModelParameters const & model) {
+	this->modelParameters = model;
+}
+
+/**
+ * Method used to set the time grid of the simulated jobs (uniform by default)
+ * @param grid		The time grid
+ */
+void JobRunner::setTimeGrid(TimeGrid const & grid) {
+	this->timeGrid = grid;
+}
+
+/**
+ * Method used to extrapolate the prices of the simulated jobs with Richardson
+ * @param richardson	True to extrapolate the prices
+ */
+void JobRunner::setRichardson(bool richardson) {
+	this->richardson = richardson;
+}
+
+/**
+ * Method used to choose the steps of every simulated group from a target on the discretization bias
+ * @param bias		The target on the bias of the prices (0 to use the discr field)
+ */
+void JobRunner::setBiasTarget(double bias) {
+	this->biasTarget = bias;
+}
+
+/**
+ * Method used to read the job file, in JSON lines or in CSV with a header line
+ * @param path		The job file
+ */
+bool JobRunner::load(std::string const & path) {
+
+	std::ifstream file(path.c_str());
+	if (!file) {
+		std::cout << "Unable to open the job file " << path << std::endl;
+		return false;
+	}
+
+	std::vector<std::string> columns;
+	std::string line;
+	int number = 0;
+	while (std::getline(file, line)) {
+		number++;
+
+		size_t begin = line.find_first_not_of(" \t\r");
+		if (begin == std::string::npos || line[begin] == '#')
+			continue;
+
+		Job job = defaults;
+		std::ostringstream id;
+		id << "job" << jobs.size();
+		job.id = id.str();
+
+		bool valid = true;
+		if (line[begin] == '{') {
+			valid = parseJson(job, line.substr(begin));
+		} else {
+			std::vector<std::string> values;
+			std::stringstream fields(line.substr(begin));
+			std::string value;
+			while (std::getline(fields, value, ','))
+				values.push_back(value.substr(0, value.find_last_not_of(" \t\r") + 1));
+
+			// The first CSV line names the columns
+			if (columns.empty()) {
+				columns = values;
+				continue;
+			}
+			if (values.size() > columns.size())
+				valid = false;
+			for (size_t c = 0; valid && c < values.size(); c++)
+				valid = setField(job, columns[c], values[c]);
+		}
+
+		if (!valid || !add(job)) {
+			std::cout << path << ":" << number << ": invalid job" << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Method used to add a job, it returns false if the job is not valid
+ * @param job		The job to add
+ */
+bool JobRunner::add(Job const & job) {
+	if ((job.type != "call" && job.type != "put") || job.T <= 0.0 || job.simulations <= 0 ||
+			job.discretization <= 0)
+		return false;
+
+	jobs.push_back(job);
+	prices.push_back(0.0);
+	standardErrors.push_back(0.0);
+	group(jobs.size() - 1);
+	return true;
+}
+
+/**
+ * Method used to set a field of a job from its text value
+ * @param job		The job to set
+ * @param field		The name of the field
+ * @param value		The value of the field
+ */
+bool JobRunner::setField(Job & job, std::string const & field, std::string const & value) {
+
+	if (field == "id") {
+		job.id = value;
+		return !value.empty();
+	}
+	if (field == "type") {
+		job.type = value;
+		return true;
+	}
+
+	char* last;
+	double number = strtod(value.c_str(), &last);
+	if (value.empty() || *last != '\0')
+		return false;
+
+	if (field == "S0")		job.S0 = number;
+	else if (field == "K")		job.K = number;
+	else if (field == "r")		job.r = number;
+	else if (field == "T")		job.T = number;
+	else if (field == "V0")		job.V0 = number;
+	else if (field == "rho")	job.rho = number;
+	else if (field == "kappa")	job.kappa = number;
+	else if (field == "theta")	job.theta = number;
+	else if (field == "xi")		job.xi = number;
+	else if (field == "sims")	job.simulations = (int) number / 2;
+	else if (field == "discr")	job.discretization = (int) number;
+	else
+		return false;
+	return true;
+}
+
+/**
+ * Method used to read a JSON object of a job (a flat object of strings and numbers)
+ * @param job		The job to set
+ * @param line		The line with the object
+ */
+bool JobRunner::parseJson(Job & job, std::string const & line) {
+
+	size_t end = line.rfind('}');
+	if (end == std::string::npos)
+		return false;
+
+	std::stringstream members(line.substr(1, end - 1));
+	std::string member;
+	while (std::getline(members, member, ',')) {
+		size_t colon = member.find(':');
+		if (colon == std::string::npos)
+			return false;
+
+		std::string key = member.substr(0, colon);
+		std::string value = member.substr(colon + 1);
+
+		// Strip the blanks and the quotes of the key and of the value
+		const char* blanks = " \t\r\"";
+		if (key.find_first_not_of(blanks) == std::string::npos)
+			return false;
+		key = key.substr(key.find_first_not_of(blanks));
+		key = key.substr(0, key.find_last_not_of(blanks) + 1);
+		size_t first = value.find_first_not_of(blanks);
+		value = (first == std::string::npos) ? "" : value.substr(first);
+		value = value.substr(0, value.find_last_not_of(blanks) + 1);
+
+		if (!setField(job, key, value))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Method used to add a job in its group, or in a new group if no group is compatible. The jobs of a group
+ * have the same model, maturity and simulation grid, so they can be priced on the same paths
+ * @param index		The index of the job
+ */
+void JobRunner::group(int index) {
+
+	Job const & job = jobs[index];
+	size_t g;
+	for (g = 0; g < groups.size(); g++) {
+		Job const & model = groups[g].model;
+		if (model.S0 == job.S0 && model.r == job.r && model.T == job.T && model.V0 == job.V0 &&
+				model.rho == job.rho && model.kappa == job.kappa && model.theta == job.theta &&
+				model.xi == job.xi && model.simulations == job.simulations &&
+				model.discretization == job.discretization)
+			break;
+	}
+
+	if (g == groups.size()) {
+		JobGroup created;
+		created.model = job;
+		created.chunksNumber = (job.simulations + chunkSimulations - 1) / chunkSimulations;
+		created.completedChunks = 0;
+		groups.push_back(created);
+	}
+
+	JobGroup & target = groups[g];
+	target.jobs.push_back(index);
+	if (job.type == "call")
+		target.options.push_back(new EuropeanCall(job.S0, job.K, job.r, job.T));
+	else
+		target.options.push_back(new EuropeanPut(job.S0, job.K, job.r, job.T));
+	target.chunkSums.push_back(std::vector<double>(target.chunksNumber, 0.0));
+	target.chunkSquares.push_back(std::vector<double>(target.chunksNumber, 0.0));
+}
+
+/**
+ * Method used to price all the jobs. The chunks of all the groups are queued in the order of the groups,
+ * and every free worker of the pool takes the next one, so several groups are simulated concurrently
+ * @param output	The file where the results are written (NULL to only keep the prices)
+ */
+void JobRunner::run(FILE* output) {
+
+	CpuTopology topology;
+	int workersNumber = topology.getCpusNumber();
+	if (workersNumber < 1)
+		workersNumber = 1;
+
+	if (seed == 0)
+		seed = ((uint64_t) std::random_device()() << 32) | std::random_device()();
+
+	if (output) {
+		fprintf(output, "id,type,S0,K,T,price,stderr\n");
+		fflush(output);
+	}
+
+	// The groups of European options are priced by the COS method, the others are simulated
+	CosPricer pricer(defaults.V0, defaults.rho, defaults.kappa, defaults.theta, defaults.xi);
+	pricer.setModel(modelParameters);
+	std::vector<bool> simulated(groups.size(), true);
+	for (size_t g = 0; fourier && g < groups.size(); g++)
+		simulated[g] = !priceFourier(groups[g], pricer, output);
+	for (size_t g = 0; biasTarget > 0.0 && g < groups.size(); g++)
+		if (simulated[g])
+			plan(groups[g]);
+
+	// The queue of the chunks to simulate, as couples (group, chunk)
+	std::vector<std::pair<int, int> > queue;
+	for (size_t g = 0; g < groups.size(); g++)
+		for (int c = 0; simulated[g] && c < groups[g].chunksNumber; c++)
+			queue.push_back(std::make_pair((int) g, c));
+
+	CompletionSignal completion;
+	std::vector<HestonWorker*> workers(workersNumber, (HestonWorker*) NULL);
+	std::vector<ChunkTask> tasks(workersNumber);
+	std::vector<std::pair<int, int> > running(workersNumber);
+
+	size_t next = 0;
+	size_t collected = 0;
+	while (collected < queue.size()) {
+
+		for (int i = 0; i < workersNumber; i++) {
+			if (workers[i] || next == queue.size())
+				continue;
+
+			JobGroup & group = groups[queue[next].first];
+			int chunk = queue[next].second;
+			int first = chunk * chunkSimulations;
+			int todo = std::min(chunkSimulations, group.model.simulations - first);
+
+			Job const & model = group.model;
+			workers[i] = new HestonWorker(model.S0, model.K, model.r, model.T, model.V0, model.rho,
+				model.kappa, model.theta, model.xi);
+			workers[i]->setMixingMode(mixing);
+			workers[i]->setSinglePrecision(singlePrecision);
+			workers[i]->setModel(modelParameters);
+			workers[i]->setTimeGrid(timeGrid);
+			workers[i]->setRefinement(richardson ? -1.0 : 0.0, richardson ? 2.0 : 0.0);
+			workers[i]->setPayoffs(&group.options);
+			workers[i]->setCompletionSignal(&completion);
+			workers[i]->setCpu(topology.getCpu(i), topology.getNode(topology.getCpu(i)));
+
+			tasks[i].setPayoffs(group.options.size());
+			tasks[i].reset(chunk, first, todo, seed);
+			workers[i]->start(&tasks[i], model.discretization);
+			running[i] = queue[next++];
+		}
+
+		completion.waitFor(100);
+
+		for (int i = 0; i < workersNumber; i++) {
+			if (!workers[i] || workers[i]->isRunning())
+				continue;
+
+			workers[i]->join();
+			delete workers[i];
+			workers[i] = NULL;
+			collected++;
+
+			JobGroup & group = groups[running[i].first];
+			int chunk = running[i].second;
+			for (size_t k = 0; k < group.options.size(); k++) {
+				group.chunkSums[k][chunk] = tasks[i].payoffSums[k].get();
+				group.chunkSquares[k][chunk] = tasks[i].payoffSquares[k].get();
+			}
+
+			if (++group.completedChunks == group.chunksNumber)
+				writeGroup(group, output);
+		}
+	}
+}
+
+/**
+ * Method used to write the results of all the jobs of a completed group. The price is the pairwise sum of
+ * the chunks, the standard error is estimated from the variance of the payoffs of all the antithetic couples,
+ * so it does not depend on the number of chunks (a group of a single chunk has a standard error too)
+ * @param group		The completed group
+ * @param output	The file where the results are written
+ */
+void JobRunner::writeGroup(JobGroup const & group, FILE* output) {
+
+	double discount = exp(-group.model.r * group.model.T);
+	int n = group.chunksNumber;
+
+	for (size_t k = 0; k < group.jobs.size(); k++) {
+		Job const & job = jobs[group.jobs[k]];
+		double sum = PairwiseSum::sum(&group.chunkSums[k][0], n);
+		double squares = PairwiseSum::sum(&group.chunkSquares[k][0], n);
+		double price = sum / (2.0 * job.simulations) * discount;
+		double standardError = ::standardError(sum, squares, job.simulations) / 2.0 * discount;
+
+		prices[group.jobs[k]] = price;
+		standardErrors[group.jobs[k]] = standardError;
+		if (!output)
+			continue;
+		fprintf(output, "%s,%s,%g,%g,%g,%.10g,%.6g\n", job.id.c_str(), job.type.c_str(), job.S0, job.K, job.T,
+			price, standardError);
+	}
+	if (output)
+		fflush(output);
+}
+
+/**
+ * Method used to price a group with the COS method and to write its results. The jobs have no Monte Carlo
+ * error, so their standard error is 0
+ * @param group		The group to price
+ * @param pricer	The COS pricer, it keeps the coefficients of the maturities of the groups
+ * @param output	The file where the results are written
+ */
+bool JobRunner::priceFourier(JobGroup const & group, CosPricer & pricer, FILE* output) {
+
+	for (size_t k = 0; k < group.options.size(); k++)
+		if (!group.options[k]->hasFourierCalculator())
+			return false;
+
+	Job const & model = group.model;
+	pricer.setParameters(model.V0, model.rho, model.kappa, model.theta, model.xi);
+
+	for (size_t k = 0; k < group.jobs.size(); k++) {
+		Job const & job = jobs[group.jobs[k]];
+		prices[group.jobs[k]] = group.options[k]->fourierCalculator(pricer);
+		standardErrors[group.jobs[k]] = 0.0;
+		if (output)
+			fprintf(output, "%s,%s,%g,%g,%g,%.10g,%.6g\n", job.id.c_str(), job.type.c_str(), job.S0, job.K,
+				job.T, prices[group.jobs[k]], 0.0);
+	}
+	if (output)
+		fflush(output);
+	return true;
+}
+
+/**
+ * Method used to get the number of jobs read
+ */
+int JobRunner::getJobsNumber() {
+	return (int) jobs.size();
+}
+
+/**
+ * Method used to get the number of groups of jobs priced on the same paths
+ */
+int JobRunner::getGroupsNumber() {
+	return (int) groups.size();
+}
+
+/**
+ * Method used to get the price of a job, after the run
+ * @param index		The index of the job, in the order of the file or of the additions
+ */
+double JobRunner::getPrice(int index) {
+	return prices[index];
+}
+
+/**
+ * Method used to get the standard error of the price of a job, after the run
+ * @param index		The index of the job, in the order of the file or of the additions
+ */
+double JobRunner::getStandardError(int index) {
+	return standardErrors[index];
+}
+
+/**
+ * Method used to choose the steps of a group from the bias target. The pilot simulates the options of all the
+ * jobs of the group on the same paths, so a long maturity gets more steps and a short one fewer
+ * @param group		The group to plan
+ */
+void JobRunner::plan(JobGroup & group) {
+	Job const & model = group.model;
+	StepPlanner planner(model.S0, model.K, model.r, model.T, model.V0, model.rho, model.kappa, model.theta,
+		model.xi);
+	planner.setModel(modelParameters);
+	planner.setTimeGrid(timeGrid);
+	planner.setMixingMode(mixing);
+	planner.setRichardson(richardson);
+	planner.setPayoffs(&group.options);
+	group.model.discretization = planner.plan(biasTarget);
+}
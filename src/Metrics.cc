@@ -0,0 +1,265 @@
+/**
+ *       @file  Metrics.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The instrumentation of the simulation. Every worker counts the done paths and its busy time, and, if the
+ *		application is built with CONFIG_CONTRIB_HESTONFIVE_METRICS, it measures with the timestamp counter the
+ *		time spent in each phase of a path: random number generation, Heston step kernel, payoff and reduction.
+ *		The phase timers and the trace markers are compiled out otherwise, so they cost nothing.
+ *		The collected metrics are exported in the Prometheus text format or in JSON
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "Metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * The names of the phases, used in the exported metrics
+ */
+static const char* phaseNames[PHASES_NUMBER] = { "rng", "kernel", "payoff", "reduction" };
+
+int TraceMarker::fd = -1;
+
+/**
+ * Method used to open the ftrace marker file. The markers are written only after this call
+ */
+bool TraceMarker::enable() {
+	if (fd < 0)
+		fd = open("/sys/kernel/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+	if (fd < 0)
+		fd = open("/sys/kernel/debug/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+	return fd >= 0;
+}
+
+/**
+ * Method used to write a marker, in the printf format
+ * @param format	The format of the marker
+ */
+void TraceMarker::mark(const char* format, ...) {
+	if (fd < 0)
+		return;
+
+	char buffer[128];
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if (length > 0) {
+		if (length >= (int) sizeof(buffer))
+			length = sizeof(buffer) - 1;
+		if (::write(fd, buffer, length) < 0)
+			return;
+	}
+}
+
+#ifdef HESTONFIVE_METRICS
+
+/**
+ * The number of heap allocations, counted by the replaced global operator new
+ */
+static std::atomic<uint64_t> allocations(0);
+
+void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void* memory = malloc(size ? size : 1);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, std::nothrow_t const &) noexcept {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, std::nothrow_t const &) noexcept {
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete(void* memory, std::nothrow_t const &) noexcept {
+	free(memory);
+}
+
+void operator delete[](void* memory, std::nothrow_t const &) noexcept {
+	free(memory);
+}
+
+#endif // HESTONFIVE_METRICS
+
+/**
+ * Method used to get the number of heap allocations done so far by all the threads. The allocations are
+ * counted only with the metrics compiled in (the global operator new is replaced), otherwise it is 0
+ */
+uint64_t AllocationCounter::count() {
+#ifdef HESTONFIVE_METRICS
+	return allocations.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Method used to know if the allocations are counted
+ */
+bool AllocationCounter::enabled() {
+	return MetricsExporter::phasesEnabled();
+}
+
+/**
+ * The constructor of the exporter. The format is JSON if the file name ends with ".json", otherwise
+ * it is the Prometheus text format
+ * @param path		The file where the metrics are written
+ */
+MetricsExporter::MetricsExporter(std::string const & path) : path(path) {
+	json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+}
+
+/**
+ * Method used to know if the phase timers are compiled in
+ */
+bool MetricsExporter::phasesEnabled() {
+#ifdef HESTONFIVE_METRICS
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Method used to get the frequency of the timestamp counter, calibrated on the first call
+ */
+double MetricsExporter::ticksPerSecond() {
+	static double frequency = 0.0;
+	if (frequency > 0.0)
+		return frequency;
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	uint64_t beginTicks = readTimestamp();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	uint64_t endTicks = readTimestamp();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+	frequency = (double) (endTicks - beginTicks) / elapsed.count();
+	return frequency;
+}
+
+/**
+ * Method used to write (overwriting the previous content) the current metrics
+ * @param workers	The metrics of every worker
+ * @param simulations	The simulations done
+ * @param price		The current price
+ * @param elapsed	The seconds elapsed since the setup of the application
+ */
+bool MetricsExporter::write(std::vector<WorkerMetrics> const & workers, int simulations, double price, double elapsed) {
+
+	// Write a temporary file and rename it, so a scraper never reads a partial file
+	std::string temporary = path + ".tmp";
+	FILE* file = fopen(temporary.c_str(), "w");
+	if (!file)
+		return false;
+
+	if (json)
+		writeJson(file, workers, simulations, price, elapsed);
+	else
+		writePrometheus(file, workers, simulations, price, elapsed);
+
+	fclose(file);
+	return rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+void MetricsExporter::writePrometheus(FILE* file, std::vector<WorkerMetrics> const & workers, int simulations,
+		double price, double elapsed) {
+
+	fprintf(file, "# TYPE hestonfive_simulations_total counter\n");
+	fprintf(file, "hestonfive_simulations_total %d\n", simulations);
+	fprintf(file, "# TYPE hestonfive_price gauge\n");
+	fprintf(file, "hestonfive_price %.10g\n", price);
+	fprintf(file, "# TYPE hestonfive_elapsed_seconds gauge\n");
+	fprintf(file, "hestonfive_elapsed_seconds %.6f\n", elapsed);
+
+	fprintf(file, "# TYPE hestonfive_worker_paths_total counter\n");
+	for (size_t i = 0; i < workers.size(); i++)
+		fprintf(file, "hestonfive_worker_paths_total{worker=\"%zu\"} %llu\n", i,
+			(unsigned long long) workers[i].paths);
+
+	fprintf(file, "# TYPE hestonfive_worker_chunks_total counter\n");
+	for (size_t i = 0; i < workers.size(); i++)
+		fprintf(file, "hestonfive_worker_chunks_total{worker=\"%zu\"} %llu\n", i,
+			(unsigned long long) workers[i].chunks);
+
+	fprintf(file, "# TYPE hestonfive_worker_busy_seconds_total counter\n");
+	for (size_t i = 0; i < workers.size(); i++)
+		fprintf(file, "hestonfive_worker_busy_seconds_total{worker=\"%zu\"} %.6f\n", i, workers[i].busySeconds);
+
+	fprintf(file, "# TYPE hestonfive_worker_paths_per_second gauge\n");
+	for (size_t i = 0; i < workers.size(); i++)
+		fprintf(file, "hestonfive_worker_paths_per_second{worker=\"%zu\"} %.1f\n", i,
+			workers[i].busySeconds > 0 ? workers[i].paths / workers[i].busySeconds : 0.0);
+
+	if (!phasesEnabled())
+		return;
+
+	double frequency = ticksPerSecond();
+	fprintf(file, "# TYPE hestonfive_worker_phase_seconds_total counter\n");
+	for (size_t i = 0; i < workers.size(); i++)
+		for (int phase = 0; phase < PHASES_NUMBER; phase++)
+			fprintf(file, "hestonfive_worker_phase_seconds_total{worker=\"%zu\",phase=\"%s\"} %.6f\n",
+				i, phaseNames[phase], workers[i].phaseTicks[phase] / frequency);
+}
+
+void MetricsExporter::writeJson(FILE* file, std::vector<WorkerMetrics> const & workers, int simulations,
+		double price, double elapsed) {
+
+	double frequency = phasesEnabled() ? ticksPerSecond() : 0.0;
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"simulations\": %d,\n", simulations);
+	fprintf(file, "  \"price\": %.10g,\n", price);
+	fprintf(file, "  \"elapsed_seconds\": %.6f,\n", elapsed);
+	fprintf(file, "  \"workers\": [");
+	for (size_t i = 0; i < workers.size(); i++) {
+		fprintf(file, "%s\n    {\"worker\": %zu, \"paths\": %llu, \"chunks\": %llu, \"busy_seconds\": %.6f, "
+			"\"paths_per_second\": %.1f", i ? "," : "", i,
+			(unsigned long long) workers[i].paths, (unsigned long long) workers[i].chunks,
+			workers[i].busySeconds,
+			workers[i].busySeconds > 0 ? workers[i].paths / workers[i].busySeconds : 0.0);
+		if (phasesEnabled()) {
+			fprintf(file, ", \"phase_seconds\": {");
+			for (int phase = 0; phase < PHASES_NUMBER; phase++)
+				fprintf(file, "%s\"%s\": %.6f", phase ? ", " : "", phaseNames[phase],
+					workers[i].phaseTicks[phase] / frequency);
+			fprintf(file, "}");
+		}
+		fprintf(file, "}");
+	}
+	fprintf(file, "\n  ]\n}\n");
+}
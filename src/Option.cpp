@@ -16,6 +16,8 @@
  */
 #include "Option.h"
 
+#include <cmath>
+
 /**
  * The constructor of an Option
  * @param S0		The initial spot price of the option
@@ -63,3 +65,46 @@ double Option::getRiskFreeRate() {
 double Option::getMaturity() {
     return this->T;
 }
+
+/**
+ * Method used to know if the option payoff has a closed form expectation under a lognormal spot
+ * (used by the conditional Monte Carlo simulation). By default an option has not a closed form
+ */
+bool Option::hasConditionalCalculator() {
+    return false;
+}
+
+/**
+ * Method used to compute the expected (undiscounted) payoff when the terminal spot price is lognormal.
+ * The base implementation ignores the variance and evaluates the payoff on the forward price
+ * @param forward		The forward price of the terminal spot
+ * @param totalVariance		The total variance of the log of the terminal spot
+ */
+double Option::conditionalCalculator(double forward, double totalVariance) {
+    return optionCalculator(forward);
+}
+
+/**
+ * Method used to know if the option can be priced by the COS method, so that it does not need a
+ * simulation when the model has constant parameters. By default an option is priced by simulation
+ */
+bool Option::hasFourierCalculator() {
+    return false;
+}
+
+/**
+ * Method used to compute the price of the option with the COS method. The base implementation has no
+ * Fourier price and returns NaN
+ * @param pricer		The COS pricer of the model
+ */
+double Option::fourierCalculator(CosPricer & pricer) {
+    return NAN;
+}
+
+/**
+ * Method used to compute the cumulative distribution function of a standard normal
+ * @param x	The value where the function is evaluated
+ */
+double Option::normalCDF(double x) {
+    return 0.5 * erfc(-x * M_SQRT1_2);
+}
@@ -0,0 +1,199 @@
+/**
+ *       @file  PathStore.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: A memory-mapped file where the simulated paths are stored, to price new payoffs on the same paths
+ *		without simulating them again. The file has a header with the parameters of the model, then one column
+ *		per time step for the spot prices and one for the volatilities, in float or in double. The workers
+ *		write the paths directly in the mapped file while they simulate, and a reader maps it read-only and
+ *		uses the columns without any copy
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "PathStore.h"
+#include "Reduction.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The columns start at the first page after the header
+ */
+static const size_t DATA_OFFSET = 4096;
+static const uint32_t LAYOUT_VERSION = 2;
+
+PathStore::PathStore() {
+	header = NULL;
+	data = NULL;
+	mappedBytes = 0;
+	columnPairBytes = 0;
+	writable = false;
+}
+
+/**
+ * Distructor of the PathStore, it unmaps the file
+ */
+PathStore::~PathStore() {
+	close();
+}
+
+/**
+ * Method used to create a new store, sized for all the paths of a run
+ * @param path			The file to create (it is overwritten)
+ * @param paths			The number of paths to store
+ * @param steps			The number of time steps of every path
+ * @param singlePrecision	True to store the values as float
+ * @param model			The header with the parameters of the model
+ */
+bool PathStore::create(std::string const & path, uint64_t paths, int steps, bool singlePrecision,
+		PathStoreHeader const & model) {
+
+	close();
+
+	uint32_t valueSize = singlePrecision ? sizeof(float) : sizeof(double);
+	size_t bytes = DATA_OFFSET + (size_t) steps * 2 * paths * valueSize;
+
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+		return false;
+
+	// Reserve the blocks now, so a full disk is an error here and not a SIGBUS in a worker
+	if (posix_fallocate(fd, 0, bytes) != 0) {
+		::close(fd);
+		return false;
+	}
+
+	writable = true;
+	if (!map(fd, bytes))
+		return false;
+
+	*header = model;
+	memcpy(header->magic, "HFPATHS", 8);
+	header->version = LAYOUT_VERSION;
+	header->valueSize = valueSize;
+	header->paths = paths;
+	header->steps = steps;
+	header->completed = 0;
+	columnPairBytes = 2 * paths * valueSize;
+
+	// The paths are written in a scattered order, the kernel must not read ahead
+	madvise(data, bytes - DATA_OFFSET, MADV_RANDOM);
+	return true;
+}
+
+/**
+ * Method used to open an existing store, read-only
+ * @param path		The file to open
+ */
+bool PathStore::open(std::string const & path) {
+
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(fd, &status) != 0 || (size_t) status.st_size < DATA_OFFSET) {
+		::close(fd);
+		return false;
+	}
+
+	writable = false;
+	if (!map(fd, status.st_size))
+		return false;
+
+	if (memcmp(header->magic, "HFPATHS", 8) != 0 || header->version != LAYOUT_VERSION ||
+			(header->valueSize != sizeof(float) && header->valueSize != sizeof(double)) ||
+			DATA_OFFSET + (uint64_t) header->steps * 2 * header->paths * header->valueSize > mappedBytes) {
+		close();
+		return false;
+	}
+	columnPairBytes = 2 * header->paths * header->valueSize;
+
+	// The repricing scans the columns from the first to the last path
+	madvise(data, mappedBytes - DATA_OFFSET, MADV_SEQUENTIAL);
+	return true;
+}
+
+/**
+ * Method used to map the file and to set the column pointers. The descriptor is closed in any case
+ * @param fd		The descriptor of the file
+ * @param bytes		The size of the file
+ */
+bool PathStore::map(int fd, size_t bytes) {
+
+	void* memory = mmap(NULL, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED)
+		return false;
+
+	mappedBytes = bytes;
+	header = (PathStoreHeader*) memory;
+	data = (char*) memory + DATA_OFFSET;
+	return true;
+}
+
+/**
+ * Method used to mark that all the paths have been written
+ */
+void PathStore::markCompleted() {
+	if (header && writable)
+		header->completed = 1;
+}
+
+/**
+ * Method used to flush the store and to unmap it
+ */
+void PathStore::close() {
+	if (!header)
+		return;
+
+	if (writable)
+		msync(header, mappedBytes, MS_SYNC);
+	munmap(header, mappedBytes);
+	header = NULL;
+	data = NULL;
+	mappedBytes = 0;
+}
+
+/**
+ * Method used to get the header of the store
+ */
+PathStoreHeader const & PathStore::getHeader() {
+	return *header;
+}
+
+/**
+ * Method used to sum the payoffs of an option over the terminal spot prices of all the stored paths
+ * @param option	The option to price
+ */
+double PathStore::payoffSum(Option* option) {
+	if (header->valueSize == sizeof(float))
+		return terminalPayoffSum<float>(option);
+	return terminalPayoffSum<double>(option);
+}
+
+/**
+ * Method used to sum the payoffs of an option over a terminal column of values in the Real precision
+ * @param option	The option to price
+ */
+template <typename Real>
+double PathStore::terminalPayoffSum(Option* option) {
+	const Real* terminal = spotColumn<Real>(header->steps - 1);
+	PairwiseSum sum;
+	for (uint64_t i = 0; i < header->paths; i++)
+		sum.add(option->optionCalculator(terminal[i]));
+	return sum.get();
+}
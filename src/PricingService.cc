@@ -0,0 +1,321 @@
+/**
+ *       @file  PricingService.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The asynchronous pricing API. A contract is submitted to the service and the caller gets immediately
+ *		a handle: a future of the final price, the last estimate with its confidence interval, a progress
+ *		callback called at every completed chunk and the cancellation. The chunks of all the submitted
+ *		contracts are simulated by the shared pool of workers, and a contract is completed early as soon as
+ *		the confidence interval of its price is within the requested tolerance
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "PricingService.h"
+#include "HestonWorker.h"
+#include "EuropeanCall.h"
+#include "EuropeanPut.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * The maximum time the dispatcher waits for a completion before checking the cancellations
+ */
+static const int DISPATCH_WAIT_MS = 5;
+
+/**
+ * The constructor of the PricingHandle class, used only by the service
+ * @param request	The contract to price
+ */
+PricingHandle::PricingHandle(PricingRequest const & request) : request(request), cancelled(false) {
+
+	Job const & contract = request.contract;
+	if (contract.type == "put")
+		options.push_back(new EuropeanPut(contract.S0, contract.K, contract.r, contract.T));
+	else
+		options.push_back(new EuropeanCall(contract.S0, contract.K, contract.r, contract.T));
+	discount = request.curves ? exp(-request.terms.rate.integral(0.0, contract.T)) : exp(-contract.r * contract.T);
+
+	result = promise.get_future().share();
+	progress = PricingProgress();
+
+	this->request.chunkSimulations = std::max(request.chunkSimulations, HestonWorker::PUBLISH_PERIOD);
+	chunksNumber = (contract.simulations + this->request.chunkSimulations - 1) / this->request.chunkSimulations;
+	nextChunk = 0;
+	completedChunks = 0;
+	runningChunks = 0;
+	stopping = false;
+	status = PRICING_COMPLETED;
+	chunkSums.assign(chunksNumber, 0.0);
+	chunkSquares.assign(chunksNumber, 0.0);
+	chunkDone.assign(chunksNumber, 0);
+}
+
+/**
+ * Distructor of the PricingHandle, used to delete the option of the contract
+ */
+PricingHandle::~PricingHandle() {
+	for (size_t i = 0; i < options.size(); i++)
+		delete options[i];
+}
+
+/**
+ * Method used to get the future of the final result
+ */
+std::shared_future<PricingResult> PricingHandle::getResult() {
+	return result;
+}
+
+/**
+ * Method used to get the last estimate, without waiting
+ */
+PricingProgress PricingHandle::getProgress() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return progress;
+}
+
+/**
+ * Method used to cancel the pricing. The running chunks are stopped and the future gets the partial
+ * estimate of the completed chunks
+ */
+void PricingHandle::cancel() {
+	cancelled.store(true);
+}
+
+/**
+ * The constructor of the PricingService class, it starts the dispatcher thread
+ * @param workersNumber		The size of the pool of workers (0 for one worker per assigned CPU)
+ */
+PricingService::PricingService(int workersNumber) {
+
+	if (workersNumber <= 0)
+		workersNumber = std::max(topology.getCpusNumber(), 1);
+	this->workersNumber = workersNumber;
+
+	workers.assign(workersNumber, (HestonWorker*) NULL);
+	owners.resize(workersNumber);
+	tasks.resize(workersNumber);
+	for (int i = 0; i < workersNumber; i++)
+		tasks[i] = new ChunkTask();
+
+	stopping = false;
+	roundRobin = 0;
+	dispatcher = std::thread(&PricingService::dispatch, this);
+}
+
+/**
+ * Distructor of the PricingService: the pending pricings are cancelled and the dispatcher is joined
+ */
+PricingService::~PricingService() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	completion.notify();
+	dispatcher.join();
+
+	for (int i = 0; i < workersNumber; i++) {
+		delete workers[i];
+		delete tasks[i];
+	}
+}
+
+/**
+ * Method used to submit a contract. It returns immediately
+ * @param request	The contract to price
+ */
+std::shared_ptr<PricingHandle> PricingService::submit(PricingRequest const & request) {
+
+	std::shared_ptr<PricingHandle> handle(new PricingHandle(request));
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		submitted.push_back(handle);
+	}
+	completion.notify();
+	return handle;
+}
+
+/**
+ * The thread function of the dispatcher: it starts the chunks, collects them and completes the pricings
+ */
+void PricingService::dispatch() {
+
+	bool exiting = false;
+	while (!exiting || !active.empty()) {
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			active.insert(active.end(), submitted.begin(), submitted.end());
+			submitted.clear();
+			exiting = stopping;
+		}
+
+		// A cancelled pricing stops its chunks, then it is completed when they are collected
+		for (size_t a = 0; a < active.size(); a++) {
+			PricingHandle & handle = *active[a];
+			if ((exiting || handle.cancelled.load()) && !handle.stopping) {
+				handle.status = PRICING_CANCELLED;
+				stopChunks(handle);
+			}
+		}
+
+		schedule();
+		completion.waitFor(DISPATCH_WAIT_MS);
+		collect();
+
+		// Complete the pricings without running chunks and without chunks to start
+		for (size_t a = 0; a < active.size(); ) {
+			PricingHandle & handle = *active[a];
+			bool exhausted = handle.stopping || handle.nextChunk == handle.chunksNumber;
+			if (!exhausted || handle.runningChunks > 0) {
+				a++;
+				continue;
+			}
+
+			PricingResult result;
+			result.estimate = handle.getProgress();
+			result.status = handle.status;
+			handle.promise.set_value(result);
+			active.erase(active.begin() + a);
+		}
+	}
+}
+
+/**
+ * Method used to start the next chunks of the active pricings on the free workers, in round robin. A worker
+ * is created at the first chunk of its slot, then it is configured for the contract of every chunk
+ */
+void PricingService::schedule() {
+
+	for (int i = 0; i < workersNumber && !active.empty(); i++) {
+		if (owners[i])
+			continue;
+
+		// The next pricing with a chunk to start
+		PricingHandle* handle = NULL;
+		for (size_t n = 0; n < active.size() && !handle; n++) {
+			PricingHandle* candidate = active[(roundRobin + n) % active.size()].get();
+			if (!candidate->stopping && candidate->nextChunk < candidate->chunksNumber) {
+				handle = candidate;
+				owners[i] = active[(roundRobin + n) % active.size()];
+				roundRobin = (roundRobin + n + 1) % active.size();
+			}
+		}
+		if (!handle)
+			return;
+
+		PricingRequest const & request = handle->request;
+		Job const & contract = request.contract;
+		int chunk = handle->nextChunk++;
+		int first = chunk * request.chunkSimulations;
+
+		if (!workers[i]) {
+			workers[i] = new HestonWorker(contract.S0, contract.K, contract.r, contract.T, contract.V0,
+				contract.rho, contract.kappa, contract.theta, contract.xi);
+			workers[i]->setCompletionSignal(&completion);
+			workers[i]->setCpu(topology.getCpu(i), topology.getNode(topology.getCpu(i)));
+		} else {
+			workers[i]->setContract(contract.S0, contract.K, contract.r, contract.T, contract.V0, contract.rho,
+				contract.kappa, contract.theta, contract.xi);
+		}
+		if (request.curves)
+			workers[i]->setTerms(request.terms);
+		workers[i]->setMixingMode(request.mixing);
+		workers[i]->setSinglePrecision(request.singlePrecision);
+		workers[i]->setModel(request.model);
+		workers[i]->setTimeGrid(request.timeGrid);
+		workers[i]->setRefinement(request.richardson ? -1.0 : 0.0, request.richardson ? 2.0 : 0.0);
+		workers[i]->setPayoffs(&handle->options);
+
+		tasks[i]->setPayoffs(1);
+		tasks[i]->reset(chunk, first, std::min(request.chunkSimulations, contract.simulations - first), request.seed);
+		workers[i]->start(tasks[i], contract.discretization);
+		handle->runningChunks++;
+	}
+}
+
+/**
+ * Method used to collect the workers that have completed (or stopped) their chunk. A stopped chunk is
+ * discarded: the estimate is made only of completed chunks
+ */
+void PricingService::collect() {
+
+	for (int i = 0; i < workersNumber; i++) {
+		if (!owners[i] || workers[i]->isRunning())
+			continue;
+
+		workers[i]->join();
+
+		PricingHandle & handle = *owners[i];
+		handle.runningChunks--;
+		if (tasks[i]->completed() && !handle.stopping) {
+			handle.chunkSums[tasks[i]->index] = tasks[i]->payoffSums[0].get();
+			handle.chunkSquares[tasks[i]->index] = tasks[i]->payoffSquares[0].get();
+			handle.chunkDone[tasks[i]->index] = tasks[i]->done;
+			handle.completedChunks++;
+			update(handle);
+		}
+		owners[i].reset();
+	}
+}
+
+/**
+ * Method used to update the estimate of a pricing and to check its tolerance. The confidence interval is
+ * estimated from the variance of the payoffs of the antithetic couples of the completed chunks
+ * @param handle	The pricing
+ */
+void PricingService::update(PricingHandle & handle) {
+
+	double discount = handle.discount;
+
+	double sum = 0.0;
+	double squares = 0.0;
+	int simulations = 0;
+	int chunks = 0;
+	for (int c = 0; c < handle.chunksNumber; c++) {
+		if (handle.chunkDone[c] == 0)
+			continue;
+		sum += handle.chunkSums[c];
+		squares += handle.chunkSquares[c];
+		simulations += handle.chunkDone[c];
+		chunks++;
+	}
+
+	// The payoff of a couple is the sum of the payoffs of its two paths
+	PricingProgress progress;
+	progress.price = sum / (2.0 * simulations) * discount;
+	progress.simulations = simulations;
+	progress.chunks = chunks;
+	progress.halfWidth = 1.96 * standardError(sum, squares, simulations) / 2.0 * discount;
+
+	{
+		std::lock_guard<std::mutex> lock(handle.mutex);
+		handle.progress = progress;
+	}
+	if (handle.request.progress)
+		handle.request.progress(progress);
+
+	if (handle.request.tolerance > 0.0 && progress.chunks >= MIN_CHUNKS &&
+			progress.halfWidth <= handle.request.tolerance && handle.nextChunk < handle.chunksNumber) {
+		handle.status = PRICING_CONVERGED;
+		stopChunks(handle);
+	}
+}
+
+/**
+ * Method used to stop the running chunks of a pricing
+ * @param handle	The pricing
+ */
+void PricingService::stopChunks(PricingHandle & handle) {
+	handle.stopping = true;
+	for (int i = 0; i < workersNumber; i++)
+		if (owners[i].get() == &handle)
+			workers[i]->stop();
+}
@@ -0,0 +1,219 @@
+/**
+ *       @file  ResultAggregator.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The aggregator stage of the result pipeline. A dedicated thread consumes the rings of the workers while
+ *		they simulate their next chunks: it stores the chunk sums for the final reduction, keeps the running
+ *		statistics of the chunk prices and exports the metrics, so the bookkeeping never runs on the workers
+ *		nor on the EXC control thread
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "ResultAggregator.h"
+#include "StartupTimeline.h"
+
+#include <cmath>
+
+/**
+ * The constructor of the ResultAggregator class
+ * @param producers	The number of workers, every one with its own ring
+ * @param chunksNumber	The number of chunks of the run
+ * @param discount	The discount factor at the maturity
+ */
+ResultAggregator::ResultAggregator(int producers, int chunksNumber, double discount) : hasToWork(false) {
+	this->producers = producers;
+	this->discount = discount;
+
+	// A worker pushes at most one result for every chunk, so its ring can never be full
+	rings = newAligned<ResultRing>(producers);
+	for (int i = 0; i < producers; i++)
+		rings[i].reserve(chunksNumber);
+
+	chunkSums.assign(chunksNumber, 0.0);
+	chunkDone.assign(chunksNumber, 0);
+	metrics.assign(producers, WorkerMetrics());
+	meanPrice = 0.0;
+	squaresPrice = 0.0;
+	snapshot = AggregateSnapshot();
+	startTime = std::chrono::steady_clock::now();
+	journal = NULL;
+}
+
+/**
+ * Distructor of the ResultAggregator, it stops the thread if it is running
+ */
+ResultAggregator::~ResultAggregator() {
+	stop();
+	deleteAligned(rings, producers);
+}
+
+/**
+ * Method used to export the metrics of the workers every time new results are consumed
+ * @param metricsFile	The file to write: JSON if it ends with ".json", Prometheus text otherwise
+ */
+void ResultAggregator::setMetricsFile(std::string const & metricsFile) {
+	this->metricsFile = metricsFile;
+}
+
+/**
+ * Method used to record the accumulator of every consumed chunk in the journal of the run. The records are
+ * appended by the aggregator thread, so the workers never wait for the journal
+ * @param journal	The journal, or NULL to not record the chunks
+ */
+void ResultAggregator::setJournal(RunJournal* journal) {
+	this->journal = journal;
+}
+
+/**
+ * Method used to get the ring of a worker
+ * @param producer	The index of the worker
+ */
+ResultRing* ResultAggregator::getRing(int producer) {
+	return &rings[producer];
+}
+
+/**
+ * Method used to get the signal notified by the workers after a push
+ */
+CompletionSignal* ResultAggregator::getSignal() {
+	return &signal;
+}
+
+/**
+ * Method used to start the aggregator thread
+ */
+void ResultAggregator::start() {
+	hasToWork.store(true);
+	aggregator = std::thread(&ResultAggregator::run, this);
+}
+
+/**
+ * Method used to stop the aggregator thread, after it has consumed all the pushed results
+ */
+void ResultAggregator::stop() {
+	if (!aggregator.joinable())
+		return;
+	hasToWork.store(false);
+	signal.notify();
+	aggregator.join();
+}
+
+/**
+ * The thread function: it consumes the rings until it is stopped. The results pushed before the stop are
+ * always consumed
+ */
+void ResultAggregator::run() {
+	while (hasToWork.load()) {
+		signal.waitFor(WAIT_MS);
+		if (drain() > 0)
+			exportMetrics(getSnapshot().price);
+	}
+	drain();
+}
+
+/**
+ * Method used to consume all the results in the rings. It returns the number of consumed results
+ */
+int ResultAggregator::drain() {
+	int consumed = 0;
+	ChunkResult result;
+	for (int i = 0; i < producers; i++) {
+		while (rings[i].pop(result)) {
+			consume(i, result);
+			consumed++;
+		}
+	}
+	return consumed;
+}
+
+/**
+ * Method used to add a result to the statistics
+ * @param producer	The index of the worker
+ * @param result	The result of the chunk
+ */
+void ResultAggregator::consume(int producer, ChunkResult const & result) {
+
+	chunkSums[result.index] = result.sum;
+	chunkDone[result.index] = result.done;
+	metrics[producer] = result.metrics;
+
+	if (journal) {
+		JournalChunk record = JournalChunk();
+		record.seconds = journal->elapsed();
+		record.sum = result.sum;
+		record.index = result.index;
+		record.done = result.done;
+		record.worker = producer;
+		journal->append(JOURNAL_CHUNK, record);
+	}
+
+	std::lock_guard<std::mutex> lock(snapshotMutex);
+	snapshot.chunks++;
+	snapshot.simulations += result.done;
+	snapshot.sum += result.sum;
+	snapshot.price = snapshot.sum / (2.0 * snapshot.simulations) * discount;
+
+	// The running variance of the chunk prices (Welford)
+	double chunkPrice = result.sum / (2.0 * result.done) * discount;
+	double delta = chunkPrice - meanPrice;
+	meanPrice += delta / snapshot.chunks;
+	squaresPrice += delta * (chunkPrice - meanPrice);
+	snapshot.standardError = (snapshot.chunks > 1) ?
+		sqrt(squaresPrice / (snapshot.chunks - 1) / snapshot.chunks) : 0.0;
+
+	if (snapshot.chunks == 1)
+		StartupTimeline::mark("first price");
+}
+
+/**
+ * Method used to read the statistics of the chunks consumed so far
+ */
+AggregateSnapshot ResultAggregator::getSnapshot() {
+	std::lock_guard<std::mutex> lock(snapshotMutex);
+	return snapshot;
+}
+
+/**
+ * Method used to set the metrics of a worker which are not in the rings (the ones of its stopped chunks).
+ * It must be called only when the aggregator is stopped
+ * @param producer	The index of the worker
+ * @param metrics	The metrics of the worker
+ */
+void ResultAggregator::setWorkerMetrics(int producer, WorkerMetrics const & metrics) {
+	this->metrics[producer] = metrics;
+}
+
+/**
+ * Method used to write the metrics file, if it is requested
+ * @param price		The price to export
+ */
+void ResultAggregator::exportMetrics(double price) {
+	if (metricsFile.empty())
+		return;
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+	MetricsExporter exporter(metricsFile);
+	exporter.write(metrics, getSnapshot().simulations, price, elapsed.count());
+}
+
+/**
+ * Method used to get the sum of every chunk (zero for the chunks not completed). It must be called only when
+ * the aggregator is stopped
+ */
+std::vector<double> const & ResultAggregator::getChunkSums() {
+	return chunkSums;
+}
+
+/**
+ * Method used to get the simulations of every chunk. It must be called only when the aggregator is stopped
+ */
+std::vector<int> const & ResultAggregator::getChunkDone() {
+	return chunkDone;
+}
@@ -0,0 +1,213 @@
+/**
+ *       @file  RunJournal.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The append-only binary journal of a run. It records the inputs of the run (parameters, seed, chunk
+ *		layout, scheme), every reconfiguration of the resources, the accumulator of every completed chunk and
+ *		the final result, so a price can be audited and every chunk replayed on its own. The records are
+ *		copied in a buffer and written by a journal thread, and every record has its length and checksum,
+ *		so a journal cut by a crash is read up to its last complete record
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "RunJournal.h"
+
+#include <unistd.h>
+
+namespace {
+
+/**
+ * The first bytes of a journal: the magic and the version of the format
+ */
+const char JOURNAL_MAGIC[4] = { 'H', 'F', 'R', 'J' };
+const uint32_t JOURNAL_VERSION = 1;
+
+}
+
+RunJournal::RunJournal() : file(NULL), closing(false) {
+}
+
+/**
+ * Distructor of the RunJournal, it closes the journal
+ */
+RunJournal::~RunJournal() {
+	close();
+}
+
+/**
+ * Method used to create the journal and to start the journal thread. An existing file is replaced.
+ * The file starts with the magic "HFRJ" and the version (32 bits), then every record is its type and the
+ * size of its content (32 bits each), the content and the CRC-32 of the type, the size and the content
+ * @param path		The file of the journal
+ */
+bool RunJournal::open(std::string const & path) {
+	close();
+
+	file = fopen(path.c_str(), "wb");
+	if (!file)
+		return false;
+
+	pending.reserve(BUFFER_SIZE);
+	writing.reserve(BUFFER_SIZE);
+	pending.insert(pending.end(), JOURNAL_MAGIC, JOURNAL_MAGIC + sizeof(JOURNAL_MAGIC));
+	pending.insert(pending.end(), (const char*) &JOURNAL_VERSION, (const char*) &JOURNAL_VERSION + sizeof(JOURNAL_VERSION));
+
+	startTime = std::chrono::steady_clock::now();
+	closing = false;
+	writer = std::thread(&RunJournal::run, this);
+	return true;
+}
+
+/**
+ * Method used to know if the journal is open
+ */
+bool RunJournal::isOpen() const {
+	return file != NULL;
+}
+
+/**
+ * Method used to append a record. The record is copied in the buffer of the journal thread, so the caller
+ * never waits for the disk. It does nothing if the journal is not open
+ * @param type		The type of the record
+ * @param payload	The content of the record
+ * @param size		The size of the content
+ */
+void RunJournal::append(JournalRecordType type, const void* payload, size_t size) {
+	if (!file)
+		return;
+
+	uint32_t header[2] = { (uint32_t) type, (uint32_t) size };
+	uint32_t crc = checksum(checksum(0, header, sizeof(header)), payload, size);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.insert(pending.end(), (const char*) header, (const char*) header + sizeof(header));
+		pending.insert(pending.end(), (const char*) payload, (const char*) payload + size);
+		pending.insert(pending.end(), (const char*) &crc, (const char*) &crc + sizeof(crc));
+	}
+	wake.notify_one();
+}
+
+/**
+ * Method used to get the seconds from the opening of the journal, the time of the records
+ */
+double RunJournal::elapsed() const {
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - startTime;
+	return seconds.count();
+}
+
+/**
+ * Method used to stop the journal thread, after it has written and synchronized all the records, and to close
+ * the file
+ */
+void RunJournal::close() {
+	if (!file)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closing = true;
+	}
+	wake.notify_one();
+	writer.join();
+
+	fclose(file);
+	file = NULL;
+}
+
+/**
+ * The thread function: it takes all the appended records, writes them and synchronizes the file, so a record
+ * is on the disk at most one write after it is appended. It ends when the journal is closed and all the
+ * records are written
+ */
+void RunJournal::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this] { return !pending.empty() || closing; });
+		if (pending.empty())
+			return;
+
+		// The buffers are swapped, so the appends go on while the records are written
+		writing.swap(pending);
+		lock.unlock();
+
+		fwrite(&writing[0], 1, writing.size(), file);
+		fflush(file);
+		fdatasync(fileno(file));
+		writing.clear();
+
+		lock.lock();
+	}
+}
+
+/**
+ * Method used to read all the complete records of a journal. A truncated or corrupted record ends the reading
+ * (it is the record being written when the run stopped). It returns false if the file is not a journal
+ * @param path		The file of the journal
+ * @param records	The records read
+ * @param truncated	True if the journal ends with an incomplete record
+ */
+bool RunJournal::read(std::string const & path, std::vector<JournalRecord> & records, bool & truncated) {
+	records.clear();
+	truncated = false;
+
+	FILE* input = fopen(path.c_str(), "rb");
+	if (!input)
+		return false;
+
+	char magic[sizeof(JOURNAL_MAGIC)];
+	uint32_t version;
+	if (fread(magic, 1, sizeof(magic), input) != sizeof(magic) || memcmp(magic, JOURNAL_MAGIC, sizeof(magic)) != 0 ||
+			fread(&version, sizeof(version), 1, input) != 1 || version != JOURNAL_VERSION) {
+		fclose(input);
+		return false;
+	}
+
+	uint32_t header[2];
+	size_t got;
+	while ((got = fread(header, 1, sizeof(header), input)) > 0) {
+		JournalRecord record;
+		record.type = header[0];
+		uint32_t crc;
+		if (got != sizeof(header)) {
+			truncated = true;
+			break;
+		}
+		record.payload.resize(header[1]);
+		if ((header[1] > 0 && fread(&record.payload[0], 1, header[1], input) != header[1]) ||
+				fread(&crc, sizeof(crc), 1, input) != 1 ||
+				crc != checksum(checksum(0, header, sizeof(header)), record.payload.data(), header[1])) {
+			truncated = true;
+			break;
+		}
+		records.push_back(record);
+	}
+
+	fclose(input);
+	return true;
+}
+
+/**
+ * Method used to compute the CRC-32 (IEEE 802.3) of a block of bytes, bit by bit: the records are small and
+ * they are not written by the workers
+ * @param crc		The CRC of the previous bytes (0 at the start)
+ * @param data		The bytes
+ * @param size		The number of bytes
+ */
+uint32_t RunJournal::checksum(uint32_t crc, const void* data, size_t size) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	crc = ~crc;
+	for (size_t i = 0; i < size; i++) {
+		crc ^= bytes[i];
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+	}
+	return ~crc;
+}
@@ -0,0 +1,490 @@
+/**
+ *       @file  ScenarioEngine.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The engine used to revalue the option under a grid of shocked parameters (stress scenarios). All the
+ *		scenarios are simulated on the same block of normals (common random numbers), so the difference between
+ *		two scenarios is due to the shock and not to the Monte Carlo noise. The scenarios are run in parallel
+ *		by a pool of workers pinned on the assigned CPUs, and the results are written in a columnar file.
+ *		In the lane mode the scenarios are simulated together instead: every path is drawn once and it is
+ *		carried by all the scenarios, LANES parameter sets at a time, so the random numbers cost the same
+ *		for one scenario or for many
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "ScenarioEngine.h"
+#include "HestonWorker.h"
+#include "CpuTopology.h"
+#include "CompletionSignal.h"
+#include "Reduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+/**
+ * The constructor of the ScenarioEngine class, the parameters are the ones of the base scenario
+ *
+ * @param S0		The spot price of the option
+ * @param K		The strike price of the option
+ * @param r		The risk-free rate of the option
+ * @param T		The maturity time of the option (in years)
+ * @param V0		The initial volatility of the option
+ * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+ * @param kappa		The mean reversion rate of the Heston Model for the considered option
+ * @param theta		The long-term volatility value
+ * @param xi		The volatility of volatility (V0)
+ * @param todo_simulations	The number of the simulations (antithetic couples) of every scenario
+ * @param discretization	The value of discretization of the simulation
+ */
+ScenarioEngine::ScenarioEngine(double S0, double K, double r, double T, double V0, double rho, double kappa,
+		double theta, double xi, int todo_simulations, int discretization) {
+
+	Scenario base = {"base", S0, K, r, T, V0, rho, kappa, theta, xi, 0.0};
+	scenarios.push_back(base);
+
+	this->todo_simulations = todo_simulations;
+	this->discretization = discretization;
+	this->mixing = false;
+	this->singlePrecision = false;
+	this->lanes = false;
+	this->chunkSimulations = todo_simulations;
+	this->seed = 0;
+}
+
+/**
+ * Method used to enable the conditional Monte Carlo (mixing formula) simulation of the scenarios
+ * @param mixing	True to simulate only the volatility path
+ */
+void ScenarioEngine::setMixingMode(bool mixing) {
+	this->mixing = mixing;
+}
+
+/**
+ * Method used to simulate the scenarios in single precision
+ * @param singlePrecision	True to simulate the paths in single precision
+ */
+void ScenarioEngine::setSinglePrecision(bool singlePrecision) {
+	this->singlePrecision = singlePrecision;
+}
+
+/**
+ * Method used to set the seed of the common block of normals (0 for a random seed)
+ * @param seed		The seed of the block
+ */
+void ScenarioEngine::setSeed(uint64_t seed) {
+	this->seed = seed;
+}
+
+/**
+ * Method used to simulate the scenarios in lanes, every path is drawn once and simulated under all the scenarios
+ * @param lanes		True to simulate the scenarios in lanes
+ */
+void ScenarioEngine::setLanes(bool lanes) {
+	this->lanes = lanes;
+}
+
+/**
+ * Method used to set the number of simulations of every chunk of the lane mode
+ * @param chunkSimulations	The simulations (antithetic couples) of every chunk
+ */
+void ScenarioEngine::setChunkSize(int chunkSimulations) {
+	this->chunkSimulations = std::max(chunkSimulations, 1);
+}
+
+/**
+ * Method used to read the shock file. Every line is a scenario: its name followed by the shocks of the
+ * base parameters, in the form "param=value", "param+=shift" or "param*=factor"
+ * @param path		The shock file
+ */
+bool ScenarioEngine::load(std::string const & path) {
+
+	std::ifstream file(path.c_str());
+	if (!file) {
+		std::cout << "Unable to open the scenario file " << path << std::endl;
+		return false;
+	}
+
+	std::string line;
+	int number = 0;
+	while (std::getline(file, line)) {
+		number++;
+
+		std::istringstream tokens(line);
+		std::string name;
+		if (!(tokens >> name) || name[0] == '#')
+			continue;
+
+		Scenario scenario = scenarios.front();
+		scenario.name = name;
+
+		std::string shock;
+		while (tokens >> shock) {
+			if (!applyShock(scenario, shock)) {
+				std::cout << path << ":" << number << ": invalid shock \"" << shock << "\"" << std::endl;
+				return false;
+			}
+		}
+
+		if (scenario.T <= 0.0 || scenario.V0 < 0.0 || scenario.rho < -1.0 || scenario.rho > 1.0) {
+			std::cout << path << ":" << number << ": invalid parameters for scenario " << name << std::endl;
+			return false;
+		}
+		scenarios.push_back(scenario);
+	}
+
+	return true;
+}
+
+/**
+ * Method used to apply a shock to a parameter of a scenario
+ * @param scenario	The scenario to shock
+ * @param shock		The shock, in the form "param=value", "param+=shift" or "param*=factor"
+ */
+bool ScenarioEngine::applyShock(Scenario & scenario, std::string const & shock) {
+
+	size_t equal = shock.find('=');
+	if (equal == std::string::npos || equal == 0 || equal + 1 == shock.size())
+		return false;
+
+	char operation = '=';
+	size_t end = equal;
+	if (shock[equal - 1] == '+' || shock[equal - 1] == '*') {
+		operation = shock[equal - 1];
+		end--;
+	}
+
+	std::string name = shock.substr(0, end);
+	char* last;
+	double value = strtod(shock.c_str() + equal + 1, &last);
+	if (*last != '\0')
+		return false;
+
+	double* parameter;
+	if (name == "S0")		parameter = &scenario.S0;
+	else if (name == "K")		parameter = &scenario.K;
+	else if (name == "r")		parameter = &scenario.r;
+	else if (name == "T")		parameter = &scenario.T;
+	else if (name == "V0")		parameter = &scenario.V0;
+	else if (name == "rho")		parameter = &scenario.rho;
+	else if (name == "kappa")	parameter = &scenario.kappa;
+	else if (name == "theta")	parameter = &scenario.theta;
+	else if (name == "xi")		parameter = &scenario.xi;
+	else
+		return false;
+
+	if (operation == '+')
+		*parameter += value;
+	else if (operation == '*')
+		*parameter *= value;
+	else
+		*parameter = value;
+	return true;
+}
+
+/**
+ * Method used to price all the scenarios. The block of normals is drawn once, then every worker of the pool
+ * takes the next scenario and simulates it on the whole block
+ */
+void ScenarioEngine::run() {
+
+	if (lanes) {
+		runLanes();
+		return;
+	}
+
+	CpuTopology topology;
+	int workersNumber = topology.getCpusNumber();
+	if (workersNumber < 1)
+		workersNumber = 1;
+
+	if (seed == 0)
+		seed = ((uint64_t) std::random_device()() << 32) | std::random_device()();
+
+	// The block is drawn by a worker configured as the scenario ones, so it has their layout and precision
+	Scenario const & base = scenarios.front();
+	{
+		HestonWorker generator(base.S0, base.K, base.r, base.T, base.V0, base.rho, base.kappa, base.theta, base.xi);
+		generator.setMixingMode(mixing);
+		generator.setSinglePrecision(singlePrecision);
+
+		ChunkTask task;
+		task.reset(0, 0, todo_simulations, seed);
+		generator.drawCommonNormals(&task, discretization, common);
+	}
+	std::cout << "Common normals: " << common.paths << " paths, " << common.bytes() / (1024 * 1024)
+		<< " MB, seed " << (unsigned long long) seed << std::endl;
+
+	CompletionSignal completion;
+	std::vector<HestonWorker*> workers(workersNumber, (HestonWorker*) NULL);
+	std::vector<ChunkTask> tasks(workersNumber);
+	std::vector<size_t> running(workersNumber, 0);
+
+	size_t next = 0;
+	size_t priced = 0;
+	while (priced < scenarios.size()) {
+
+		for (int i = 0; i < workersNumber; i++) {
+			if (workers[i] || next == scenarios.size())
+				continue;
+
+			Scenario const & scenario = scenarios[next];
+			workers[i] = new HestonWorker(scenario.S0, scenario.K, scenario.r, scenario.T, scenario.V0,
+				scenario.rho, scenario.kappa, scenario.theta, scenario.xi);
+			workers[i]->setMixingMode(mixing);
+			workers[i]->setSinglePrecision(singlePrecision);
+			workers[i]->setCommonNormals(&common);
+			workers[i]->setCompletionSignal(&completion);
+			workers[i]->setCpu(topology.getCpu(i), topology.getNode(topology.getCpu(i)));
+
+			// The substream of the task is not used, the normals are read from the block
+			tasks[i].reset((int) next, 0, common.paths, seed);
+			workers[i]->start(&tasks[i], discretization);
+			running[i] = next++;
+		}
+
+		completion.waitFor(100);
+
+		for (int i = 0; i < workersNumber; i++) {
+			if (!workers[i] || workers[i]->isRunning())
+				continue;
+
+			workers[i]->join();
+			Scenario & scenario = scenarios[running[i]];
+			scenario.price = tasks[i].sum.get() / (2.0 * tasks[i].done) * exp(-scenario.r * scenario.T);
+			delete workers[i];
+			workers[i] = NULL;
+			priced++;
+		}
+	}
+}
+
+/**
+ * Method used to price all the scenarios in lanes. The chunks are simulated by a pool of threads pinned on the
+ * assigned CPUs, and the sums of every scenario are reduced in the chunk order, so the prices depend only on
+ * the seed and on the chunk size
+ */
+void ScenarioEngine::runLanes() {
+
+	if (seed == 0)
+		seed = ((uint64_t) std::random_device()() << 32) | std::random_device()();
+
+	int chunksNumber = (todo_simulations + chunkSimulations - 1) / chunkSimulations;
+	chunkSums.assign(scenarios.size(), std::vector<double>(chunksNumber, 0.0));
+	chunkDone.assign(chunksNumber, 0);
+
+	CpuTopology topology;
+	int workersNumber = std::min(std::max(topology.getCpusNumber(), 1), chunksNumber);
+	std::cout << "Lanes: " << scenarios.size() << " scenarios on " << chunksNumber << " chunks, seed "
+		<< (unsigned long long) seed << std::endl;
+
+	std::atomic<int> next(0);
+	std::vector<std::thread> workers;
+	for (int i = 0; i < workersNumber; i++)
+		workers.push_back(std::thread(&ScenarioEngine::runWorker, this, topology.getCpu(i), &next));
+	for (int i = 0; i < workersNumber; i++)
+		workers[i].join();
+
+	for (size_t s = 0; s < scenarios.size(); s++) {
+		Scenario & scenario = scenarios[s];
+		scenario.price = PairwiseSum::sum(&chunkSums[s][0], chunksNumber) / (2.0 * todo_simulations) *
+			exp(-scenario.r * scenario.T);
+	}
+}
+
+/**
+ * The thread function of the pool of the lane mode: it simulates the next chunk until all the chunks are taken
+ * @param cpu		The CPU where the thread is pinned
+ * @param next		The index of the next chunk to simulate
+ */
+void ScenarioEngine::runWorker(int cpu, std::atomic<int>* next) {
+
+	CpuTopology::pinCurrentThread(cpu);
+
+	ChunkTask task;
+	task.setPayoffs(scenarios.size());
+
+	int chunksNumber = (int) chunkDone.size();
+	int chunk;
+	while ((chunk = next->fetch_add(1)) < chunksNumber) {
+		int first = chunk * chunkSimulations;
+		task.reset(chunk, first, std::min(chunkSimulations, todo_simulations - first), seed);
+		if (singlePrecision)
+			simulateLanes<float>(task);
+		else
+			simulateLanes<double>(task);
+
+		for (size_t s = 0; s < scenarios.size(); s++)
+			chunkSums[s][chunk] = task.payoffSums[s].get();
+		chunkDone[chunk] = task.done;
+	}
+}
+
+/**
+ * Method used to simulate a chunk of paths under all the scenarios. The normals of a path are drawn once, in
+ * the layout of the Euler simulation of the workers, and they stay in the L1 cache while the scenarios are
+ * simulated on them LANES at a time. The parameters and the state of a tile are stored by lane, so every
+ * update runs over the LANES scenarios of the tile with the same two normals. The lanes carry the logarithm
+ * of the spot, so a step has no exponential and the loop over the lanes has only multiplications and square
+ * roots (vectorized, since the file is compiled without errno for the math functions)
+ * @param task		The chunk to simulate, with one payoff sum for every scenario
+ */
+template <typename Real>
+void ScenarioEngine::simulateLanes(ChunkTask & task) {
+
+	const int scenariosNumber = (int) scenarios.size();
+	const int tiles = (scenariosNumber + LANES - 1) / LANES;
+	const int lanesNumber = tiles * LANES;
+
+	// The lanes after the last scenario repeat it, and their payoffs are not added
+	std::vector<Real> deltaT(lanesNumber);
+	std::vector<Real> drift(lanesNumber);
+	std::vector<Real> reversion(lanesNumber);
+	std::vector<Real> theta(lanesNumber);
+	std::vector<Real> xi(lanesNumber);
+	std::vector<Real> rho(lanesNumber);
+	std::vector<Real> rhoComplement(lanesNumber);
+	for (int l = 0; l < lanesNumber; l++) {
+		Scenario const & scenario = scenarios[std::min(l, scenariosNumber - 1)];
+		double step = scenario.T / discretization;
+		deltaT[l] = (Real) step;
+		drift[l] = (Real) (scenario.r * step);
+		reversion[l] = (Real) (scenario.kappa * step);
+		theta[l] = (Real) scenario.theta;
+		xi[l] = (Real) scenario.xi;
+		rho[l] = (Real) scenario.rho;
+		rhoComplement[l] = (Real) sqrt(1.0 - scenario.rho * scenario.rho);
+	}
+
+	std::vector<Real> normals(2 * discretization);
+	Real spot[LANES];		/**< The logarithm of the spot */
+	Real volatility[LANES];
+	Real antithetic_spot[LANES];
+	Real antithetic_volatility[LANES];
+
+	for (int i = 0; i < task.todo; i++) {
+
+		HestonWorker::drawNormals<Real>(task.generator, &normals[0], 2 * discretization);
+
+		for (int t = 0; t < tiles; t++) {
+			const int base = t * LANES;
+			const Real* dT = &deltaT[base];
+			const Real* mu = &drift[base];
+			const Real* k = &reversion[base];
+			const Real* th = &theta[base];
+			const Real* x = &xi[base];
+			const Real* r = &rho[base];
+			const Real* rc = &rhoComplement[base];
+
+			for (int p = 0; p < LANES; p++) {
+				Scenario const & scenario = scenarios[std::min(base + p, scenariosNumber - 1)];
+				spot[p] = (Real) log(scenario.S0);
+				volatility[p] = (Real) scenario.V0;
+				antithetic_spot[p] = spot[p];
+				antithetic_volatility[p] = volatility[p];
+			}
+
+			for (int j = 0; j < discretization; j++) {
+				const Real random_spot = normals[2 * j];
+				const Real random_volatility = normals[2 * j + 1];
+
+				for (int p = 0; p < LANES; p++) {
+					Real correlated = r[p] * random_volatility + rc[p] * random_spot;
+
+					Real correct_volatility = std::max(volatility[p], (Real) 0);
+					Real diffusion = std::sqrt(correct_volatility * dT[p]);
+					volatility[p] += k[p] * (th[p] - correct_volatility) + x[p] * diffusion * random_volatility;
+					spot[p] += mu[p] - (Real) 0.5 * correct_volatility * dT[p] + diffusion * correlated;
+
+					correct_volatility = std::max(antithetic_volatility[p], (Real) 0);
+					diffusion = std::sqrt(correct_volatility * dT[p]);
+					antithetic_volatility[p] += k[p] * (th[p] - correct_volatility) - x[p] * diffusion * random_volatility;
+					antithetic_spot[p] += mu[p] - (Real) 0.5 * correct_volatility * dT[p] - diffusion * correlated;
+				}
+			}
+
+			int active = std::min(LANES, scenariosNumber - base);
+			for (int p = 0; p < active; p++) {
+				double strike = scenarios[base + p].K;
+				task.payoffSums[base + p].add(std::max(exp((double) spot[p]) - strike, 0.0) +
+					std::max(exp((double) antithetic_spot[p]) - strike, 0.0));
+			}
+		}
+		task.done++;
+	}
+}
+
+/**
+ * Method used to write the results, in CSV if the file name ends with ".csv", otherwise in the columnar
+ * binary format
+ * @param path		The result file
+ */
+bool ScenarioEngine::write(std::string const & path) {
+
+	static const char* columns[] = { "S0", "K", "r", "T", "V0", "rho", "kappa", "theta", "xi", "price", "pnl" };
+	const uint32_t columnsNumber = sizeof(columns) / sizeof(columns[0]);
+	const uint32_t scenariosNumber = (uint32_t) scenarios.size();
+
+	std::vector<std::vector<double> > values(columnsNumber, std::vector<double>(scenariosNumber));
+	for (uint32_t s = 0; s < scenariosNumber; s++) {
+		Scenario const & scenario = scenarios[s];
+		double row[] = { scenario.S0, scenario.K, scenario.r, scenario.T, scenario.V0, scenario.rho,
+			scenario.kappa, scenario.theta, scenario.xi, scenario.price,
+			scenario.price - scenarios.front().price };
+		for (uint32_t c = 0; c < columnsNumber; c++)
+			values[c][s] = row[c];
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file) {
+		std::cout << "Unable to write the scenario results in " << path << std::endl;
+		return false;
+	}
+
+	bool csv = path.size() > 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+	if (csv) {
+		fprintf(file, "scenario");
+		for (uint32_t c = 0; c < columnsNumber; c++)
+			fprintf(file, ",%s", columns[c]);
+		fprintf(file, "\n");
+		for (uint32_t s = 0; s < scenariosNumber; s++) {
+			fprintf(file, "%s", scenarios[s].name.c_str());
+			for (uint32_t c = 0; c < columnsNumber; c++)
+				fprintf(file, ",%.10g", values[c][s]);
+			fprintf(file, "\n");
+		}
+	} else {
+		fwrite("HFSC", 1, 4, file);
+		fwrite(&scenariosNumber, sizeof(scenariosNumber), 1, file);
+		fwrite(&columnsNumber, sizeof(columnsNumber), 1, file);
+		for (uint32_t c = 0; c < columnsNumber; c++)
+			fwrite(columns[c], 1, strlen(columns[c]) + 1, file);
+		for (uint32_t c = 0; c < columnsNumber; c++)
+			fwrite(&values[c][0], sizeof(double), scenariosNumber, file);
+		for (uint32_t s = 0; s < scenariosNumber; s++)
+			fwrite(scenarios[s].name.c_str(), 1, scenarios[s].name.size() + 1, file);
+	}
+
+	return fclose(file) == 0;
+}
+
+/**
+ * Method used to get the priced scenarios
+ */
+std::vector<Scenario> const & ScenarioEngine::getScenarios() {
+	return scenarios;
+}
@@ -0,0 +1,59 @@
+/**
+ *       @file  StartupTimeline.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The timeline of the start of the application: the time of every phase from the initialization of
+ *		the program (logger, command line, RTLib, registration of the EXC, setup, first configuration, first
+ *		chunk and first price), so the fixed costs of a short run can be told apart from the simulation
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "StartupTimeline.h"
+
+#include <cstring>
+
+std::chrono::steady_clock::time_point StartupTimeline::origin = std::chrono::steady_clock::now();
+std::mutex StartupTimeline::lock;
+StartupPhase StartupTimeline::phases[StartupTimeline::MAX_PHASES];
+int StartupTimeline::phasesNumber = 0;
+
+/**
+ * Method used to record the end of a phase. Only the first mark of a phase is kept
+ * @param phase		The name of the phase, a string literal
+ */
+void StartupTimeline::mark(const char* phase) {
+	double seconds = elapsed();
+
+	std::lock_guard<std::mutex> guard(lock);
+	for (int i = 0; i < phasesNumber; i++)
+		if (strcmp(phases[i].name, phase) == 0)
+			return;
+	if (phasesNumber == MAX_PHASES)
+		return;
+	phases[phasesNumber].name = phase;
+	phases[phasesNumber].seconds = seconds;
+	phasesNumber++;
+}
+
+/**
+ * Method used to get the seconds from the initialization of the program
+ */
+double StartupTimeline::elapsed() {
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - origin;
+	return seconds.count();
+}
+
+/**
+ * Method used to get the recorded phases, in the order of their marks
+ */
+std::vector<StartupPhase> StartupTimeline::getPhases() {
+	std::lock_guard<std::mutex> guard(lock);
+	return std::vector<StartupPhase>(phases, phases + phasesNumber);
+}
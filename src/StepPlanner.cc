@@ -0,0 +1,235 @@
+/**
+ *       @file  StepPlanner.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The choice of the number of steps of a contract from a target on the discretization bias. A short
+ *		pilot simulates every path on a coarse grid and on its refinement with the same Brownian increments:
+ *		the difference of the two payoffs has a small variance, so a short run of paths measures the bias
+ *		constant of the contract, and the steps are the fewest that bring the bias under the target
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "StepPlanner.h"
+#include "HestonWorker.h"
+#include "ChunkTask.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+const double StepPlanner::SIGMAS = 1.0;
+
+/**
+ * The constructor of the StepPlanner class
+ *
+ * @param S0		The spot price of the option
+ * @param K		The strike price of the option
+ * @param r		The risk-free rate of the option
+ * @param T		The maturity time of the option (in years)
+ * @param V0		The initial volatility of the option
+ * @param rho		The Correlation Coefficient parameter of Heston model for the specified option
+ * @param kappa		The mean reversion rate of the Heston Model for the considered option
+ * @param theta		The long-term volatility value
+ * @param xi		The volatility of volatility (V0)
+ */
+StepPlanner::StepPlanner(double S0, double K, double r, double T, double V0, double rho, double kappa, double theta,
+		double xi) {
+	this->S0 = S0;
+	this->K = K;
+	this->r = r;
+	this->T = T;
+	this->V0 = V0;
+	this->rho = rho;
+	this->kappa = kappa;
+	this->theta = theta;
+	this->xi = xi;
+
+	this->terms.rate = TermStructure(r);
+	this->terms.kappa = TermStructure(kappa);
+	this->terms.theta = TermStructure(theta);
+	this->terms.xi = TermStructure(xi);
+
+	this->mixing = false;
+	this->richardson = false;
+	this->payoffs = NULL;
+	this->seed = 1;
+	this->constant = 0.0;
+}
+
+/**
+ * Method used to select the model of the contract (Heston by default)
+ * @param model		The model and its parameters
+ */
+void StepPlanner::setModel(ModelParameters const & model) {
+	this->model = model;
+}
+
+/**
+ * Method used to set the time-dependent inputs of the model
+ * @param terms		The curves of the model
+ */
+void StepPlanner::setTerms(HestonTerms const & terms) {
+	this->terms = terms;
+}
+
+/**
+ * Method used to set the time grid of the discretization (uniform by default)
+ * @param grid		The time grid
+ */
+void StepPlanner::setTimeGrid(TimeGrid const & grid) {
+	this->timeGrid = grid;
+}
+
+/**
+ * Method used to plan for the conditional Monte Carlo (mixing formula) simulation
+ * @param mixing	True to simulate only the volatility path
+ */
+void StepPlanner::setMixingMode(bool mixing) {
+	this->mixing = mixing;
+}
+
+/**
+ * Method used to plan for the Richardson extrapolation
+ * @param richardson	True if the run is extrapolated
+ */
+void StepPlanner::setRichardson(bool richardson) {
+	this->richardson = richardson;
+}
+
+/**
+ * Method used to plan also for other options on the same paths
+ * @param payoffs	The additional options, or NULL to plan only for the call of the constructor
+ */
+void StepPlanner::setPayoffs(std::vector<Option*> const* payoffs) {
+	this->payoffs = payoffs;
+}
+
+/**
+ * Method used to set the seed of the pilot
+ * @param seed		The seed of the pilot
+ */
+void StepPlanner::setSeed(uint64_t seed) {
+	this->seed = seed;
+}
+
+/**
+ * Method used to get the fewest steps that bring the discretization bias of the price under a target
+ * @param bias		The target on the bias of the price
+ */
+int StepPlanner::plan(double bias) {
+
+	measureConstant();
+
+	double steps = richardson ? sqrt(constant / (2.0 * bias)) : constant / bias;
+	if (!(steps < MAX_STEPS))
+		return MAX_STEPS;
+	return std::max((int) ceil(steps), MIN_STEPS);
+}
+
+/**
+ * Method used to get a bound on the discretization bias of the price with a number of steps
+ * @param steps		The steps of the grid
+ */
+double StepPlanner::bound(int steps) {
+
+	measureConstant();
+
+	double N = std::max(steps, 1);
+	return richardson ? constant / (2.0 * N * N) : constant / N;
+}
+
+/**
+ * Method used to measure the bias constant with the pilot (the largest over the options).
+ * With P(N) = P + c1 / N + c2 / N^2 the difference of a grid and of its refinement is
+ *	D(N) = P(2N) - P(N) = -c1 / (2N) - 3 * c2 / (4N^2)
+ * so the Euler scheme has the bias c1 / N, with c1 = -2N * D(N). The Richardson extrapolation 2 * P(2N) - P(N)
+ * has the bias -c2 / (2N^2), and c2 = -8N^2 * (D(N) - 2 * D(2N)) / 3 comes from the pilot on two grids
+ */
+void StepPlanner::measureConstant() {
+
+	std::vector<double> mean;
+	std::vector<double> error;
+	measure(PILOT_STEPS, mean, error);
+
+	std::vector<double> refinedMean;
+	std::vector<double> refinedError;
+	if (richardson)
+		measure(2 * PILOT_STEPS, refinedMean, refinedError);
+
+	const double N = PILOT_STEPS;
+	constant = 0.0;
+	for (size_t k = 0; k < mean.size(); k++) {
+		double c;
+		if (richardson) {
+			double difference = mean[k] - 2.0 * refinedMean[k];
+			double noise = sqrt(error[k] * error[k] + 4.0 * refinedError[k] * refinedError[k]);
+			c = 8.0 * N * N * (fabs(difference) + SIGMAS * noise) / 3.0;
+		} else {
+			c = 2.0 * N * (fabs(mean[k]) + SIGMAS * error[k]);
+		}
+		constant = std::max(constant, c);
+	}
+}
+
+/**
+ * Method used to get the bias constant measured by the last plan (the largest over the options)
+ */
+double StepPlanner::getConstant() {
+	return constant;
+}
+
+/**
+ * Method used to measure the difference of the prices on a grid and on its refinement, for every option. The
+ * chunks are independent and simulated concurrently, one per worker, and the standard error comes from the
+ * variance of the differences of the antithetic couples
+ * @param steps		The steps of the grid
+ * @param mean		The mean difference of every option (the call first)
+ * @param error		The standard error of the difference of every option
+ */
+void StepPlanner::measure(int steps, std::vector<double> & mean, std::vector<double> & error) {
+
+	size_t options = 1 + (payoffs ? payoffs->size() : 0);
+	std::vector<std::unique_ptr<HestonWorker> > workers(PILOT_CHUNKS);
+	std::vector<ChunkTask> tasks(PILOT_CHUNKS);
+	for (int c = 0; c < PILOT_CHUNKS; c++) {
+		workers[c].reset(new HestonWorker(S0, K, r, T, V0, rho, kappa, theta, xi));
+		workers[c]->setMixingMode(mixing);
+		workers[c]->setTerms(terms);
+		workers[c]->setModel(model);
+		workers[c]->setTimeGrid(timeGrid);
+		workers[c]->setRefinement(-1.0, 1.0);
+		workers[c]->setPayoffs(payoffs);
+
+		tasks[c].setPayoffs(options - 1);
+		tasks[c].reset(c, c * PILOT_SIMULATIONS, PILOT_SIMULATIONS, seed);
+		workers[c]->start(&tasks[c], steps);
+	}
+
+	// The antithetic couples are the independent samples: the standard error comes from the variance of
+	// their differences over all the chunks
+	double discount = exp(-terms.rate.integral(0.0, T));
+	std::vector<double> sums(options, 0.0);
+	std::vector<double> squares(options, 0.0);
+	for (int c = 0; c < PILOT_CHUNKS; c++) {
+		workers[c]->join();
+		for (size_t k = 0; k < options; k++) {
+			sums[k] += (k == 0) ? tasks[c].sum.get() : tasks[c].payoffSums[k - 1].get();
+			squares[k] += (k == 0) ? tasks[c].squares.get() : tasks[c].payoffSquares[k - 1].get();
+		}
+	}
+
+	const double couples = (double) PILOT_CHUNKS * PILOT_SIMULATIONS;
+	mean.assign(options, 0.0);
+	error.assign(options, 0.0);
+	for (size_t k = 0; k < options; k++) {
+		mean[k] = sums[k] / (2.0 * couples) * discount;
+		error[k] = standardError(sums[k], squares[k], couples) / 2.0 * discount;
+	}
+}
@@ -0,0 +1,120 @@
+/**
+ *       @file  TermStructure.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The time-dependent inputs of the model: piecewise-constant curves of the risk-free rate, of the
+ *		dividend yield and of the Heston parameters. The curves are never evaluated in the simulation: they
+ *		are integrated once over the steps of the discretization grid into lookup tables, so a time-dependent
+ *		model costs the same indexed loads of a constant one
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "TermStructure.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+/**
+ * The constructor of a constant curve
+ * @param value		The value of the curve at every time
+ */
+TermStructure::TermStructure(double value) {
+	values.push_back(value);
+}
+
+/**
+ * Method used to read a curve, a single value or a list of pieces "time:value"
+ * @param text		The curve to read
+ */
+bool TermStructure::parse(std::string const & text) {
+
+	std::vector<double> parsedTimes;
+	std::vector<double> parsedValues;
+
+	std::stringstream pieces(text);
+	std::string piece;
+	while (std::getline(pieces, piece, ',')) {
+		char* last;
+		size_t colon = piece.find(':');
+		if (colon == std::string::npos) {
+			// A piece without time is the value after the last time
+			double value = strtod(piece.c_str(), &last);
+			if (piece.empty() || *last != '\0')
+				return false;
+			parsedValues.push_back(value);
+			break;
+		}
+
+		double time = strtod(piece.c_str(), &last);
+		if (last != piece.c_str() + colon || (!parsedTimes.empty() && time <= parsedTimes.back()) || time <= 0.0)
+			return false;
+		double value = strtod(piece.c_str() + colon + 1, &last);
+		if (colon + 1 == piece.size() || *last != '\0')
+			return false;
+
+		parsedTimes.push_back(time);
+		parsedValues.push_back(value);
+	}
+
+	if (parsedValues.empty() || pieces.rdbuf()->in_avail() > 0)
+		return false;
+
+	// The last value holds after the last time
+	if (parsedValues.size() == parsedTimes.size())
+		parsedTimes.pop_back();
+
+	times = parsedTimes;
+	values = parsedValues;
+	return true;
+}
+
+/**
+ * Method used to write the curve in the form read by parse(), with all the digits of the doubles
+ */
+std::string TermStructure::format() const {
+	std::string text;
+	char piece[64];
+	for (size_t i = 0; i < values.size(); i++) {
+		if (i < times.size())
+			snprintf(piece, sizeof(piece), "%.17g:%.17g,", times[i], values[i]);
+		else
+			snprintf(piece, sizeof(piece), "%.17g", values[i]);
+		text += piece;
+	}
+	return text;
+}
+
+/**
+ * Method used to integrate the curve over an interval
+ * @param from		The start of the interval (in years)
+ * @param to		The end of the interval (in years)
+ */
+double TermStructure::integral(double from, double to) const {
+
+	double total = 0.0;
+	double start = 0.0;
+	for (size_t i = 0; i < values.size() && start < to; i++) {
+		double end = (i < times.size()) ? times[i] : to;
+		double overlap = std::min(end, to) - std::max(start, from);
+		if (overlap > 0.0)
+			total += values[i] * overlap;
+		start = end;
+	}
+	return total;
+}
+
+/**
+ * Method used to know if the curve has a single value
+ */
+bool TermStructure::isConstant() const {
+	return values.size() == 1;
+}
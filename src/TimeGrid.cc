@@ -0,0 +1,169 @@
+/**
+ *       @file  TimeGrid.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The time grid of the discretization. A uniform grid has steps of the same length, a concentrated
+ *		grid has geometric steps that shrink towards the expiry and towards the observation dates, where the
+ *		Euler scheme loses most of its accuracy on the payoff. The grid gives the times of its nodes and the
+ *		lengths of its steps, from which the lookup tables of the model are integrated
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "TimeGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+const double TimeGrid::MAX_CONCENTRATION = 1000.0;
+
+/**
+ * The constructor of the TimeGrid class
+ * @param concentration	The ratio between the first and the last step of every segment (1 for a uniform grid)
+ */
+TimeGrid::TimeGrid(double concentration) {
+	this->concentration = concentration;
+}
+
+/**
+ * Method used to read a grid, the concentration optionally followed by the observation dates
+ * @param text		The grid to read
+ */
+bool TimeGrid::parse(std::string const & text) {
+
+	char* last;
+	size_t colon = text.find(':');
+	std::string head = text.substr(0, colon);
+	double parsedConcentration = strtod(head.c_str(), &last);
+	if (head.empty() || *last != '\0' || !(parsedConcentration >= 1.0) || parsedConcentration > MAX_CONCENTRATION)
+		return false;
+
+	std::vector<double> parsedDates;
+	if (colon != std::string::npos) {
+		std::stringstream pieces(text.substr(colon + 1));
+		std::string piece;
+		while (std::getline(pieces, piece, ',')) {
+			double date = strtod(piece.c_str(), &last);
+			if (piece.empty() || *last != '\0' || date <= 0.0 ||
+					(!parsedDates.empty() && date <= parsedDates.back()))
+				return false;
+			parsedDates.push_back(date);
+		}
+		if (parsedDates.empty())
+			return false;
+	}
+
+	concentration = parsedConcentration;
+	dates = parsedDates;
+	return true;
+}
+
+/**
+ * Method used to write the grid in the form read by parse(), with all the digits of the doubles
+ */
+std::string TimeGrid::format() const {
+	char piece[64];
+	snprintf(piece, sizeof(piece), "%.17g", concentration);
+	std::string text = piece;
+	for (size_t i = 0; i < dates.size(); i++) {
+		snprintf(piece, sizeof(piece), "%c%.17g", i == 0 ? ':' : ',', dates[i]);
+		text += piece;
+	}
+	return text;
+}
+
+/**
+ * Method used to know if the grid has steps of the same length
+ */
+bool TimeGrid::isUniform() const {
+	return concentration == 1.0 && dates.empty();
+}
+
+/**
+ * Method used to compute the nodes of the grid over a maturity. Every segment between two dates has a number of
+ * steps proportional to its length (at least one); inside a segment the steps are geometric, with the ratio
+ * between the first and the last one equal to the concentration
+ * @param T		The maturity (in years)
+ * @param steps		The number of steps
+ * @param times		The steps + 1 nodes of the grid
+ * @param lengths	The lengths of the steps
+ */
+void TimeGrid::build(double T, int steps, std::vector<double> & times, std::vector<double> & lengths) const {
+
+	times.resize(steps + 1);
+	lengths.resize(steps);
+
+	if (isUniform()) {
+		double deltaT = T / steps;
+		for (int j = 0; j <= steps; j++)
+			times[j] = j * deltaT;
+		std::fill(lengths.begin(), lengths.end(), deltaT);
+		return;
+	}
+
+	// The ends of the segments: the dates before the maturity and the maturity itself
+	std::vector<double> ends;
+	for (size_t i = 0; i < dates.size(); i++)
+		if (dates[i] < T)
+			ends.push_back(dates[i]);
+	ends.push_back(T);
+	if ((int) ends.size() > steps)
+		ends.assign(1, T);
+
+	int segments = (int) ends.size();
+	int node = 0;
+	double start = 0.0;
+	times[0] = 0.0;
+	for (int s = 0; s < segments; s++) {
+		// The last node of the segment, rounded from its share of the steps
+		int end = (int) floor(steps * ends[s] / T + 0.5);
+		end = std::max(end, node + 1);
+		end = std::min(end, steps - (segments - 1 - s));
+
+		int n = end - node;
+		double width = ends[s] - start;
+		double ratio = (n > 1) ? pow(concentration, -1.0 / (n - 1)) : 1.0;
+		double total = (ratio == 1.0) ? n : (1.0 - pow(ratio, n)) / (1.0 - ratio);
+		double length = width / total;
+		for (int i = 1; i < n; i++) {
+			times[node + i] = times[node + i - 1] + length;
+			length *= ratio;
+		}
+		times[end] = ends[s];
+
+		node = end;
+		start = ends[s];
+	}
+
+	for (int j = 0; j < steps; j++)
+		lengths[j] = times[j + 1] - times[j];
+}
+
+/**
+ * Method used to compute the grid made of every other node of a grid with an even number of steps
+ * @param times		The nodes of the fine grid
+ * @param lengths	The lengths of the steps of the fine grid
+ * @param coarseTimes	The nodes of the coarse grid
+ * @param coarseLengths	The lengths of the steps of the coarse grid
+ */
+void TimeGrid::coarsen(std::vector<double> const & times, std::vector<double> const & lengths,
+		std::vector<double> & coarseTimes, std::vector<double> & coarseLengths) {
+
+	int steps = (int) lengths.size() / 2;
+	coarseTimes.resize(steps + 1);
+	coarseLengths.resize(steps);
+	for (int j = 0; j < steps; j++) {
+		coarseTimes[j] = times[2 * j];
+		coarseLengths[j] = lengths[2 * j] + lengths[2 * j + 1];
+	}
+	coarseTimes[steps] = times[2 * steps];
+}
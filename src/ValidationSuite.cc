@@ -0,0 +1,311 @@
+/**
+ *       @file  ValidationSuite.cc
+ *      @brief  The HestonFive BarbequeRTRM application
+ *
+ * Description: The validation of the Monte Carlo engine on a grid of contracts and models. Every case is simulated
+ *		in chunks by a worker, as in the application, and its call and put prices must be within a number of
+ *		standard errors of the semi-analytic prices, plus the discretization bias of the Euler grid measured
+ *		by a pilot, so a bias introduced by an optimization is caught. The
+ *		throughput of every case is compared with the baseline of the machine, so a slowdown is caught too
+ *
+ *     @author  Luca Napoletano luca.napoletano@mail.polimi.it, Claudio Montanari claudio1.montanari@mail.polimi.it
+ *
+ *     Company  Politecnico di Milano
+ *   Copyright  Copyright (c) 2017, Luca Napoletano, Claudio Montanari
+ *
+ * This source code is released for free distribution under the terms of the
+ * GNU General Public License as published by the Free Software Foundation.
+ * =====================================================================================
+ */
+#include "ValidationSuite.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "ChunkTask.h"
+#include "EuropeanPut.h"
+#include "HestonAnalytic.h"
+#include "HestonWorker.h"
+#include "StepPlanner.h"
+
+const double ValidationSuite::SIGMAS = 4.0;
+const double ValidationSuite::THROUGHPUT_TOLERANCE = 0.8;
+
+/**
+ * The constructor of the ValidationSuite class
+ *
+ * @param chunks		The chunks simulated for every case
+ * @param chunkSimulations	The simulations (antithetic couples) of every chunk
+ * @param seed			The seed of the chunks (0 for a fixed seed)
+ */
+ValidationSuite::ValidationSuite(int chunks, int chunkSimulations, uint64_t seed) {
+	this->chunks = std::max(chunks, 2);
+	this->chunkSimulations = std::max(chunkSimulations, 1);
+	this->seed = seed ? seed : 1;
+
+	char name[256];
+	if (gethostname(name, sizeof(name)) == 0) {
+		name[sizeof(name) - 1] = '\0';
+		host = name;
+	} else {
+		host = "localhost";
+	}
+}
+
+/**
+ * Method used to add a case
+ * @param validationCase	The case to add
+ */
+void ValidationSuite::add(ValidationCase const & validationCase) {
+	cases.push_back(validationCase);
+}
+
+/**
+ * Method used to add the grid of the cases around a base case: the base contract with the Euler, the
+ * conditional and the single precision engines, in and out of the money contracts of one year with a
+ * steeper skew and their Richardson extrapolation on a coarser grid, a short contract with a low volatility,
+ * and the Bates and double Heston models
+ * @param base		The base case (the parameters of the command line)
+ * @param model		The parameters of the jumps and of the second variance factor of the grid
+ */
+void ValidationSuite::addGrid(ValidationCase const & base, ModelParameters const & model) {
+	ValidationCase c = base;
+	c.model = ModelParameters();
+	c.mixing = false;
+	c.singlePrecision = false;
+	c.richardson = false;
+	c.name = "base";
+	add(c);
+
+	c.name = "base-mixing";
+	c.mixing = true;
+	add(c);
+
+	c.name = "base-single";
+	c.mixing = false;
+	c.singlePrecision = true;
+	add(c);
+
+	// The contracts of one year, with the steps of the base case: a coarser grid has an Euler bias larger
+	// than the tolerance on the steep skew of these cases
+	ValidationCase year = base;
+	year.model = ModelParameters();
+	year.mixing = false;
+	year.singlePrecision = false;
+	year.richardson = false;
+	year.T = 1.0;
+	year.V0 = 0.04;
+	year.theta = 0.04;
+	year.kappa = 2.0;
+	year.rho = -0.7;
+	year.xi = 0.5;
+
+	c = year;
+	c.name = "itm-1y";
+	c.K = 0.9 * base.S0;
+	add(c);
+
+	c.name = "otm-1y";
+	c.K = 1.1 * base.S0;
+	add(c);
+
+	// The extrapolation of a grid four times coarser, it must have no visible bias on the steep skew
+	c = year;
+	c.name = "richardson-1y";
+	c.discretization = std::max(base.discretization / 4, 1);
+	c.richardson = true;
+	add(c);
+
+	c = year;
+	c.name = "low-vol-6m";
+	c.T = 0.5;
+	c.V0 = 0.01;
+	c.theta = 0.015;
+	c.kappa = 1.5;
+	c.rho = -0.5;
+	c.xi = 0.2;
+	c.discretization = std::max(base.discretization / 2, 1);
+	add(c);
+
+	c = year;
+	c.name = "bates-1y";
+	c.model = model;
+	c.model.type = MODEL_BATES;
+	add(c);
+
+	c = year;
+	c.name = "double-heston-1y";
+	c.V0 = 0.02;
+	c.theta = 0.02;
+	c.model = model;
+	c.model.type = MODEL_DOUBLE_HESTON;
+	add(c);
+}
+
+/**
+ * Method used to read the baseline throughputs, one "host case paths-per-second" line for every case
+ * of every machine. A missing file is an empty baseline
+ * @param path		The baseline file
+ */
+bool ValidationSuite::loadBaseline(std::string const & path) {
+	baseline.clear();
+	std::ifstream file(path.c_str());
+	if (!file)
+		return true;
+
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream fields(line);
+		std::string machine, name;
+		double throughput;
+		if (!(fields >> machine >> name >> throughput) || throughput <= 0.0) {
+			fprintf(stderr, "Invalid baseline line: %s\n", line.c_str());
+			return false;
+		}
+		baseline[machine][name] = throughput;
+	}
+	return true;
+}
+
+/**
+ * Method used to write the baseline with the throughputs measured by the last run for this machine, the
+ * lines of the other machines are kept
+ * @param path		The baseline file
+ */
+bool ValidationSuite::saveBaseline(std::string const & path) {
+	for (size_t i = 0; i < results.size(); i++)
+		baseline[host][cases[i].name] = results[i].pathsPerSecond;
+
+	FILE* file = fopen(path.c_str(), "w");
+	if (file == NULL)
+		return false;
+
+	fprintf(file, "# host case paths-per-second\n");
+	std::map<std::string, std::map<std::string, double> >::const_iterator machine;
+	for (machine = baseline.begin(); machine != baseline.end(); ++machine) {
+		std::map<std::string, double>::const_iterator entry;
+		for (entry = machine->second.begin(); entry != machine->second.end(); ++entry)
+			fprintf(file, "%s %s %.0f\n", machine->first.c_str(), entry->first.c_str(), entry->second);
+	}
+	return fclose(file) == 0;
+}
+
+/**
+ * Method used to run all the cases and to print their report. It returns the number of failed cases
+ */
+int ValidationSuite::run() {
+	results.clear();
+	int failures = 0;
+
+	printf("%-18s %12s %12s %8s %8s %12s %12s %8s %8s %8s %12s %8s\n", "case", "call", "analytic", "error", "z",
+		"put", "analytic", "error", "z", "bias", "paths/s", "speed");
+
+	for (size_t i = 0; i < cases.size(); i++) {
+		ValidationResult result = simulate(cases[i]);
+
+		std::map<std::string, double> const & machine = baseline[host];
+		std::map<std::string, double>::const_iterator entry = machine.find(cases[i].name);
+		result.baseline = entry != machine.end() ? entry->second : 0.0;
+		result.fast = result.baseline == 0.0 || result.pathsPerSecond >= THROUGHPUT_TOLERANCE * result.baseline;
+		results.push_back(result);
+
+		double callScore = (result.call - result.analyticCall) / result.callError;
+		double putScore = (result.put - result.analyticPut) / result.putError;
+		char speed[16];
+		if (result.baseline > 0.0)
+			snprintf(speed, sizeof(speed), "%.2fx", result.pathsPerSecond / result.baseline);
+		else
+			snprintf(speed, sizeof(speed), "-");
+
+		printf("%-18s %12.6f %12.6f %8.5f %8.2f %12.6f %12.6f %8.5f %8.2f %8.5f %12.0f %8s  %s\n",
+			cases[i].name.c_str(), result.call, result.analyticCall, result.callError, callScore, result.put,
+			result.analyticPut, result.putError, putScore, result.bias, result.pathsPerSecond, speed,
+			!result.converged ? "BIASED" : (!result.fast ? "SLOW" : "OK"));
+
+		if (!result.converged || !result.fast)
+			failures++;
+	}
+
+	printf("%d cases, %d failed (prices within %.1f standard errors plus the bias, throughput at least %.0f%% of the "
+		"baseline of %s)\n", (int) cases.size(), failures, SIGMAS, 100.0 * THROUGHPUT_TOLERANCE, host.c_str());
+	return failures;
+}
+
+/**
+ * Method used to get the result of a case, after the run
+ * @param index		The index of the case
+ */
+ValidationResult const & ValidationSuite::getResult(int index) {
+	return results[index];
+}
+
+/**
+ * Method used to simulate a case. The call is the option of the worker and the put is priced on the same
+ * paths; the standard errors come from the variance of the payoffs of all the antithetic couples, which are
+ * independent. The allowance for the discretization bias is the bound measured by the pilot of the StepPlanner
+ * on the grid of the case and on its refinement
+ * @param validationCase	The case to simulate
+ */
+ValidationResult ValidationSuite::simulate(ValidationCase const & validationCase) {
+	ValidationCase const & c = validationCase;
+
+	HestonWorker worker(c.S0, c.K, c.r, c.T, c.V0, c.rho, c.kappa, c.theta, c.xi);
+	worker.setMixingMode(c.mixing);
+	worker.setSinglePrecision(c.singlePrecision);
+	worker.setRefinement(c.richardson ? -1.0 : 0.0, c.richardson ? 2.0 : 0.0);
+	worker.setModel(c.model);
+
+	EuropeanPut put(c.S0, c.K, c.r, c.T);
+	std::vector<Option*> payoffs(1, &put);
+	worker.setPayoffs(&payoffs);
+
+	double discount = exp(-c.r * c.T);
+	double callSum = 0.0, callSquares = 0.0;
+	double putSum = 0.0, putSquares = 0.0;
+
+	ChunkTask task;
+	task.setPayoffs(1);
+	for (int k = 0; k < chunks; k++) {
+		task.reset(k, k * chunkSimulations, chunkSimulations, seed);
+		worker.start(&task, c.discretization);
+		worker.join();
+		callSum += task.sum.get();
+		callSquares += task.squares.get();
+		putSum += task.payoffSums[0].get();
+		putSquares += task.payoffSquares[0].get();
+	}
+
+	// Every couple adds the payoffs of a path and of its antithetic one
+	const double couples = (double) chunks * chunkSimulations;
+	ValidationResult result = ValidationResult();
+	result.call = callSum / (2.0 * couples) * discount;
+	result.put = putSum / (2.0 * couples) * discount;
+	result.callError = std::max(standardError(callSum, callSquares, couples) / 2.0 * discount, 1e-12);
+	result.putError = std::max(standardError(putSum, putSquares, couples) / 2.0 * discount, 1e-12);
+
+	StepPlanner planner(c.S0, c.K, c.r, c.T, c.V0, c.rho, c.kappa, c.theta, c.xi);
+	planner.setModel(c.model);
+	planner.setMixingMode(c.mixing);
+	planner.setRichardson(c.richardson);
+	planner.setPayoffs(&payoffs);
+	planner.setSeed(seed);
+	result.bias = planner.bound(c.discretization);
+
+	HestonAnalytic analytic(c.S0, c.r, c.T, c.V0, c.rho, c.kappa, c.theta, c.xi);
+	analytic.setModel(c.model);
+	result.analyticCall = analytic.price(c.K, true);
+	result.analyticPut = analytic.price(c.K, false);
+
+	result.converged = fabs(result.call - result.analyticCall) <= SIGMAS * result.callError + result.bias &&
+		fabs(result.put - result.analyticPut) <= SIGMAS * result.putError + result.bias;
+
+	WorkerMetrics metrics = worker.getMetrics();
+	result.pathsPerSecond = metrics.busySeconds > 0.0 ? metrics.paths / metrics.busySeconds : 0.0;
+	return result;
+}